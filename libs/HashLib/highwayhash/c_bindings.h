@@ -40,15 +40,16 @@ uint64_t SipHash13C(const uint64_t* key, const char* bytes,
 // calculates 64-bit hash of given data.
 uint64_t HighwayHash64(const HHKey key, const char* bytes, const uint64_t size);
 
-// Defined by highwayhash_target.cc, which requires a _Target* suffix.
-uint64_t HighwayHash64_TargetPortable(const HHKey key, const char* bytes,
-                                      const uint64_t size);
-uint64_t HighwayHash64_TargetSSE41(const HHKey key, const char* bytes,
-                                   const uint64_t size);
-uint64_t HighwayHash64_TargetAVX2(const HHKey key, const char* bytes,
-                                  const uint64_t size);
-uint64_t HighwayHash64_TargetVSX(const HHKey key, const char* bytes,
-                                 const uint64_t size);
+// Defined by highwayhash_target.cc, which is compiled once per target and
+// appends the target name (HH_ADD_TARGET_SUFFIX) to the function name.
+uint64_t HighwayHash64_Portable(const HHKey key, const char* bytes,
+                                const uint64_t size);
+uint64_t HighwayHash64_SSE41(const HHKey key, const char* bytes,
+                             const uint64_t size);
+uint64_t HighwayHash64_AVX2(const HHKey key, const char* bytes,
+                            const uint64_t size);
+uint64_t HighwayHash64_VSX(const HHKey key, const char* bytes,
+                           const uint64_t size);
 
 #ifdef __cplusplus
 }
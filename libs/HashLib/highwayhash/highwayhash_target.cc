@@ -17,6 +17,8 @@
 
 #include "highwayhash/highwayhash_target.h"
 
+#include <new>
+
 #include "highwayhash/highwayhash.h"
 
 #ifndef HH_DISABLE_TARGET_SPECIFIC
@@ -97,8 +99,36 @@ void HighwayHashCat<Target>::operator()(const HHKey& key,
 }
 
 // Instantiate for the current target.
+template <TargetBits Target>
+HighwayHashKeyed<Target>::HighwayHashKeyed(const HHKey& key) {
+  static_assert(sizeof(HHStateT<Target>) <= kStateBytes,
+                "HHStateT does not fit into HighwayHashKeyed");
+  static_assert(alignof(HHStateT<Target>) <= 32,
+                "HHStateT is aligned more strictly than HighwayHashKeyed");
+  new (state_) HHStateT<Target>(key);
+}
+
+template <TargetBits Target>
+void HighwayHashKeyed<Target>::operator()(const char* HH_RESTRICT bytes,
+                                          const size_t size,
+                                          HHResult64* HH_RESTRICT hash) const {
+  HHStateT<Target> state =
+      *std::launder(reinterpret_cast<const HHStateT<Target>*>(state_));
+  HighwayHashT(&state, bytes, size, hash);
+}
+
+template <TargetBits Target>
+void HighwayHashKeyed<Target>::operator()(const char* HH_RESTRICT bytes,
+                                          const size_t size,
+                                          HHResult128* HH_RESTRICT hash) const {
+  HHStateT<Target> state =
+      *std::launder(reinterpret_cast<const HHStateT<Target>*>(state_));
+  HighwayHashT(&state, bytes, size, hash);
+}
+
 template struct HighwayHash<HH_TARGET>;
 template struct HighwayHashCat<HH_TARGET>;
+template class HighwayHashKeyed<HH_TARGET>;
 
 }  // namespace highwayhash
 #endif  // HH_DISABLE_TARGET_SPECIFIC
@@ -59,6 +59,27 @@ struct HighwayHash {
 // Replacement for C++17 std::string_view that avoids dependencies.
 // A struct requires fewer allocations when calling HighwayHashCat with
 // non-const "num_fragments".
+// Hashes inputs with one "key" on the "Target" CPU. The state is initialized
+// from the key once, in the constructor, and every call hashes a copy of it
+// instead of rebuilding the state. HHStateT<Target> is only defined in the
+// translation unit compiled for "Target" (hh_<target>.cc), so the state is
+// stored here as bytes.
+template <TargetBits Target>
+class HighwayHashKeyed {
+ public:
+  explicit HighwayHashKeyed(const HHKey& key);
+
+  void operator()(const char* HH_RESTRICT bytes, const size_t size,
+                  HHResult64* HH_RESTRICT hash) const;
+  void operator()(const char* HH_RESTRICT bytes, const size_t size,
+                  HHResult128* HH_RESTRICT hash) const;
+
+ private:
+  // sizeof(HHStateT<Target>) of all targets (four 256-bit lanes)
+  static constexpr size_t kStateBytes = 128;
+  alignas(32) char state_[kStateBytes];
+};
+
 struct StringView {
   const char* data;  // not necessarily aligned/padded
   size_t num_bytes;  // possibly zero
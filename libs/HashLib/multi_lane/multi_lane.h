@@ -0,0 +1,57 @@
+#ifndef MULTI_LANE_H
+#define MULTI_LANE_H
+
+/*
+ * Multi-lane (multi-buffer) kernels for serial 32-bit hash functions.
+ * One call hashes num_keys independent keys: every key is hashed in its own 32-bit lane
+ * of a vector of sse41::lanes (4) or avx2::lanes (8) lanes. Two vectors are processed
+ * together to hide the latency of the multiplications, so a group holds 8 or 16 keys.
+ * Keys of a group may have different lengths: lanes of shorter keys are masked out once
+ * their key ends. To keep the lengths of a group close, keys of different lengths are
+ * grouped in the order of their lengths; the hashes are stored in the order of the keys.
+ * hashes[i] is bit-identical to the scalar hash function of keys[i]:
+ *   DJB2Hash32         - DJB2Hash<uint32_t> (hash_functions.h)
+ *   SDBMHash32         - SDBMHash<uint32_t> (hash_functions.h)
+ *   OneAtATimeHash32   - one_at_a_time_hash<uint32_t> (hash_functions.h)
+ *   FNV1aHash32        - FNV32a(key, len, seed) (hash_functions.h)
+ *   MurmurHash3_x86_32 - MurmurHash3_x86_32(key, len, seed, &hash) (murmur_hash/MurmurHash3.h)
+ *   XXHash32           - XXH32(key, len, seed) (xx_hash/xxhash.h)
+ * Key lengths must be less than 2^31 bytes (the scalar FNV-1a and MurmurHash3 take int lengths).
+ * Each namespace is compiled in its own translation unit with the flags of its
+ * instruction set (-msse4.1, -mavx2); the caller checks CPU support at runtime.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace multi_lane {
+    // Number of bytes of every key loaded into the lanes at once
+    inline constexpr size_t window_bytes = 64;
+
+    namespace sse41 {
+        // 32-bit lanes of __m128i
+        inline constexpr size_t lanes = 4;
+
+        void DJB2Hash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void SDBMHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void OneAtATimeHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void FNV1aHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+        void MurmurHash3_x86_32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+        void XXHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+    }
+
+    namespace avx2 {
+        // 32-bit lanes of __m256i
+        inline constexpr size_t lanes = 8;
+
+        void DJB2Hash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void SDBMHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void OneAtATimeHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+        void FNV1aHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+        void MurmurHash3_x86_32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+        void XXHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes);
+    }
+}
+
+#endif /* MULTI_LANE_H */
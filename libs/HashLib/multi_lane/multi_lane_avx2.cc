@@ -0,0 +1,57 @@
+// Multi-lane kernels for AVX2 (8 lanes of __m256i), built with -mavx2, see multi_lane.h
+
+#include <immintrin.h>
+
+#include "multi_lane_impl.h"
+
+namespace {
+    struct Avx2Vec {
+        using Vec = __m256i;
+        static constexpr size_t lanes = multi_lane::avx2::lanes;
+
+        static Vec Set1(uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+        static Vec Load(const uint32_t* data) { return _mm256_load_si256(reinterpret_cast<const Vec*>(data)); }
+        static void Store(uint32_t* data, Vec v) { _mm256_storeu_si256(reinterpret_cast<Vec*>(data), v); }
+        static Vec Add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+        static Vec Sub(Vec a, Vec b) { return _mm256_sub_epi32(a, b); }
+        static Vec Mul(Vec a, Vec b) { return _mm256_mullo_epi32(a, b); }
+        static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+        static Vec Or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+        static Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+        static Vec AndNot(Vec a, Vec b) { return _mm256_andnot_si256(b, a); }
+        static Vec Shl(Vec v, int count) { return _mm256_slli_epi32(v, count); }
+        static Vec Shr(Vec v, int count) { return _mm256_srli_epi32(v, count); }
+        static Vec Sar(Vec v, int count) { return _mm256_srai_epi32(v, count); }
+        static Vec Greater(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+        static Vec Equal(Vec a, Vec b) { return _mm256_cmpeq_epi32(a, b); }
+        static Vec Select(Vec mask, Vec a, Vec b) { return _mm256_blendv_epi8(b, a, mask); }
+    };
+
+    using Avx2Kernels = multi_lane::Kernels<multi_lane::VectorPair<Avx2Vec>>;
+}
+
+namespace multi_lane::avx2 {
+    void DJB2Hash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Avx2Kernels::DJB2Hash32(keys, num_keys, hashes);
+    }
+
+    void SDBMHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Avx2Kernels::SDBMHash32(keys, num_keys, hashes);
+    }
+
+    void OneAtATimeHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Avx2Kernels::OneAtATimeHash32(keys, num_keys, hashes);
+    }
+
+    void FNV1aHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Avx2Kernels::FNV1aHash32(keys, num_keys, seed, hashes);
+    }
+
+    void MurmurHash3_x86_32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Avx2Kernels::MurmurHash3_x86_32(keys, num_keys, seed, hashes);
+    }
+
+    void XXHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Avx2Kernels::XXHash32(keys, num_keys, seed, hashes);
+    }
+}
@@ -0,0 +1,437 @@
+#ifndef MULTI_LANE_IMPL_H
+#define MULTI_LANE_IMPL_H
+
+/*
+ * Implementation of the multi-lane kernels (see multi_lane.h), generic over the vector type.
+ * Included by multi_lane_<target>.cc, which defines a struct V with the 32-bit lane operations:
+ *   Vec, lanes, Set1, Load (aligned), Store (unaligned), Add, Sub, Mul, Xor, Or, And,
+ *   AndNot(a, b) = a & ~b, Shl, Shr, Sar, Greater (signed), Equal, Select(mask, a, b) = mask ? a : b.
+ * Everything is in an anonymous namespace: every target translation unit gets its own copy
+ * compiled with its own instruction set flags.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "multi_lane.h"
+
+namespace multi_lane {
+namespace {
+    constexpr size_t window_words = window_bytes / 4;
+
+    // Keys ordered by length at once, the length from which keys are not ordered and
+    // the spread of lengths for which a block is hashed in its original order
+    constexpr size_t sort_block_keys = 256;
+    constexpr size_t max_sort_length = window_bytes;
+    constexpr size_t max_unsorted_spread = 3;
+
+    constexpr uint32_t fnv32_offset_basis = 2166136261u;
+    constexpr uint32_t fnv32_prime = 16777619u;
+
+    constexpr uint32_t murmur3_c1 = 0xcc9e2d51u;
+    constexpr uint32_t murmur3_c2 = 0x1b873593u;
+
+    constexpr uint32_t xxh32_prime1 = 0x9E3779B1u;
+    constexpr uint32_t xxh32_prime2 = 0x85EBCA77u;
+    constexpr uint32_t xxh32_prime3 = 0xC2B2AE3Du;
+    constexpr uint32_t xxh32_prime4 = 0x27D4EB2Fu;
+    constexpr uint32_t xxh32_prime5 = 0x165667B1u;
+
+    template<typename V>
+    typename V::Vec Rotl(typename V::Vec v, int count) {
+        return V::Or(V::Shl(v, count), V::Shr(v, 32 - count));
+    }
+
+    /*
+     * Two vectors of V as one vector of 2 * V::lanes lanes. The dependency chains of the halves are
+     * independent, so the latency of one half (the 32-bit multiplication takes about 10 cycles)
+     * is hidden by the other
+     */
+    template<typename V>
+    struct VectorPair {
+        struct Vec {
+            typename V::Vec low;
+            typename V::Vec high;
+        };
+        static constexpr size_t lanes = 2 * V::lanes;
+
+        static Vec Set1(uint32_t value) { return {V::Set1(value), V::Set1(value)}; }
+        static Vec Load(const uint32_t* data) { return {V::Load(data), V::Load(data + V::lanes)}; }
+        static void Store(uint32_t* data, Vec v) { V::Store(data, v.low); V::Store(data + V::lanes, v.high); }
+        static Vec Add(Vec a, Vec b) { return {V::Add(a.low, b.low), V::Add(a.high, b.high)}; }
+        static Vec Sub(Vec a, Vec b) { return {V::Sub(a.low, b.low), V::Sub(a.high, b.high)}; }
+        static Vec Mul(Vec a, Vec b) { return {V::Mul(a.low, b.low), V::Mul(a.high, b.high)}; }
+        static Vec Xor(Vec a, Vec b) { return {V::Xor(a.low, b.low), V::Xor(a.high, b.high)}; }
+        static Vec Or(Vec a, Vec b) { return {V::Or(a.low, b.low), V::Or(a.high, b.high)}; }
+        static Vec And(Vec a, Vec b) { return {V::And(a.low, b.low), V::And(a.high, b.high)}; }
+        static Vec AndNot(Vec a, Vec b) { return {V::AndNot(a.low, b.low), V::AndNot(a.high, b.high)}; }
+        static Vec Shl(Vec v, int count) { return {V::Shl(v.low, count), V::Shl(v.high, count)}; }
+        static Vec Shr(Vec v, int count) { return {V::Shr(v.low, count), V::Shr(v.high, count)}; }
+        static Vec Sar(Vec v, int count) { return {V::Sar(v.low, count), V::Sar(v.high, count)}; }
+        static Vec Greater(Vec a, Vec b) { return {V::Greater(a.low, b.low), V::Greater(a.high, b.high)}; }
+        static Vec Equal(Vec a, Vec b) { return {V::Equal(a.low, b.low), V::Equal(a.high, b.high)}; }
+        static Vec Select(Vec mask, Vec a, Vec b) {
+            return {V::Select(mask.low, a.low, b.low), V::Select(mask.high, a.high, b.high)};
+        }
+    };
+
+    // One group of V::lanes keys: the lengths of the keys and a window of their 32-bit words
+    template<typename V>
+    class LaneGroup {
+    public:
+        using Vec = typename V::Vec;
+        static constexpr size_t lanes = V::lanes;
+
+        // Missing keys of an incomplete group (num_keys < lanes) are empty
+        LaneGroup(const std::string_view* keys, size_t num_keys) {
+            std::copy(keys, keys + num_keys, keys_);
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                lengths_[lane] = static_cast<uint32_t>(keys_[lane].size());
+            }
+            min_length_ = *std::min_element(lengths_, lengths_ + lanes);
+            max_length_ = *std::max_element(lengths_, lengths_ + lanes);
+        }
+
+        [[nodiscard]] size_t MinLength() const {
+            return min_length_;
+        }
+
+        [[nodiscard]] size_t MaxLength() const {
+            return max_length_;
+        }
+
+        [[nodiscard]] Vec Lengths() const {
+            return V::Load(lengths_);
+        }
+
+        // Loads num_words words of every key starting from first_byte, zero-padded past the end of the key
+        void LoadWindow(size_t first_byte, size_t num_words) {
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                const std::string_view key = keys_[lane];
+                const size_t available = key.size() > first_byte ? key.size() - first_byte : 0;
+                const size_t whole_words = std::min(available / 4, num_words);
+                for (size_t word = 0; word < whole_words; ++word) {
+                    std::memcpy(&words_[word][lane], key.data() + first_byte + word * 4, 4);
+                }
+                for (size_t word = whole_words; word < num_words; ++word) {
+                    words_[word][lane] = 0;
+                }
+                if (whole_words < num_words && available % 4 != 0) {
+                    std::memcpy(&words_[whole_words][lane], key.data() + first_byte + whole_words * 4, available % 4);
+                }
+            }
+        }
+
+        // Word of the loaded window (little-endian, as in the scalar hash functions on x86)
+        [[nodiscard]] Vec Word(size_t word) const {
+            return V::Load(words_[word]);
+        }
+
+    private:
+        std::string_view keys_[lanes] = {};
+        alignas(32) uint32_t lengths_[lanes] = {};
+        alignas(32) uint32_t words_[window_words][lanes];
+        size_t min_length_ = 0;
+        size_t max_length_ = 0;
+    };
+
+    /*
+     * Hashes a group byte by byte: h = step(h, byte) for every byte of the key of a lane.
+     * SignExtend - bytes are signed char (DJB2, SDBM) rather than unsigned
+     * Lanes take part in the step while the byte position is below their key length;
+     * below the shortest length of the group no masking is needed
+     */
+    template<typename V, bool SignExtend, typename Step>
+    typename V::Vec HashBytes(LaneGroup<V>& group, typename V::Vec h, Step step) {
+        using Vec = typename V::Vec;
+        const Vec lengths = group.Lengths();
+        const Vec byte_mask = V::Set1(0xFF);
+        for (size_t first_byte = 0; first_byte < group.MaxLength(); first_byte += window_bytes) {
+            const size_t window_end = std::min(window_bytes, group.MaxLength() - first_byte);
+            group.LoadWindow(first_byte, (window_end + 3) / 4);
+            for (size_t word_index = 0; word_index * 4 < window_end; ++word_index) {
+                const Vec word = group.Word(word_index);
+                for (int byte_index = 0; byte_index < 4; ++byte_index) {
+                    const size_t position = first_byte + word_index * 4 + byte_index;
+                    if (position >= group.MaxLength()) {
+                        break;
+                    }
+                    const Vec byte = SignExtend ? V::Sar(V::Shl(word, 24 - 8 * byte_index), 24)
+                                                : V::And(V::Shr(word, 8 * byte_index), byte_mask);
+                    const Vec next = step(h, byte);
+                    h = position < group.MinLength()
+                        ? next
+                        : V::Select(V::Greater(lengths, V::Set1(static_cast<uint32_t>(position))), next, h);
+                }
+            }
+        }
+        return h;
+    }
+
+    // DJB2Hash<uint32_t>: hash = hash * 33 + (signed char)byte
+    template<typename V>
+    typename V::Vec DJB2Group(LaneGroup<V>& group) {
+        return HashBytes<V, true>(group, V::Set1(5381), [](auto h, auto byte) {
+            return V::Add(V::Add(V::Shl(h, 5), h), byte);
+        });
+    }
+
+    // SDBMHash<uint32_t>: hash = (signed char)byte + (hash << 6) + (hash << 16) - hash
+    template<typename V>
+    typename V::Vec SDBMGroup(LaneGroup<V>& group) {
+        return HashBytes<V, true>(group, V::Set1(0), [](auto h, auto byte) {
+            return V::Sub(V::Add(V::Add(byte, V::Shl(h, 6)), V::Shl(h, 16)), h);
+        });
+    }
+
+    // one_at_a_time_hash<uint32_t>
+    template<typename V>
+    typename V::Vec OneAtATimeGroup(LaneGroup<V>& group) {
+        auto h = HashBytes<V, false>(group, V::Set1(0), [](auto h, auto byte) {
+            h = V::Add(h, byte);
+            h = V::Add(h, V::Shl(h, 10));
+            return V::Xor(h, V::Shr(h, 6));
+        });
+        h = V::Add(h, V::Shl(h, 3));
+        h = V::Xor(h, V::Shr(h, 11));
+        return V::Add(h, V::Shl(h, 15));
+    }
+
+    // FNV32a: hash = (hash ^ byte) * prime, starting from seed ^ offset basis
+    template<typename V>
+    typename V::Vec FNV1aGroup(LaneGroup<V>& group, uint32_t seed) {
+        const auto prime = V::Set1(fnv32_prime);
+        return HashBytes<V, false>(group, V::Set1(seed ^ fnv32_offset_basis), [prime](auto h, auto byte) {
+            return V::Mul(V::Xor(h, byte), prime);
+        });
+    }
+
+    /*
+     * MurmurHash3_x86_32. Word i of a lane is a block if i < length / 4 and the tail if i == length / 4.
+     * The tail word is zero-padded, so for lengths divisible by 4 the tail step does not change the hash
+     */
+    template<typename V>
+    typename V::Vec MurmurHash3Group(LaneGroup<V>& group, uint32_t seed) {
+        using Vec = typename V::Vec;
+        const Vec lengths = group.Lengths();
+        const Vec num_blocks = V::Shr(lengths, 2);
+        const Vec c1 = V::Set1(murmur3_c1);
+        const Vec c2 = V::Set1(murmur3_c2);
+        const Vec n = V::Set1(0xe6546b64);
+        const size_t min_blocks = group.MinLength() / 4;
+        const size_t num_words = group.MaxLength() / 4 + 1;
+
+        Vec h = V::Set1(seed);
+        for (size_t first_word = 0; first_word < num_words; first_word += window_words) {
+            const size_t window_end = std::min(window_words, num_words - first_word);
+            group.LoadWindow(first_word * 4, window_end);
+            for (size_t word_index = 0; word_index < window_end; ++word_index) {
+                const size_t index = first_word + word_index;
+                Vec k = V::Mul(group.Word(word_index), c1);
+                k = V::Mul(Rotl<V>(k, 15), c2);
+                const Vec tail = V::Xor(h, k);
+                const Vec rotated = Rotl<V>(tail, 13);
+                const Vec block = V::Add(V::Add(V::Shl(rotated, 2), rotated), n);
+                if (index < min_blocks) {
+                    h = block;
+                } else {
+                    const Vec current = V::Set1(static_cast<uint32_t>(index));
+                    h = V::Select(V::Greater(num_blocks, current), block,
+                                  V::Select(V::Equal(num_blocks, current), tail, h));
+                }
+            }
+        }
+
+        h = V::Xor(h, lengths);
+        h = V::Xor(h, V::Shr(h, 16));
+        h = V::Mul(h, V::Set1(0x85ebca6b));
+        h = V::Xor(h, V::Shr(h, 13));
+        h = V::Mul(h, V::Set1(0xc2b2ae35));
+        return V::Xor(h, V::Shr(h, 16));
+    }
+
+    /*
+     * XXH32. Words [0, 4 * (length / 16)) of a lane are stripes of the four accumulators,
+     * the rest of the whole words and the last length % 4 bytes go to the finalization.
+     * The accumulators of a lane are merged into the hash at the word where its stripes end
+     */
+    template<typename V>
+    typename V::Vec XXH32Group(LaneGroup<V>& group, uint32_t seed) {
+        using Vec = typename V::Vec;
+        const Vec lengths = group.Lengths();
+        const Vec stripe_words = V::Shl(V::Shr(lengths, 4), 2);
+        const Vec whole_words = V::Shr(lengths, 2);
+        const Vec remainder = V::And(lengths, V::Set1(3));
+        const Vec prime1 = V::Set1(xxh32_prime1);
+        const Vec prime2 = V::Set1(xxh32_prime2);
+        const Vec prime3 = V::Set1(xxh32_prime3);
+        const Vec prime4 = V::Set1(xxh32_prime4);
+        const Vec prime5 = V::Set1(xxh32_prime5);
+        const Vec byte_mask = V::Set1(0xFF);
+        const size_t min_stripe_words = group.MinLength() / 16 * 4;
+        const size_t max_stripe_words = group.MaxLength() / 16 * 4;
+        const size_t min_whole_words = group.MinLength() / 4;
+        const size_t max_whole_words = group.MaxLength() / 4;
+        const size_t num_words = max_whole_words + 1;
+
+        Vec accumulators[4] = {V::Set1(seed + xxh32_prime1 + xxh32_prime2), V::Set1(seed + xxh32_prime2),
+                               V::Set1(seed), V::Set1(seed - xxh32_prime1)};
+        Vec h = V::Add(V::Set1(seed + xxh32_prime5), lengths);
+        for (size_t first_word = 0; first_word < num_words; first_word += window_words) {
+            const size_t window_end = std::min(window_words, num_words - first_word);
+            group.LoadWindow(first_word * 4, window_end);
+            for (size_t word_index = 0; word_index < window_end; ++word_index) {
+                const size_t index = first_word + word_index;
+                const Vec word = group.Word(word_index);
+                const Vec current = V::Set1(static_cast<uint32_t>(index));
+
+                if (index % 4 == 0 && index > 0 && index <= max_stripe_words) {
+                    Vec merged = V::Add(Rotl<V>(accumulators[0], 1), Rotl<V>(accumulators[1], 7));
+                    merged = V::Add(merged, V::Add(Rotl<V>(accumulators[2], 12), Rotl<V>(accumulators[3], 18)));
+                    h = V::Select(V::Equal(stripe_words, current), V::Add(merged, lengths), h);
+                }
+
+                if (index < max_stripe_words) {
+                    Vec& accumulator = accumulators[index % 4];
+                    const Vec next = V::Mul(Rotl<V>(V::Add(accumulator, V::Mul(word, prime2)), 13), prime1);
+                    accumulator = index < min_stripe_words
+                                  ? next
+                                  : V::Select(V::Greater(stripe_words, current), next, accumulator);
+                }
+
+                if (index >= min_stripe_words && index < max_whole_words) {
+                    const Vec next = V::Mul(Rotl<V>(V::Add(h, V::Mul(word, prime3)), 17), prime4);
+                    const Vec is_tail_word = V::AndNot(V::Greater(whole_words, current),
+                                                       V::Greater(stripe_words, current));
+                    h = V::Select(is_tail_word, next, h);
+                }
+
+                if (index >= min_whole_words) {
+                    const Vec is_last_word = V::Equal(whole_words, current);
+                    for (int byte_index = 0; byte_index < 3; ++byte_index) {
+                        const Vec byte = V::And(V::Shr(word, 8 * byte_index), byte_mask);
+                        const Vec next = V::Mul(Rotl<V>(V::Add(h, V::Mul(byte, prime5)), 11), prime1);
+                        const Vec is_tail_byte = V::And(is_last_word,
+                                                        V::Greater(remainder, V::Set1(byte_index)));
+                        h = V::Select(is_tail_byte, next, h);
+                    }
+                }
+            }
+        }
+
+        h = V::Xor(h, V::Shr(h, 15));
+        h = V::Mul(h, prime2);
+        h = V::Xor(h, V::Shr(h, 13));
+        h = V::Mul(h, prime3);
+        return V::Xor(h, V::Shr(h, 16));
+    }
+
+    // Hashes a group of group_size keys (the rest of the lanes get empty keys)
+    template<typename V, typename GroupHash>
+    void HashGroup(const std::string_view* group_keys, size_t group_size, uint32_t* group_hashes,
+                   GroupHash group_hash) {
+        LaneGroup<V> group(group_keys, group_size);
+        if (group_size == V::lanes) {
+            V::Store(group_hashes, group_hash(group));
+        } else {
+            uint32_t partial[V::lanes];
+            V::Store(partial, group_hash(group));
+            std::copy(partial, partial + group_size, group_hashes);
+        }
+    }
+
+    /*
+     * Splits the keys into groups of V::lanes keys and stores the hashes computed by group_hash(group).
+     * The keys are taken in blocks of sort_block_keys keys. If the lengths of a block differ by more than
+     * max_unsorted_spread, the block is ordered by length (counting sort), so the keys of a group
+     * have close lengths: fewer lane steps are masked out and fewer bytes are padded
+     */
+    template<typename V, typename GroupHash>
+    void HashGroups(const std::string_view* keys, size_t num_keys, uint32_t* hashes, GroupHash group_hash) {
+        for (size_t block = 0; block < num_keys; block += sort_block_keys) {
+            const size_t block_size = std::min(sort_block_keys, num_keys - block);
+            const std::string_view* block_keys = keys + block;
+            uint32_t* block_hashes = hashes + block;
+
+            const auto [min_key, max_key] = std::minmax_element(
+                    block_keys, block_keys + block_size,
+                    [](std::string_view lhs, std::string_view rhs) { return lhs.size() < rhs.size(); });
+            if (max_key->size() - min_key->size() <= max_unsorted_spread) {
+                for (size_t first = 0; first < block_size; first += V::lanes) {
+                    HashGroup<V>(block_keys + first, std::min(V::lanes, block_size - first), block_hashes + first,
+                                 group_hash);
+                }
+                continue;
+            }
+
+            uint16_t bucket_starts[max_sort_length + 2] = {};
+            for (size_t i = 0; i < block_size; ++i) {
+                ++bucket_starts[std::min(block_keys[i].size(), max_sort_length) + 1];
+            }
+            for (size_t bucket = 1; bucket <= max_sort_length + 1; ++bucket) {
+                bucket_starts[bucket] += bucket_starts[bucket - 1];
+            }
+            uint16_t order[sort_block_keys];
+            for (size_t i = 0; i < block_size; ++i) {
+                order[bucket_starts[std::min(block_keys[i].size(), max_sort_length)]++] = static_cast<uint16_t>(i);
+            }
+
+            for (size_t first = 0; first < block_size; first += V::lanes) {
+                const size_t group_size = std::min(V::lanes, block_size - first);
+                std::string_view group_keys[V::lanes];
+                for (size_t lane = 0; lane < group_size; ++lane) {
+                    group_keys[lane] = block_keys[order[first + lane]];
+                }
+                uint32_t group_hashes[V::lanes];
+                HashGroup<V>(group_keys, group_size, group_hashes, group_hash);
+                for (size_t lane = 0; lane < group_size; ++lane) {
+                    block_hashes[order[first + lane]] = group_hashes[lane];
+                }
+            }
+        }
+    }
+
+    // Kernels of multi_lane.h for the vector type V
+    template<typename V>
+    struct Kernels {
+        static void DJB2Hash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [](LaneGroup<V>& group) {
+                return DJB2Group(group);
+            });
+        }
+
+        static void SDBMHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [](LaneGroup<V>& group) {
+                return SDBMGroup(group);
+            });
+        }
+
+        static void OneAtATimeHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [](LaneGroup<V>& group) {
+                return OneAtATimeGroup(group);
+            });
+        }
+
+        static void FNV1aHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [seed](LaneGroup<V>& group) {
+                return FNV1aGroup(group, seed);
+            });
+        }
+
+        static void MurmurHash3_x86_32(const std::string_view* keys, size_t num_keys, uint32_t seed,
+                                       uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [seed](LaneGroup<V>& group) {
+                return MurmurHash3Group(group, seed);
+            });
+        }
+
+        static void XXHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+            HashGroups<V>(keys, num_keys, hashes, [seed](LaneGroup<V>& group) {
+                return XXH32Group(group, seed);
+            });
+        }
+    };
+}
+}
+
+#endif /* MULTI_LANE_IMPL_H */
@@ -0,0 +1,57 @@
+// Multi-lane kernels for SSE4.1 (4 lanes of __m128i), built with -msse4.1, see multi_lane.h
+
+#include <immintrin.h>
+
+#include "multi_lane_impl.h"
+
+namespace {
+    struct Sse41Vec {
+        using Vec = __m128i;
+        static constexpr size_t lanes = multi_lane::sse41::lanes;
+
+        static Vec Set1(uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+        static Vec Load(const uint32_t* data) { return _mm_load_si128(reinterpret_cast<const Vec*>(data)); }
+        static void Store(uint32_t* data, Vec v) { _mm_storeu_si128(reinterpret_cast<Vec*>(data), v); }
+        static Vec Add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+        static Vec Sub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+        static Vec Mul(Vec a, Vec b) { return _mm_mullo_epi32(a, b); }
+        static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+        static Vec Or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+        static Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+        static Vec AndNot(Vec a, Vec b) { return _mm_andnot_si128(b, a); }
+        static Vec Shl(Vec v, int count) { return _mm_slli_epi32(v, count); }
+        static Vec Shr(Vec v, int count) { return _mm_srli_epi32(v, count); }
+        static Vec Sar(Vec v, int count) { return _mm_srai_epi32(v, count); }
+        static Vec Greater(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+        static Vec Equal(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+        static Vec Select(Vec mask, Vec a, Vec b) { return _mm_blendv_epi8(b, a, mask); }
+    };
+
+    using Sse41Kernels = multi_lane::Kernels<multi_lane::VectorPair<Sse41Vec>>;
+}
+
+namespace multi_lane::sse41 {
+    void DJB2Hash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Sse41Kernels::DJB2Hash32(keys, num_keys, hashes);
+    }
+
+    void SDBMHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Sse41Kernels::SDBMHash32(keys, num_keys, hashes);
+    }
+
+    void OneAtATimeHash32(const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+        Sse41Kernels::OneAtATimeHash32(keys, num_keys, hashes);
+    }
+
+    void FNV1aHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Sse41Kernels::FNV1aHash32(keys, num_keys, seed, hashes);
+    }
+
+    void MurmurHash3_x86_32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Sse41Kernels::MurmurHash3_x86_32(keys, num_keys, seed, hashes);
+    }
+
+    void XXHash32(const std::string_view* keys, size_t num_keys, uint32_t seed, uint32_t* hashes) {
+        Sse41Kernels::XXHash32(keys, num_keys, seed, hashes);
+    }
+}
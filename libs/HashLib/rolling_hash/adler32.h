@@ -1,15 +1,21 @@
+#ifndef ADLER32
+#define ADLER32
+
 #include <stdint.h>
 
 // contributed by Dmitry Artamonov
 // this is *deterministic*
 class Adler32 {
-    uint32 sum1, sum2;
+    uint32_t sum1, sum2;
 public:
     static const uint32_t Base = 65521;
     uint32_t hashvalue;
     int len;
 
-    Adler32(int window) : sum1(1), sum2(0), hashvalue(0), len (window) {}
+    Adler32(int window) : sum1(1), sum2(0), hashvalue(0), len (window) {
+        for (uint32_t c = 0; c < 256; ++c)
+            outterms[c] = static_cast<uint32_t>((static_cast<uint64_t>(len) * c) % Base);
+    }
 
     void eat(uint8_t inchar) {
         sum1 = (sum1 + inchar) % Base;
@@ -38,11 +44,21 @@ public:
             sum1 += Base;
         }
 
-        sum2 = ((int)(sum2 - len * outchar + sum1 - 1) % (int)Base);
+        // len * outchar mod Base is precomputed, so sum2 is reduced without a division
+        sum2 = sum2 - (int)outterms[outchar] + sum1 - 1;
         if (sum2 < 0)
         {
             sum2 += Base;
         }
+        else if (sum2 >= (int)Base)
+        {
+            sum2 -= Base;
+        }
         hashvalue = (sum2 << 16) | sum1;
     }
+
+private:
+    uint32_t outterms[256]; // len * outchar mod Base for every outchar
 };
+
+#endif
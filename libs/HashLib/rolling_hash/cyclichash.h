@@ -1,6 +1,8 @@
 #ifndef CYCLICHASH
 #define CYCLICHASH
 
+#include <climits>
+
 #include "characterhash.h"
 
 /**
@@ -152,6 +154,75 @@ public:
 
 };
 
+template <typename hashvaluetype = uint32, typename chartype =  unsigned char, unsigned wordsize=CHAR_BIT * sizeof(hashvaluetype)>
+class CyclicHashBits {
+    // The key difference between CyclicHashBits and CyclicHash is that wordsize is now templated,
+    // so the hash value is rotated by a constant (a single instruction for full words),
+    // and the values of the characters leaving the window are rotated once, in the constructor
+public:
+    // myn is the length of the sequences, e.g., 3 means that you want to hash sequences of 3 characters
+    CyclicHashBits(int myn) : hashvalue(0), n(myn),
+        hasher(maskfnc<hashvaluetype>(wordsize)) {
+        precomputeoutvalues();
+    }
+
+    CyclicHashBits(int myn, uint32 seed1, uint32 seed2) : hashvalue(0), n(myn),
+        hasher(maskfnc<hashvaluetype>(wordsize), seed1, seed2) {
+        precomputeoutvalues();
+    }
+
+    static constexpr bool is_full_word() {
+        return wordsize == (CHAR_BIT * sizeof(hashvaluetype));
+    }
+
+    // rotates the wordsize-bit value x to the left by r bits (r < wordsize)
+    static hashvaluetype rotateleft(hashvaluetype x, unsigned r) {
+        if (r == 0) return x;
+        hashvaluetype answer = (x << r) | (x >> (wordsize - r));
+        if constexpr (!is_full_word()) answer &= maskfnc<hashvaluetype>(wordsize);
+        return answer;
+    }
+
+    // prepare to process a new string, you will need to call "eat" again
+    void reset() {
+      hashvalue = 0;
+    }
+
+    // this is a convenience function, use eat,update and .hashvalue to use as a rolling hash function
+    template<class container>
+    hashvaluetype hash(container & c) const {
+        hashvaluetype answer(0);
+        for(size_t k = 0; k<c.size(); ++k) {
+            answer = rotateleft(answer, 1) ^ hasher.hashvalues[static_cast<chartype>(c[k])];
+        }
+        return answer;
+    }
+
+    // add inchar as an input, this is used typically only at the start
+    // the hash value is updated to that of a longer string (one where inchar was appended)
+    void eat(chartype inchar) {
+        hashvalue = rotateleft(hashvalue, 1) ^ hasher.hashvalues[inchar];
+    }
+
+    // add inchar as an input and remove outchar, the hashvalue is updated
+    // this function can be used to update the hash value from the hash value of [outchar]ABC to the hash value of ABC[inchar]
+    void update(chartype outchar, chartype inchar) {
+        hashvalue = rotateleft(hashvalue, 1) ^ outvalues[outchar] ^ hasher.hashvalues[inchar];
+    }
+
+    hashvaluetype hashvalue;
+    int n;
+    CharacterHash<hashvaluetype,chartype> hasher;
+    // values of the characters leaving the window (rotated by n bits)
+    hashvaluetype outvalues[1 << ( sizeof(chartype)*8 )];
+
+private:
+    void precomputeoutvalues() {
+        for(size_t k = 0; k<CharacterHash<hashvaluetype,chartype>::nbrofchars; ++k)
+            outvalues[k] = rotateleft(hasher.hashvalues[k], static_cast<unsigned>(n) % wordsize);
+    }
+};
+
 
 
 #endif
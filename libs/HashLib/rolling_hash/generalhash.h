@@ -6,7 +6,8 @@
 
 #include "characterhash.h"
 
-enum {NOPRECOMP,FULLPRECOMP};
+// CHARPRECOMP precomputes the values of the characters leaving the window (any n)
+enum {NOPRECOMP,FULLPRECOMP,CHARPRECOMP};
 
 /**
 * Each instance is a rolling hash function meant to hash streams of characters.
@@ -38,24 +39,24 @@ public:
         irreduciblepoly(0),
         hasher(maskfnc<hashvaluetype>(wordsize)),
         lastbit(static_cast<hashvaluetype>(1)<<wordsize),
-        precomputedshift(precomputationtype==FULLPRECOMP ? (1<<n) : 0) {
-        if(wordsize == 19) {
-            irreduciblepoly = 1 + (1<<1) + (1<<2) + (1<<5)
-                               + (1<<19);
-        } else if (wordsize == 9) {
-            irreduciblepoly = 1+(1<<2)+(1<<3)+(1<<5)+(1<<9);
-        } else {
-            cerr << "unsupported wordsize "<<wordsize << " bits, try 19 or 9"<< endl;
-        }
-        // in case the precomp is activated at the template level
-        if(precomputationtype==FULLPRECOMP) {
-            for(hashvaluetype x = 0; x<precomputedshift.size(); ++x) {
-                hashvaluetype leftover = x << (wordsize-n);
-                fastleftshift(leftover, n);
-                precomputedshift[x]=leftover;
-            }
-        }
+        precomputedshift(precomputationtype==FULLPRECOMP ? (1<<n)
+                         : precomputationtype==CHARPRECOMP ? CharacterHash<hashvaluetype,chartype>::nbrofchars : 0) {
+        initialize();
+    }
+
+    // same as above, but the random keys are generated from seed1 and seed2 (reproducible hash values)
+    GeneralHash(int myn, uint32 seed1, uint32 seed2, int mywordsize = 19):
+        hashvalue(0),
+        wordsize(mywordsize),
+        n(myn),
+        irreduciblepoly(0),
+        hasher(maskfnc<hashvaluetype>(wordsize), seed1, seed2),
+        lastbit(static_cast<hashvaluetype>(1)<<wordsize),
+        precomputedshift(precomputationtype==FULLPRECOMP ? (1<<n)
+                         : precomputationtype==CHARPRECOMP ? CharacterHash<hashvaluetype,chartype>::nbrofchars : 0) {
+        initialize();
     }
+
     // prepare to process a new string, you will need to call "eat" again
     void reset() {
       hashvalue = 0;
@@ -81,15 +82,17 @@ public:
     // add inchar as an input and remove outchar, the hashvalue is updated
     // this function can be used to update the hash value from the hash value of [outchar]ABC to the hash value of ABC[inchar]
     void update(chartype outchar, chartype inchar) {
+        // branch-free reduction: the shifted out bit is random, a branch would be mispredicted half of the time
         hashvalue <<= 1;
-        if(( hashvalue & lastbit) == lastbit)
-            hashvalue ^= irreduciblepoly;
+        hashvalue ^= irreduciblepoly & (static_cast<hashvaluetype>(0) - ((hashvalue >> wordsize) & 1));
         //
         hashvaluetype z (hasher.hashvalues[outchar]);
         // the compiler should optimize away the next if/else
         if(precomputationtype==FULLPRECOMP) {
             fastleftshiftn(z);
             hashvalue ^= z ^ hasher.hashvalues[inchar];
+        } else if(precomputationtype==CHARPRECOMP) {
+            hashvalue ^= precomputedshift[outchar] ^ hasher.hashvalues[inchar];
         } else {
             fastleftshift(z,n);
             hashvalue ^= z ^ hasher.hashvalues[inchar];
@@ -116,13 +119,40 @@ public:
         return answer;
     }
 
+    // sets the irreducible polynomial and precomputes the shifted values (called by the constructors)
+    void initialize() {
+        if(wordsize == 19) {
+            irreduciblepoly = 1 + (1<<1) + (1<<2) + (1<<5)
+                               + (1<<19);
+        } else if (wordsize == 9) {
+            irreduciblepoly = 1+(1<<2)+(1<<3)+(1<<5)+(1<<9);
+        } else {
+            std::cerr << "unsupported wordsize "<<wordsize << " bits, try 19 or 9"<< std::endl;
+        }
+        // in case the precomp is activated at the template level
+        if(precomputationtype==FULLPRECOMP) {
+            for(hashvaluetype x = 0; x<precomputedshift.size(); ++x) {
+                hashvaluetype leftover = x << (wordsize-n);
+                fastleftshift(leftover, n);
+                precomputedshift[x]=leftover;
+            }
+        }
+        if(precomputationtype==CHARPRECOMP) {
+            for(size_t k = 0; k<precomputedshift.size(); ++k) {
+                hashvaluetype leftover = hasher.hashvalues[k];
+                fastleftshift(leftover, n);
+                precomputedshift[k]=leftover;
+            }
+        }
+    }
+
     hashvaluetype hashvalue;
     const int wordsize;
     int n;
     hashvaluetype irreduciblepoly;
     CharacterHash<hashvaluetype,chartype> hasher;
     const hashvaluetype lastbit;
-    vector<hashvaluetype> precomputedshift;
+    std::vector<hashvaluetype> precomputedshift;
 
 };
 
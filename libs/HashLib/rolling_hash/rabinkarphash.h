@@ -100,6 +100,16 @@ public:
         }
     }
 
+    // same as above, but the random keys are generated from seed1 and seed2 (reproducible hash values)
+    KarpRabinHashBits(int myn, uint32 seed1, uint32 seed2):  hashvalue(0), n(myn),
+        hasher( maskfnc<hashvaluetype>(wordsize), seed1, seed2),
+        HASHMASK(maskfnc<hashvaluetype>(wordsize)),BtoN(1) {
+        for (int i=0; i < n ; ++i) {
+            BtoN *= B;
+            if(!is_full_word()) BtoN &= HASHMASK;
+        }
+    }
+
     // prepare to process a new string, you will need to call "eat" again
     void reset() {
       hashvalue = 0;
@@ -33,7 +33,7 @@ public:
     ThreeWiseHash(int myn, int mywordsize=19) : n(myn), wordsize(mywordsize),
         hashers(),hasher(0) {
         if(static_cast<uint>(wordsize) > 8*sizeof(hashvaluetype)) {
-            cerr<<"Can't create "<<wordsize<<"-bit hash values"<<endl;
+            std::cerr<<"Can't create "<<wordsize<<"-bit hash values"<<std::endl;
             throw "abord";
         }
         for (int i=0; i < n; ++i) {
@@ -42,6 +42,20 @@ public:
         }
     }
 
+    // same as above, but the random keys are generated from seed1 and seed2 (reproducible hash values);
+    // the key of the k-th position in the window is generated from seed1 + k and seed2 + k
+    ThreeWiseHash(int myn, uint32 seed1, uint32 seed2, int mywordsize=19) : n(myn), wordsize(mywordsize),
+        hashers(),hasher(0) {
+        if(static_cast<uint>(wordsize) > 8*sizeof(hashvaluetype)) {
+            std::cerr<<"Can't create "<<wordsize<<"-bit hash values"<<std::endl;
+            throw "abord";
+        }
+        for (int i=0; i < n; ++i) {
+            CharacterHash<hashvaluetype,chartype> ch(maskfnc<hashvaluetype>(wordsize), seed1 + i, seed2 + i);
+            hashers.push_back(ch);
+        }
+    }
+
     // add inchar as an input, this is used typically only at the start
     // the hash value is updated to that of a longer string (one where inchar was appended)
     void eat(chartype inchar) {
@@ -83,8 +97,8 @@ public:
     hashvaluetype hashvalue;
     int n;
     const int wordsize;
-    deque<chartype> ngram;
-    vector<CharacterHash<hashvaluetype,chartype> > hashers;
+    std::deque<chartype> ngram;
+    std::vector<CharacterHash<hashvaluetype,chartype> > hashers;
     CharacterHash<hashvaluetype,chartype> hasher;//placeholder
 
 };
@@ -0,0 +1,8 @@
+/* XXH3_64bits with the XXH_SCALAR accumulator, see xxh3_targets.h */
+#define XXH_VECTOR 0   /* XXH_SCALAR */
+#include "xxhash.h"
+#include "xxh3_targets.h"
+
+uint64_t XXH3_64bits_scalar(const void* data, size_t len) {
+    return XXH3_64bits(data, len);
+}
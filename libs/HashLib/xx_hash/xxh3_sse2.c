@@ -0,0 +1,8 @@
+/* XXH3_64bits with the XXH_SSE2 accumulator, see xxh3_targets.h */
+#define XXH_VECTOR 1   /* XXH_SSE2 */
+#include "xxhash.h"
+#include "xxh3_targets.h"
+
+uint64_t XXH3_64bits_sse2(const void* data, size_t len) {
+    return XXH3_64bits(data, len);
+}
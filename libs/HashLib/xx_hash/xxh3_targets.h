@@ -0,0 +1,32 @@
+#ifndef XXH3_TARGETS_H
+#define XXH3_TARGETS_H
+
+/*
+ * XXH3_64bits compiled once per instruction set.
+ * Each xxh3_<target>.c includes xxhash.h with a fixed XXH_VECTOR and is built
+ * with the matching compiler flags, so one binary contains every kernel and
+ * the caller chooses the one supported by the CPU at runtime.
+ * All kernels return the same value as XXH3_64bits.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* Portable scalar kernel (XXH_VECTOR == XXH_SCALAR) */
+uint64_t XXH3_64bits_scalar(const void* data, size_t len);
+
+/* SSE2 kernel (XXH_VECTOR == XXH_SSE2) */
+uint64_t XXH3_64bits_sse2(const void* data, size_t len);
+
+/* AVX2 kernel (XXH_VECTOR == XXH_AVX2), requires -mavx2 */
+uint64_t XXH3_64bits_avx2(const void* data, size_t len);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* XXH3_TARGETS_H */
@@ -0,0 +1,62 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Число выделений динамической памяти в текущем потоке
+    thread_local uint64_t num_thread_allocations = 0;
+
+    // Выделяет память с выравниванием alignment (размер для std::aligned_alloc кратен выравниванию)
+    void* AlignedAllocate(std::size_t size, std::size_t alignment) {
+        size = (size + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, size != 0 ? size : alignment);
+    }
+}
+
+namespace tests {
+    // Запоминает число выделений на момент создания
+    AllocationCounter::AllocationCounter()
+        : start_allocations_(num_thread_allocations) {
+    }
+
+    // Возвращает число выделений в текущем потоке с момента создания
+    uint64_t AllocationCounter::NumAllocations() const {
+        return num_thread_allocations - start_allocations_;
+    }
+}
+
+// Замененные глобальные operator new и operator delete. Остальные формы (new[], nothrow, delete[])
+// в стандартной библиотеке вызывают эти функции. operator delete с размером заменяется явно,
+// чтобы не зависеть от того, куда его направляет стандартная библиотека
+void* operator new(std::size_t size) {
+    ++num_thread_allocations;
+    if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++num_thread_allocations;
+    if (void* ptr = AlignedAllocate(size, static_cast<std::size_t>(alignment))) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(ptr, alignment);
+}
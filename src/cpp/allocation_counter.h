@@ -0,0 +1,25 @@
+#ifndef THESIS_WORK_ALLOCATION_COUNTER_H
+#define THESIS_WORK_ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+namespace tests {
+    /*
+     *  Считает выделения динамической памяти в текущем потоке за время жизни объекта.
+     *  Выделения считают замененные глобальные operator new (см. allocation_counter.cpp),
+     *  поэтому учитываются все выделения через new, std::vector, std::string и т.п.
+     */
+    class AllocationCounter {
+    public:
+        // Запоминает число выделений на момент создания
+        AllocationCounter();
+
+        // Возвращает число выделений в текущем потоке с момента создания
+        [[nodiscard]] uint64_t NumAllocations() const;
+
+    private:
+        uint64_t start_allocations_;    // Число выделений на момент создания
+    };
+}
+
+#endif //THESIS_WORK_ALLOCATION_COUNTER_H
@@ -0,0 +1,47 @@
+#include "atomic_bitmap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <boost/assert.hpp>
+
+namespace tests {
+    // Создает битовую карту из num_bits нулевых битов
+    AtomicBitmap::AtomicBitmap(uint64_t num_bits)
+            : num_bits_(num_bits) {
+        const uint64_t num_words = (num_bits + bits_per_word - 1) / bits_per_word;
+        // Размер aligned_alloc должен быть кратен выравниванию
+        const size_t min_bytes = std::max<size_t>(num_words * sizeof(Word), 1);
+        const size_t num_bytes = (min_bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+        void* memory = std::aligned_alloc(huge_page_size, num_bytes);
+        BOOST_ASSERT_MSG(memory, "Failed to allocate the bitmap");
+
+#ifdef __linux__
+        // Просьба к ядру отображать карту большими страницами (меньше промахов TLB).
+        // Ошибка не критична: без нее используются обычные страницы
+        madvise(memory, num_bytes, MADV_HUGEPAGE);
+#endif
+
+        auto* words = static_cast<Word*>(memory);
+        for (uint64_t i = 0; i < num_words; ++i) {
+            new (words + i) Word{0};
+        }
+        words_.reset(words);
+    }
+
+    // Возвращает число битов
+    uint64_t AtomicBitmap::Size() const {
+        return num_bits_;
+    }
+
+    // Освобождает память, выделенную под слова
+    void AtomicBitmap::WordsDeleter::operator()(Word* words) const {
+        // std::atomic<uint64_t> тривиально разрушаем, поэтому достаточно освободить память
+        std::free(words);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef THESIS_WORK_ATOMIC_BITMAP_H
+#define THESIS_WORK_ATOMIC_BITMAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace tests {
+    /*
+     *  Битовая карта, которую могут одновременно изменять несколько потоков.
+     *  Биты упакованы в непрерывный массив 64-битных атомарных слов (один бит на значение),
+     *  выровненный по границе большой страницы памяти (2 МБ)
+     */
+    class AtomicBitmap {
+    public:
+        using Word = std::atomic<uint64_t>;
+
+        // Создает битовую карту из num_bits нулевых битов
+        explicit AtomicBitmap(uint64_t num_bits);
+
+        AtomicBitmap(const AtomicBitmap&) = delete;
+        AtomicBitmap(AtomicBitmap&&) = default;
+
+        AtomicBitmap& operator=(const AtomicBitmap&) = delete;
+        AtomicBitmap& operator=(AtomicBitmap&&) = default;
+
+        // Устанавливает бит с индексом index. Возвращает предыдущее значение бита
+        bool TestAndSet(uint64_t index);
+
+        // Возвращает число битов
+        [[nodiscard]] uint64_t Size() const;
+
+    private:
+        // Освобождает память, выделенную под слова
+        struct WordsDeleter {
+            void operator()(Word* words) const;
+        };
+
+        static constexpr uint64_t bits_per_word = 64;
+        static constexpr uint64_t word_shift = 6;
+        static constexpr size_t huge_page_size = 1ull << 21;
+
+        uint64_t num_bits_;                             // Число битов
+        std::unique_ptr<Word[], WordsDeleter> words_;   // Слова, в которых хранятся биты
+    };
+
+    // Устанавливает бит с индексом index. Возвращает предыдущее значение бита.
+    // Если бит уже установлен, слово только читается (без захвата кэш-линии на запись)
+    inline bool AtomicBitmap::TestAndSet(uint64_t index) {
+        Word& word = words_[index >> word_shift];
+        const uint64_t mask = 1ull << (index & (bits_per_word - 1));
+        if ((word.load(std::memory_order_relaxed) & mask) != 0) {
+            return true;
+        }
+        return (word.fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+    }
+}
+
+#endif //THESIS_WORK_ATOMIC_BITMAP_H
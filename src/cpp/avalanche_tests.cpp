@@ -2,6 +2,16 @@
 
 namespace tests {
     static constexpr uint8_t NUM_HASH_BITS = 64;
+
+    // Переводит хеш-значение в строку из бит. Хеш-значения до 64 бит выводятся 64 битами, 128-битные - полностью
+    static std::string HashToBitString(hfl::uint128_t hash, uint16_t hash_bits) {
+        std::string bits = std::bitset<NUM_HASH_BITS>(static_cast<uint64_t>(hash)).to_string();
+        if (hash_bits > NUM_HASH_BITS) {
+            bits.insert(0, std::bitset<NUM_HASH_BITS>(static_cast<uint64_t>(hash >> NUM_HASH_BITS)).to_string());
+        }
+        return bits;
+    }
+
     namespace out {
         // Формирует json-файл, в который будет сохранена информация с теста хеш функции на лавинный эффект
         OutputJson GetAvalancheTestJson(const AvalancheTestParameters& parameters, out::Logger& logger) {
@@ -40,6 +50,7 @@ namespace tests {
         // Сохраняет информацию с теста хеш функции на лавинный эффект в json
         boost::json::object AvalancheInfoToJson(const AvalancheInfo& avalanche_info) {
             boost::json::object avalanche_statistics;
+            const uint16_t hash_bits = avalanche_info.sac_matrix.HashBits();
 
             boost::json::object worst_case;
             worst_case["Distance"] = avalanche_info.hamming_distance.min.value;
@@ -52,18 +63,21 @@ namespace tests {
             avalanche_statistics["Best case"] = best_case;
 
             avalanche_statistics["Average case"] = static_cast<double>(avalanche_info.hamming_distance.avg);
+            avalanche_statistics["Variance"] = static_cast<double>(avalanche_info.hamming_distance.variance);
             avalanche_statistics["Median case"] = Median(avalanche_info.all_distances);
 
             boost::json::object original_pair;
             original_pair["Number"] = avalanche_info.original_pair.number;
-            original_pair["Hash"] = std::bitset<NUM_HASH_BITS>(avalanche_info.original_pair.hash).to_string();
+            original_pair["Hash"] = HashToBitString(avalanche_info.original_pair.hash, hash_bits);
             avalanche_statistics["Original pair"] = original_pair;
 
             boost::json::object modified_pair;
             modified_pair["Number"] = avalanche_info.modified_pair.number;
-            modified_pair["Hash"] = std::bitset<NUM_HASH_BITS>(avalanche_info.modified_pair.hash).to_string();
+            modified_pair["Hash"] = HashToBitString(avalanche_info.modified_pair.hash, hash_bits);
             avalanche_statistics["Modified pair"] = modified_pair;
 
+            avalanche_statistics["SAC"] = SacMatrixToJson(avalanche_info.sac_matrix);
+
             return avalanche_statistics;
         }
     }
@@ -78,13 +92,15 @@ namespace tests {
     std::ostream& operator<<(std::ostream &os, const HammingDistance& distance) {
         return os  << "\t\t\tminimum: " << distance.min
                    << "\n\t\t\tmaximum: " << distance.max
-                   << "\n\t\t\taverage: " << distance.avg;
+                   << "\n\t\t\taverage: " << distance.avg
+                   << "\n\t\t\tvariance: " << distance.variance;
     }
 
-    // Оператор вывода структуры NumberAndHash
+    // Оператор вывода структуры NumberAndHash. Старшие 64 бита хеш-значения выводятся, если они ненулевые
     std::ostream& operator<<(std::ostream &os, const NumberAndHash& number_and_hash) {
+        const uint16_t hash_bits = (number_and_hash.hash >> NUM_HASH_BITS) != 0 ? 2 * NUM_HASH_BITS : NUM_HASH_BITS;
         return os  << "number = " << number_and_hash.number << ", hash = "
-                   << std::bitset<NUM_HASH_BITS>(number_and_hash.hash);
+                   << HashToBitString(number_and_hash.hash, hash_bits);
     }
 
     // Оператор вывода структуры AvalancheInfo
@@ -94,41 +110,73 @@ namespace tests {
                    << "\n\t\tmodified: " << avalanche_info.modified_pair;
     }
 
-    // Сравнивает минимальное расстояние Хемминга с текущим.
-    void CompareAndChangeMinHammingDistance(AvalancheInfo& avalanche_info, const DistanceAndFrequency& dist_and_freq,
-                                            const NumberAndHash& original, const NumberAndHash& modified) {
-        if (avalanche_info.hamming_distance.min == dist_and_freq) {
-            // Если текущее значение равно минимальному, то увеличивает частоту минимального расстояния
-            avalanche_info.hamming_distance.min.frequency += dist_and_freq.frequency;
-        } else if (avalanche_info.hamming_distance.min > dist_and_freq) {
-            // Если текущее значение меньше минимального, то:
-            // - присваивает текущее значение к минимальному;
-            // - устанавливает значение частоты равное 1;
-            // - сохраняет пары NumberAndHash
-            avalanche_info.hamming_distance.min = dist_and_freq;
-            avalanche_info.original_pair = original;
-            avalanche_info.modified_pair = modified;
+    // Заполняет массив чисел для вычисления расстояния Хемминга
+    void FillModifiedNumbers(uint64_t original_number, std::span<uint64_t> numbers) {
+        BOOST_ASSERT_MSG(numbers.size() == numbers_per_key, "numbers.size() != numbers_per_key");
+        numbers[0] = original_number;
+        for (uint8_t bit_index = 0; bit_index < number_size; ++bit_index) {
+            numbers[bit_index + 1] = original_number ^ (1ull << bit_index);
         }
     }
 
-    void CompareAndChangeMaxHammingDistance(AvalancheInfo& avalanche_info, const DistanceAndFrequency& dist_and_freq) {
-        if (avalanche_info.hamming_distance.max == dist_and_freq) {
-            // Если текущее значение равно максимальному, то увеличивает частоту максимального расстояния
-            avalanche_info.hamming_distance.max.frequency += dist_and_freq.frequency;
-        } else if (avalanche_info.hamming_distance.max < dist_and_freq) {
-            // Если значение больше максимального, то:
-            // - присваивает текущее значение к максимальному;
-            // - устанавливает значение частоты равное 1
-            avalanche_info.hamming_distance.max = dist_and_freq;
+    // Вычисляет статистику расстояния Хемминга по частотам всех расстояний
+    void CalculateHammingDistanceStatistics(AvalancheInfo& avalanche_info) {
+        const std::vector<uint64_t>& all_distances = avalanche_info.all_distances;
+        HammingDistance& hamming_distance = avalanche_info.hamming_distance;
+
+        // Число расстояний, их сумма и сумма квадратов. Для 2^32 ключей число расстояний равно 2^38,
+        // расстояние не превышает 128 (2^7) для 128-битных хешей, поэтому сумма квадратов
+        // не превышает 2^52 и 64-битные суммы не переполняются
+        uint64_t num_distances = 0;
+        uint64_t sum = 0;
+        uint64_t sum_of_squares = 0;
+        for (uint64_t distance = 0; distance < all_distances.size(); ++distance) {
+            const uint64_t frequency = all_distances[distance];
+            if (frequency == 0) {
+                continue;
+            }
+            if (num_distances == 0) {
+                hamming_distance.min.value = distance;
+                hamming_distance.min.frequency = frequency;
+            }
+            hamming_distance.max.value = distance;
+            hamming_distance.max.frequency = frequency;
+            num_distances += frequency;
+            sum += distance * frequency;
+            sum_of_squares += distance * distance * frequency;
+        }
+        if (num_distances == 0) {
+            return;
+        }
+
+        // Дисперсия: (n * sum(x^2) - sum(x)^2) / n^2. Числитель вычисляется в 128-битных целых без округления
+        using Uint128 = unsigned __int128;
+        const Uint128 variance_numerator = static_cast<Uint128>(num_distances) * sum_of_squares
+                                           - static_cast<Uint128>(sum) * sum;
+        const auto n = static_cast<long double>(num_distances);
+        hamming_distance.avg = static_cast<long double>(sum) / n;
+        hamming_distance.variance = static_cast<long double>(variance_numerator) / (n * n);
+    }
+
+    // Объединяет информацию о лавинном эффекте, вычисленную в разных потоках
+    void MergeAvalancheInfo(AvalancheInfo& result, const AvalancheInfo& other) {
+        if (result.hamming_distance.min > other.hamming_distance.min) {
+            result.hamming_distance.min = other.hamming_distance.min;
+            result.original_pair = other.original_pair;
+            result.modified_pair = other.modified_pair;
+        }
+        for (size_t distance = 0; distance < result.all_distances.size(); ++distance) {
+            result.all_distances[distance] += other.all_distances[distance];
         }
+        result.sac_matrix.Merge(other.sac_matrix);
     }
 
     // Запускает тестирование лавинного эффекта всех функций одной битности
     template<hfl::UnsignedIntegral UintT>
     static void RunAvalancheTestImpl(uint16_t num_threads, out::Logger& logger) {
-        constexpr uint16_t bits = std::numeric_limits<UintT>::digits;
+        constexpr uint16_t bits = hfl::hash_bits_v<UintT>;
         constexpr uint64_t num_keys = 1ull << 32;
-        const auto hashes = hfl::BuildHashes<UintT>();
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
         const AvalancheTestParameters parameters{bits, num_threads, num_keys};
         AvalancheTest(hashes, parameters, logger);
     }
@@ -141,5 +189,6 @@ namespace tests {
         RunAvalancheTestImpl<uint16_t>(num_threads, logger);
         RunAvalancheTestImpl<uint32_t>(num_threads, logger);
         RunAvalancheTestImpl<uint64_t>(num_threads, logger);
+        RunAvalancheTestImpl<hfl::uint128_t>(num_threads, logger);
     }
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #ifndef THESIS_WORK_AVALANCHE_TESTS_H
 #define THESIS_WORK_AVALANCHE_TESTS_H
 
+#include <algorithm>
+#include <bit>
 #include <bitset>
 #include <concepts>
 #include <compare>
-#include <future>
+#include <span>
+#include <type_traits>
 #include <vector>
 #include <thread>
 
@@ -18,18 +21,26 @@
 #include "hashes.h"
 #include "my_assert.h"
 #include "output.h"
+#include "sac_matrix.h"
 #include "test_parameters.h"
 #include "timers.h"
 
 namespace tests {
     class AvalancheInfo;
 
+    // Число бит хешируемого числа
+    static inline constexpr uint8_t number_size = 64;
+    // Число хешируемых чисел для одного ключа: исходное число и number_size чисел с измененным битом
+    static inline constexpr size_t numbers_per_key = number_size + 1;
+    // Наибольшее число бит хеш-значения
+    static inline constexpr uint16_t max_hash_bits = 128;
+
     namespace out {
         /*
          *  Формирует json-файл, в который будет сохранена информация с теста хеш функции на лавинный эффект
          *  Входные параметры:
          *      1. parameters - параметры тестирования:
-         *          - битность хеша (16, 32 или 64)
+         *          - битность хеша (16, 32, 64 или 128)
          *          - число ключей (целое положительное число)
          *          - число потоков (зависит от системы)
          *      2. logger - записывает лог в файл и выводит его на консоль
@@ -40,7 +51,8 @@ namespace tests {
          *  Сохраняет информацию с теста хеш функции на лавинный эффект в json
          *  Входные параметры:
          *      1. avalanche_info - содержит информацию о результатах теста: расстояние Хемминга,
-         *                                                                   пары число-хеш для худшего случая
+         *                                                                   пары число-хеш для худшего случая,
+         *                                                                   матрица SAC
          *  Выходное значение: json-структура, в которой сохранена вся информация о тесте, необходимая для отрисовки
          *                     графиков и таблиц
          */
@@ -80,21 +92,22 @@ namespace tests {
     // Оператор вывода структуры DistanceAndFrequency
     std::ostream& operator<<(std::ostream &os, const DistanceAndFrequency& distance_and_frequency);
 
-    // Структура, которая хранит информацию о минимальном, максимальном
-    // и среднем значении расстояния Хемминга
+    // Структура, которая хранит информацию о минимальном, максимальном,
+    // среднем значении и дисперсии расстояния Хемминга
     struct HammingDistance {
         DistanceAndFrequency min {std::numeric_limits<uint8_t>::max()};     // худший случай
         DistanceAndFrequency max {0};                                       // лучший случай
         long double avg = 0;                                                // среднее значение
+        long double variance = 0;                                           // дисперсия
     };
 
     // Оператор вывода структуры HammingDistance
     std::ostream& operator<<(std::ostream &os, const HammingDistance& distance);
 
-    // Структура, которая хранит пару число и его хеш
+    // Структура, которая хранит пару число и его хеш (хеш-значение полной ширины, до 128 бит)
     struct NumberAndHash {
         uint64_t number = 0;
-        uint64_t hash = 0;
+        hfl::uint128_t hash = 0;
     };
 
     // Оператор вывода структуры NumberAndHash
@@ -105,93 +118,79 @@ namespace tests {
         HammingDistance hamming_distance;
         NumberAndHash original_pair;    // Пара оригинальные число и его хеш для худшего случая
         NumberAndHash modified_pair;    // Пара измененные число и его хеш для худшего случая
-        std::vector<uint64_t> all_distances = std::vector<uint64_t>(65, 0); // частота всех расстояний хемминга
+        std::vector<uint64_t> all_distances = std::vector<uint64_t>(max_hash_bits + 1, 0); // частота всех расстояний хемминга
+        SacMatrix sac_matrix;           // Матрица строгого лавинного критерия
     };
 
     // Оператор вывода структуры AvalancheInfo
     std::ostream& operator<<(std::ostream &os, const AvalancheInfo& avalanche_info);
 
-    /*  Сравнивает минимальное расстояние Хемминга с текущим. Если текущее значение меньше максимального, то:
-     *      - присваивает текущее значение к минимальному;
-     *      - устанавливает значение частоты равное 1
-     *  Входные параметры:
-     *      1. avalanche_info - общая информация о результатах теста. Содержит минимальное расстояние
-     *      2. dist_and_freq - расстояние Хемминга на текущем шаге тестирования
-     *      3. original - пара оригинальное число и его хеш на текущем шаге тестирования
-     *      4. modified - пара измененное число и его хеш на текущем шаге тестирования
+    /*
+     *  Вычисляет минимальное и максимальное расстояние Хемминга (с частотами), среднее значение и дисперсию
+     *  по частотам всех расстояний. Суммы накапливаются в целых числах, поэтому результат точный
+     *  и не зависит от числа потоков
+     *  Входной параметр: avalanche_info - информация о лавинном эффекте с заполненными частотами расстояний
      */
-    void CompareAndChangeMinHammingDistance(AvalancheInfo& avalanche_info, const DistanceAndFrequency& dist_and_freq,
-                                         const NumberAndHash& original, const NumberAndHash& modified);
+    void CalculateHammingDistanceStatistics(AvalancheInfo& avalanche_info);
 
     /*
-     *  Сравнивает максимальное расстояние Хемминга с текущим. Если текущее значение больше максимального, то:
-     *      - присваивает текущее значение к максимальному;
-     *      - устанавливает значение частоты равное 1
+     *  Заполняет массив чисел для вычисления расстояния Хемминга:
+     *  numbers[0] - исходное число, numbers[i + 1] - исходное число с измененным i-ым битом
      *  Входные параметры:
-     *      1. avalanche_info - общая информация о результатах теста. Содержит максимальное расстояние
-     *      2. dist_and_freq - расстояние Хемминга на текущем шаге тестирования
+     *      1. original_number - исходное число
+     *      2. numbers - массив размером numbers_per_key, который будет заполнен
      */
-    void CompareAndChangeMaxHammingDistance(AvalancheInfo& avalanche_info, const DistanceAndFrequency& dist_and_freq);
+    void FillModifiedNumbers(uint64_t original_number, std::span<uint64_t> numbers);
 
     /*
-     *  Рекуррентно вычисляет среднее расстояние Хемминга
+     *  Вычисляет расстояния хемминга и добавляет их к частотам расстояний. Реализация описана ниже
+     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
      *  Входные параметры:
-     *      1. prev_avg - среднее значение расстояния Хемминга на прошлом шаге
-     *      2. current_value - текущее значение расстояния Хемминга
-     *      3. step - текущий шаг
-     *  Выходное значение: среднее значение расстояния Хемминга на текущем шаге
+     *      1. avalanche_info - информация о лавинном эффекте: частоты расстояний Хемминга
+     *                          и пары число-хеш для худшего случая
+     *      2. numbers - исходное число и числа с измененными битами (заполняются функцией FillModifiedNumbers)
+     *      3. hashes - хеш-значения чисел из numbers (для 128-битных хеш функций - без свертки)
      */
-    static inline long double CalculateArithmeticMean(long double prev_avg, long double current_value, long double step) {
-        long double multiplier1 = 1l / (step + 1l);
-        long double multiplier2 = step * prev_avg + current_value;
-        return multiplier1 * multiplier2;
-    }
+    template<hfl::UnsignedIntegral UintT>
+    void CalculateHammingDistance(AvalancheInfo& avalanche_info, std::span<const uint64_t> numbers,
+                                  std::span<const hfl::HashValueType<UintT>> hashes);
 
     /*
-     *  Вычисляет расстояние хемминга. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     *  Объединяет информацию о лавинном эффекте, вычисленную в разных потоках
+     *  (частоты расстояний, матрицу SAC и пары число-хеш для худшего случая)
      *  Входные параметры:
-     *      1. avalanche_info - информация о лавинном эффекте: расстояние Хемминга и пары число-хеш для худшего случая
-     *      2. hash - хеш-функция
-     *      3. parameters - параметры тестирования:
-     *          - битность хеша (16, 32 или 64)
-     *          - число ключей (целое положительное число)
-     *          - число потоков (зависит от системы)
-     *      4. original_number - оригинальное число, в котором будут изменяться биты для вычисления расстояния Хемминга
+     *      1. result - общая информация, к которой добавляется other
+     *      2. other - информация, вычисленная в другом потоке
      */
-    template<hfl::UnsignedIntegral UintT>
-    void CalculateHammingDistance(AvalancheInfo& avalanche_info, const hfl::Hash<UintT>& hash,
-                                  const AvalancheTestParameters& parameters, uint64_t original_number,
-                                  uint64_t iteration_step);
+    void MergeAvalancheInfo(AvalancheInfo& result, const AvalancheInfo& other);
 
     /*
-     *  Тестирование лавинного эффекта для одной хеш функции. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     *  Тестирование лавинного эффекта всех хеш функций набора за один совмещенный проход. Реализация описана ниже.
+     *  Каждый пакет ключей генерируется один раз и хешируется всеми хеш функциями, пока он находится в кэше L1
+     *  Параметр шаблона: набор хеш функций (кортеж из hfl::StaticHash или вектор из hfl::Hash)
      *  Входные параметры:
-     *      1. hash - хеш-функция
+     *      1. hashes - набор со всеми хеш-функциями одной битности
      *      2. parameters - параметры тестирования:
-     *          - битность хеша (16, 32 или 64)
+     *          - битность хеша (16, 32, 64 или 128)
      *          - число ключей (целое положительное число)
      *          - число потоков (зависит от системы)
-     *      3. logger - записывает лог в файл и выводит его на консоль
+     *  Выходное значение: информация о лавинном эффекте каждой хеш функции (в порядке hashes)
      */
-    template<hfl::UnsignedIntegral UintT>
-    AvalancheInfo HashAvalancheTest(const hfl::Hash<UintT>& hash, const AvalancheTestParameters& parameters,
-                                    out::Logger& logger);
+    template<typename Hashes>
+    std::vector<AvalancheInfo> FusedAvalancheTest(const Hashes& hashes, const AvalancheTestParameters& parameters);
 
     /*  Тестирование лавинного эффекта всех функций. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     *  Параметр шаблона: набор хеш функций (кортеж из hfl::StaticHash или вектор из hfl::Hash)
      *  Входные параметры:
-     *      1. hashes - массив со всеми хеш-функциями одной битности
+     *      1. hashes - набор со всеми хеш-функциями одной битности
      *      2. parameters - параметры тестирования:
-     *          - битность хеша (16, 32 или 64)
+     *          - битность хеша (16, 32, 64 или 128)
      *          - число потоков (зависит от системы)
      *          - число ключей (целое положительное число)
      *      3. logger - записывает лог в файл и выводит его на консоль
      */
-    template<hfl::UnsignedIntegral UintT>
-    void AvalancheTest(const std::vector<hfl::Hash<UintT>>& hashes, const AvalancheTestParameters& parameters,
-                       out::Logger& logger);
+    template<typename Hashes>
+    void AvalancheTest(const Hashes& hashes, const AvalancheTestParameters& parameters, out::Logger& logger);
 
     //  Запускает тестирование лавинного эффекта всех функций
     //  Входной параметр: logger - записывает лог в файл и выводит его на консоль
@@ -200,99 +199,140 @@ namespace tests {
 
 // ==================================================
 
-    // Вычисляет расстояние хемминга.
+    // Вычисляет расстояния хемминга и добавляет их к частотам расстояний
     template<hfl::UnsignedIntegral UintT>
-    void CalculateHammingDistance(AvalancheInfo& avalanche_info, const hfl::Hash<UintT>& hash,
-                                  const AvalancheTestParameters& parameters, uint64_t original_number,
-                                  uint64_t iteration_step) {
-        // число бит хэшируемого числа
-        constexpr uint8_t number_size = 64;
-        // Число бит хеш-значения
-        constexpr uint8_t hash_size = std::numeric_limits<UintT>::digits;
+    void CalculateHammingDistance(AvalancheInfo& avalanche_info, std::span<const uint64_t> numbers,
+                                  std::span<const hfl::HashValueType<UintT>> hashes) {
         // Пара исходного числа и его хеша
-        const NumberAndHash original {original_number, hash(original_number)};
+        const NumberAndHash original {numbers[0], hashes[0]};
 
-        // Цикл, в котором меняется i-ый бит исходного числа (i = 1, 2, ... 64)
-        // и вычисляется расстояние Хемминга
+        // Цикл, в котором перебираются числа с измененным i-ым битом (i = 1, 2, ... 64)
+        // и вычисляется расстояние Хемминга. Остальная статистика вычисляется в конце теста по частотам
         for (uint8_t bit_index = 0; bit_index < number_size; ++bit_index) {
-            std::bitset<number_size> modified_number_bits = original_number;
-            modified_number_bits.flip(bit_index);
-            const uint64_t modified_number = modified_number_bits.to_ullong();
-            const NumberAndHash modified {modified_number, hash(modified_number)};
-            std::bitset<hash_size> xor_hashes = original.hash ^ modified.hash;
-            DistanceAndFrequency hamming_distance{xor_hashes.count()};
-            ++avalanche_info.all_distances[hamming_distance.value];
-            CompareAndChangeMinHammingDistance(avalanche_info, hamming_distance, original, modified);
-            CompareAndChangeMaxHammingDistance(avalanche_info, hamming_distance);
-            avalanche_info.hamming_distance.avg = CalculateArithmeticMean(avalanche_info.hamming_distance.avg,
-                                                                          hamming_distance.value, iteration_step);
+            const NumberAndHash modified {numbers[bit_index + 1], hashes[bit_index + 1]};
+            const hfl::uint128_t xor_hashes = original.hash ^ modified.hash;
+            uint16_t hamming_distance = 0;
+            if constexpr (std::is_same_v<UintT, hfl::uint128_t>) {
+                // std::popcount не принимает uint128_t: биты считаются по 64-битным половинам
+                hamming_distance = static_cast<uint16_t>(std::popcount(static_cast<uint64_t>(xor_hashes))
+                                                         + std::popcount(static_cast<uint64_t>(xor_hashes >> 64)));
+            } else {
+                hamming_distance = static_cast<uint16_t>(std::popcount(static_cast<UintT>(xor_hashes)));
+            }
+            ++avalanche_info.all_distances[hamming_distance];
+            // Для нового худшего случая сохраняются пары число-хеш
+            if (avalanche_info.hamming_distance.min > hamming_distance) {
+                avalanche_info.hamming_distance.min = hamming_distance;
+                avalanche_info.original_pair = original;
+                avalanche_info.modified_pair = modified;
+            }
         }
     }
 
-    // Тестирование лавинного эффекта для одной хеш функции
-    template<hfl::UnsignedIntegral UintT>
-    AvalancheInfo HashAvalancheTest(const hfl::Hash<UintT>& hash, const AvalancheTestParameters& parameters,
-                                    out::Logger& logger) {
-        logger << boost::format("\t%1%: \n") % hash.GetName();
-
-        // Выдает генераторы, число которых равно числу запускаемых потоков
-        auto generators = GetGenerators(parameters.num_threads, parameters.num_keys);
-
-        std::atomic_uint16_t gen_index = 0;
-        // Функция, запускаемая в отдельном потоке.
-        // Вычисляет расстояния хемминга для last - first чисел
-        auto thread_task = [&hash, &parameters, &generators, &gen_index] (uint64_t first, uint64_t last) {
-            pcg64 rng = generators[gen_index++];
-            AvalancheInfo avalanche_info;
+    // Тестирование лавинного эффекта всех хеш функций набора за один совмещенный проход
+    template<typename Hashes>
+    std::vector<AvalancheInfo> FusedAvalancheTest(const Hashes& hashes, const AvalancheTestParameters& parameters) {
+        const size_t num_hashes = hfl::NumHashes(hashes);
+
+        // Генератор исходных чисел. Ключ с индексом i - (i + 1)-е число генератора, поэтому результат
+        // не зависит от того, как ключи распределены между потоками. Генератор сдвинут на число
+        // 64-битных сидов (как в GetGenerators), чтобы хешируемые числа не совпадали с сидами
+        pcg64 generator;
+        generator.advance(NUM_64_BITS_SEEDS);
+
+        // Функция, которая выполняется в потоке пула.
+        // Вычисляет расстояния хемминга для last - first чисел и добавляет их к результатам потока.
+        // Числа хешируются пакетами по keys_per_batch исходных чисел: пакет генерируется один раз
+        // и хешируется всеми хеш функциями
+        // Хеш-значения 128-битных хеш функций хранятся без свертки
+        using HashValueT = hfl::HashValueType<hfl::HashesUintT<Hashes>>;
+        auto thread_task = [&hashes, &generator] (std::vector<AvalancheInfo>& avalanche_infos,
+                                                  uint64_t first, uint64_t last) {
+            constexpr size_t keys_per_batch = hash_batch_size / numbers_per_key;
+            pcg64 rng = generator;
+            rng.advance(first);
+            std::vector<uint64_t> numbers(keys_per_batch * numbers_per_key);
+            std::vector<HashValueT> hash_values(keys_per_batch * numbers_per_key);
             while (first < last) {
-                uint64_t number = rng();
-                CalculateHammingDistance(avalanche_info, hash, parameters, number, ++first);
+                const size_t num_keys = std::min<uint64_t>(keys_per_batch, last - first);
+                const size_t batch_size = num_keys * numbers_per_key;
+                const std::span numbers_batch(numbers.data(), batch_size);
+                const std::span hashes_batch(hash_values.data(), batch_size);
+
+                for (size_t key = 0; key < num_keys; ++key) {
+                    FillModifiedNumbers(rng(), numbers_batch.subspan(key * numbers_per_key, numbers_per_key));
+                }
+                hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+                    using UintT = typename std::remove_cvref_t<decltype(hash)>::UintType;
+                    hash.HashBatch(numbers_batch, hashes_batch);
+                    for (size_t key = 0; key < num_keys; ++key) {
+                        const size_t offset = key * numbers_per_key;
+                        CalculateHammingDistance<UintT>(avalanche_infos[hash_index],
+                                                        numbers_batch.subspan(offset, numbers_per_key),
+                                                        hashes_batch.subspan(offset, numbers_per_key));
+                        avalanche_infos[hash_index].sac_matrix.AddKey(
+                                hashes_batch[offset], hashes_batch.subspan(offset + 1, number_size));
+                    }
+                });
+                first += num_keys;
             }
-            return avalanche_info;
         };
 
-        uint16_t step = 0;
         // Функция, в которой объединяется информация о лавинном эффекте вычисленном в разных потоках
-        auto merge_results = [&step](AvalancheInfo& best_result, const AvalancheInfo& current_result)  {
-            CompareAndChangeMinHammingDistance(best_result, current_result.hamming_distance.min,
-                                               current_result.original_pair, current_result.modified_pair);
-            CompareAndChangeMaxHammingDistance(best_result, current_result.hamming_distance.max);
-            best_result.hamming_distance.avg = CalculateArithmeticMean(best_result.hamming_distance.avg,
-                                                                       current_result.hamming_distance.avg, ++step);
-            for (size_t distance; distance < best_result.all_distances.size(); ++distance) {
-                best_result.all_distances[distance] += current_result.all_distances[distance];
+        auto merge_results = [](std::vector<AvalancheInfo>& best_results,
+                                const std::vector<AvalancheInfo>& current_results) {
+            for (size_t i = 0; i < best_results.size(); ++i) {
+                MergeAvalancheInfo(best_results[i], current_results[i]);
             }
         };
 
-        // Запускает вычисление лавинного эффекта в нескольких потоках
-        ThreadTasks<AvalancheInfo> tasks(thread_task, merge_results, parameters.num_threads, parameters.num_keys);
-        const auto result = tasks.GetResult();
-
-        // Логирование информации о лавинном эффекте
-        logger << result << std::endl;
-        for (size_t i = 0; i < result.all_distances.size(); ++i) {
-            std::cout << "\t\tdistance =" << i << " , frequency = " << result.all_distances[i] << '\n';
+        // Запускает вычисление лавинного эффекта в потоках пула.
+        // Часть, которую поток берет за раз, - 64 пакета ключей
+        constexpr uint64_t keys_grain = 64 * (hash_batch_size / numbers_per_key);
+        AvalancheInfo empty_info;
+        empty_info.sac_matrix = SacMatrix(parameters.hash_bits);
+        auto avalanche_infos = ParallelReduce(0, parameters.num_keys, keys_grain,
+                                              std::vector<AvalancheInfo>(num_hashes, empty_info),
+                                              thread_task, merge_results, parameters.num_threads);
+
+        // Статистика вычисляется один раз по общим частотам расстояний
+        for (AvalancheInfo& avalanche_info : avalanche_infos) {
+            CalculateHammingDistanceStatistics(avalanche_info);
         }
-        return result;
+        return avalanche_infos;
     }
 
     // Тестирование лавинного эффекта всех функций
-    template<hfl::UnsignedIntegral UintT>
-    void AvalancheTest(const std::vector<hfl::Hash<UintT>>& hashes, const AvalancheTestParameters& parameters,
-                       out::Logger& logger) {
+    template<typename Hashes>
+    void AvalancheTest(const Hashes& hashes, const AvalancheTestParameters& parameters, out::Logger& logger) {
         out::StartAndEndLogBitsTest log(logger, parameters.hash_bits);
 
         auto out_json = out::GetAvalancheTestJson(parameters, logger);
         boost::json::object avalanche_statistics;
 
-        // В цикле запускаются тесты (HashAvalancheTest) для каждой хеш функции
-        for (const auto& hash : hashes) {
-            out::LogDuration log_duration("\t\ttime", logger);
-            AvalancheInfo avalanche_info = HashAvalancheTest(hash, parameters, logger);
+        // Все хеш функции тестируются за один проход
+        std::vector<AvalancheInfo> results;
+        {
+            out::LogDuration log_duration("\ttime", logger);
+            results = FusedAvalancheTest(hashes, parameters);
+        }
+
+        // Логирование и сохранение информации о лавинном эффекте каждой хеш функции
+        hfl::ForEachHashIndexed(hashes, [&results, &logger, &avalanche_statistics](size_t index, const auto& hash) {
+            const AvalancheInfo& avalanche_info = results[index];
+            logger << boost::format("\t%1%: \n") % hash.GetName();
+            logger << avalanche_info << std::endl;
+            for (size_t i = 0; i < avalanche_info.all_distances.size(); ++i) {
+                std::cout << "\t\tdistance =" << i << " , frequency = " << avalanche_info.all_distances[i] << '\n';
+            }
             auto hash_avalanche_statistics = out::AvalancheInfoToJson(avalanche_info);
             logger << "\t\tmedian hamming distance: " << hash_avalanche_statistics["Median case"] << std::endl;
-            avalanche_statistics[hash.GetName()] = std::move(out::AvalancheInfoToJson(avalanche_info));
-        }
+            const SacBias max_bias = avalanche_info.sac_matrix.MaxBias();
+            logger << boost::format("\t\tmax SAC bias: %1% (input bit %2%, output bit %3%)\n")
+                      % max_bias.value % static_cast<uint16_t>(max_bias.input_bit)
+                      % static_cast<uint16_t>(max_bias.output_bit);
+            avalanche_statistics[hash.GetName()] = std::move(hash_avalanche_statistics);
+        });
 
         // Сохранение информации из тестов в json
         out_json.obj["Avalanche effect"] = avalanche_statistics;
@@ -0,0 +1,43 @@
+#include "benchmark.h"
+
+#include <boost/assert.hpp>
+
+#include <highwayhash/robust_statistics.h>
+
+namespace tests::bench {
+    // Вычисляет медиану и MAD выборки
+    RobustValue CalculateRobustValue(std::vector<double> samples) {
+        BOOST_ASSERT_MSG(!samples.empty(), "Empty samples");
+        const double median = highwayhash::Median(&samples);
+        const double mad = highwayhash::MedianAbsoluteDeviation(samples, median);
+        return RobustValue{median, mad};
+    }
+
+    // Вычисляет медиану и MAD числа тактов на единицу работы
+    RobustValue TicksPerUnit(const TrialsResult& result, double units_per_trial) {
+        std::vector<double> samples;
+        samples.reserve(result.trials.size());
+        for (const TrialResult& trial : result.trials) {
+            samples.push_back(static_cast<double>(trial.ticks) / units_per_trial);
+        }
+        return CalculateRobustValue(std::move(samples));
+    }
+
+    // Вычисляет медиану времени одного запуска (в секундах)
+    double MedianSeconds(const TrialsResult& result) {
+        std::vector<double> samples;
+        samples.reserve(result.trials.size());
+        for (const TrialResult& trial : result.trials) {
+            samples.push_back(trial.seconds);
+        }
+        return CalculateRobustValue(std::move(samples)).median;
+    }
+
+    // Переводит RobustValue в json
+    boost::json::object RobustValueToJson(const RobustValue& value) {
+        boost::json::object obj;
+        obj["Median"] = value.median;
+        obj["MAD"] = value.mad;
+        return obj;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef THESIS_WORK_BENCHMARK_H
+#define THESIS_WORK_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include <highwayhash/tsc_timer.h>
+
+namespace tests::bench {
+    // Параметры замера
+    struct BenchmarkParameters {
+        uint16_t num_warmup_trials; // Число прогревочных запусков (не учитываются)
+        uint16_t num_trials;        // Число учитываемых запусков
+    };
+
+    // Параметры замера по умолчанию
+    inline constexpr BenchmarkParameters default_benchmark_parameters{2, 15};
+
+    // Устойчивая к выбросам оценка величины: медиана и медианное абсолютное отклонение (MAD)
+    struct RobustValue {
+        double median{};
+        double mad{};
+    };
+
+    // Результат одного запуска
+    struct TrialResult {
+        uint64_t ticks{};   // Число тактов TSC
+        double seconds{};   // Фактическое время
+    };
+
+    // Результаты всех учитываемых запусков
+    struct TrialsResult {
+        std::vector<TrialResult> trials;
+        uint64_t checksum{};    // Сумма значений, которые вернула функция (защищает от удаления кода оптимизатором)
+    };
+
+    /*
+     *  Вычисляет медиану и MAD выборки
+     *  Входной параметр: samples - выборка (непустая)
+     */
+    RobustValue CalculateRobustValue(std::vector<double> samples);
+
+    /*
+     *  Вычисляет медиану и MAD числа тактов на единицу работы (хеш, байт и т.п.)
+     *  Входные параметры:
+     *      1. result - результаты запусков
+     *      2. units_per_trial - число единиц работы в одном запуске
+     */
+    RobustValue TicksPerUnit(const TrialsResult& result, double units_per_trial);
+
+    // Вычисляет медиану времени одного запуска (в секундах)
+    double MedianSeconds(const TrialsResult& result);
+
+    // Переводит RobustValue в json
+    boost::json::object RobustValueToJson(const RobustValue& value);
+
+    /*
+     *  Многократно запускает функцию и замеряет каждый запуск счетчиком тактов TSC
+     *  (highwayhash::Start/Stop) и часами std::chrono::steady_clock
+     *  Параметр шаблона: функция без аргументов, которая возвращает uint64_t
+     *  Входные параметры:
+     *      1. function - замеряемая функция
+     *      2. parameters - число прогревочных и учитываемых запусков
+     */
+    template<typename Function>
+    TrialsResult RunTrials(Function&& function, const BenchmarkParameters& parameters = default_benchmark_parameters);
+
+// ==================================================
+
+    // Многократно запускает функцию и замеряет каждый запуск
+    template<typename Function>
+    TrialsResult RunTrials(Function&& function, const BenchmarkParameters& parameters) {
+        using Clock = std::chrono::steady_clock;
+
+        TrialsResult result;
+        result.trials.reserve(parameters.num_trials);
+
+        // Прогрев: кэши, предсказатель переходов, частота процессора
+        for (uint16_t i = 0; i < parameters.num_warmup_trials; ++i) {
+            result.checksum += function();
+        }
+
+        for (uint16_t i = 0; i < parameters.num_trials; ++i) {
+            const auto start_time = Clock::now();
+            const auto start_ticks = highwayhash::Start<uint64_t>();
+            result.checksum += function();
+            const auto stop_ticks = highwayhash::Stop<uint64_t>();
+            const std::chrono::duration<double> duration = Clock::now() - start_time;
+            result.trials.push_back(TrialResult{stop_ticks - start_ticks, duration.count()});
+        }
+
+        return result;
+    }
+}
+
+#endif //THESIS_WORK_BENCHMARK_H
@@ -0,0 +1,160 @@
+#ifndef THESIS_WORK_BIT_WIDTH_UINT_H
+#define THESIS_WORK_BIT_WIDTH_UINT_H
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+// HFL = Hash function library
+namespace hfl {
+    /*
+     *  Целое беззнаковое число произвольной битности (меньше 64 бит).
+     *  Значение хранится в uint32_t или uint64_t и обрезается маской после каждой операции,
+     *  поэтому арифметика выполняется по модулю 2^Bits, как у встроенных беззнаковых типов
+     *  Параметр шаблона: Bits - число бит
+     */
+    template<uint8_t Bits>
+    class BitWidthUint {
+        static_assert(Bits > 0 && Bits < 64, "Bits must be in range [1, 63]");
+    public:
+        // Тип, в котором хранится значение
+        using StorageType = std::conditional_t<(Bits <= 32), uint32_t, uint64_t>;
+        // Маска младших Bits бит
+        static constexpr StorageType mask = (StorageType{1} << Bits) - 1;
+
+        constexpr BitWidthUint() noexcept = default;
+
+        // Неявное преобразование из встроенных целых чисел (старшие биты отбрасываются)
+        template<std::integral T>
+        constexpr BitWidthUint(T value) noexcept
+                : value_(static_cast<StorageType>(value) & mask) {
+        }
+
+        // Явное преобразование во встроенные целые числа
+        template<std::integral T>
+        constexpr explicit operator T() const noexcept {
+            return static_cast<T>(value_);
+        }
+
+        // Возвращает хранимое значение
+        [[nodiscard]] constexpr StorageType Value() const noexcept {
+            return value_;
+        }
+
+        // Арифметические и битовые операции
+        friend constexpr BitWidthUint operator+(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ + rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator-(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ - rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator*(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ * rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator/(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ / rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator%(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ % rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator&(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ & rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator|(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ | rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator^(BitWidthUint lhs, BitWidthUint rhs) noexcept {
+            return BitWidthUint{lhs.value_ ^ rhs.value_};
+        }
+
+        friend constexpr BitWidthUint operator<<(BitWidthUint lhs, std::integral auto shift) noexcept {
+            return BitWidthUint{lhs.value_ << shift};
+        }
+
+        friend constexpr BitWidthUint operator>>(BitWidthUint lhs, std::integral auto shift) noexcept {
+            return BitWidthUint{lhs.value_ >> shift};
+        }
+
+        constexpr BitWidthUint operator~() const noexcept {
+            return BitWidthUint{~value_};
+        }
+
+        constexpr BitWidthUint operator-() const noexcept {
+            return BitWidthUint{StorageType{0} - value_};
+        }
+
+        // Составные операции присваивания
+        constexpr BitWidthUint& operator+=(BitWidthUint rhs) noexcept { return *this = *this + rhs; }
+        constexpr BitWidthUint& operator-=(BitWidthUint rhs) noexcept { return *this = *this - rhs; }
+        constexpr BitWidthUint& operator*=(BitWidthUint rhs) noexcept { return *this = *this * rhs; }
+        constexpr BitWidthUint& operator/=(BitWidthUint rhs) noexcept { return *this = *this / rhs; }
+        constexpr BitWidthUint& operator%=(BitWidthUint rhs) noexcept { return *this = *this % rhs; }
+        constexpr BitWidthUint& operator&=(BitWidthUint rhs) noexcept { return *this = *this & rhs; }
+        constexpr BitWidthUint& operator|=(BitWidthUint rhs) noexcept { return *this = *this | rhs; }
+        constexpr BitWidthUint& operator^=(BitWidthUint rhs) noexcept { return *this = *this ^ rhs; }
+        constexpr BitWidthUint& operator<<=(std::integral auto shift) noexcept { return *this = *this << shift; }
+        constexpr BitWidthUint& operator>>=(std::integral auto shift) noexcept { return *this = *this >> shift; }
+
+        // Инкремент и декремент
+        constexpr BitWidthUint& operator++() noexcept { return *this += 1; }
+        constexpr BitWidthUint& operator--() noexcept { return *this -= 1; }
+        constexpr BitWidthUint operator++(int) noexcept { BitWidthUint old = *this; ++*this; return old; }
+        constexpr BitWidthUint operator--(int) noexcept { BitWidthUint old = *this; --*this; return old; }
+
+        // Операции сравнения
+        friend constexpr bool operator==(const BitWidthUint& lhs, const BitWidthUint& rhs) noexcept = default;
+        friend constexpr auto operator<=>(const BitWidthUint& lhs, const BitWidthUint& rhs) noexcept = default;
+
+        friend std::ostream& operator<<(std::ostream& out, BitWidthUint number) {
+            return out << static_cast<uint64_t>(number.value_);
+        }
+
+    private:
+        StorageType value_ = 0;
+    };
+
+    // 128-битное целое беззнаковое число (встроенный тип GCC и Clang)
+    using uint128_t = unsigned __int128;
+
+    // Проверяет, является ли тип T числом BitWidthUint
+    template<typename T>
+    inline constexpr bool is_bit_width_uint_v = false;
+
+    template<uint8_t Bits>
+    inline constexpr bool is_bit_width_uint_v<BitWidthUint<Bits>> = true;
+}
+
+namespace std {
+    // Специализация numeric_limits для BitWidthUint. Все свойства, кроме
+    // числа бит и диапазона значений, совпадают со свойствами типа хранения
+    template<uint8_t Bits>
+    class numeric_limits<hfl::BitWidthUint<Bits>>
+            : public numeric_limits<typename hfl::BitWidthUint<Bits>::StorageType> {
+        using Type = hfl::BitWidthUint<Bits>;
+    public:
+        static constexpr int digits = Bits;
+        static constexpr int digits10 = Bits * 643L / 2136; // floor(Bits * log10(2))
+
+        static constexpr Type min() noexcept { return Type{0}; }
+        static constexpr Type lowest() noexcept { return Type{0}; }
+        static constexpr Type max() noexcept { return Type{Type::mask}; }
+        static constexpr Type epsilon() noexcept { return Type{0}; }
+        static constexpr Type round_error() noexcept { return Type{0}; }
+        static constexpr Type infinity() noexcept { return Type{0}; }
+        static constexpr Type quiet_NaN() noexcept { return Type{0}; }
+        static constexpr Type signaling_NaN() noexcept { return Type{0}; }
+        static constexpr Type denorm_min() noexcept { return Type{0}; }
+    };
+}
+
+#endif //THESIS_WORK_BIT_WIDTH_UINT_H
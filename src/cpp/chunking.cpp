@@ -0,0 +1,22 @@
+#include "chunking.h"
+
+#include <bit>
+
+#include <boost/assert.hpp>
+
+namespace hfl {
+    // Проверяет параметры разбиения и вычисляет маски
+    ChunkingMasks GetChunkingMasks(const ChunkingParameters& parameters) {
+        BOOST_ASSERT_MSG(parameters.window_size > 0, "Window size must be greater than 0");
+        BOOST_ASSERT_MSG(parameters.min_size >= parameters.window_size, "Min chunk size is less than window size");
+        BOOST_ASSERT_MSG(std::has_single_bit(parameters.average_size), "Average chunk size is not a power of two");
+        BOOST_ASSERT_MSG(parameters.min_size <= parameters.average_size
+                         && parameters.average_size <= parameters.max_size, "Chunk sizes are not ordered");
+
+        const int average_bits = std::countr_zero(parameters.average_size);
+        BOOST_ASSERT_MSG(parameters.normalization_level < average_bits, "Normalization level is too high");
+        const int strict_bits = average_bits + parameters.normalization_level;
+        const int loose_bits = average_bits - parameters.normalization_level;
+        return ChunkingMasks{(uint64_t{1} << strict_bits) - 1, (uint64_t{1} << loose_bits) - 1};
+    }
+}
@@ -0,0 +1,171 @@
+#ifndef THESIS_WORK_CHUNKING_H
+#define THESIS_WORK_CHUNKING_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace hfl {
+    // Параметры разбиения потока байтов на чанки
+    struct ChunkingParameters {
+        uint32_t min_size = 2 * 1024;       // Минимальный размер чанка (не меньше window_size)
+        uint32_t average_size = 8 * 1024;   // Ожидаемый размер чанка (степень двойки)
+        uint32_t max_size = 64 * 1024;      // Максимальный размер чанка (чанк обрезается принудительно)
+        uint32_t window_size = 48;          // Размер окна скользящего хеша
+        uint8_t normalization_level = 2;    // Уровень нормализации (0 - одна маска, как в LBFS)
+    };
+
+    // Маски, которые накладываются на скользящий хеш при поиске границы чанка
+    struct ChunkingMasks {
+        uint64_t strict;    // До average_size: log2(average_size) + normalization_level бит
+        uint64_t loose;     // После average_size: log2(average_size) - normalization_level бит
+    };
+
+    /*
+     *  Проверяет параметры разбиения и вычисляет маски
+     *  Входной параметр: parameters - параметры разбиения
+     *  Выходное значение: маски границы чанка
+     */
+    ChunkingMasks GetChunkingMasks(const ChunkingParameters& parameters);
+
+    // Скользящий хеш из rolling_hash (CyclicHash, KarpRabinHash, ThreeWiseHash, GeneralHash, Adler32):
+    // eat добавляет байт в окно, update сдвигает окно на один байт, hashvalue - хеш окна
+    template<typename RollingHash>
+    concept RollingHashFunction = requires(RollingHash hash, unsigned char byte) {
+        hash.reset();
+        hash.eat(byte);
+        hash.update(byte, byte);
+        { hash.hashvalue } -> std::convertible_to<uint64_t>;
+    };
+
+    /*
+     *  Разбиение потока байтов на чанки по содержимому (content-defined chunking).
+     *  Скользящий хеш проходит по потоку окном из window_size байт, и граница чанка ставится там,
+     *  где младшие биты хеша окна равны нулю, поэтому вставка или удаление байтов сдвигает
+     *  только границы соседних чанков. Первые min_size - window_size байт чанка не хешируются
+     *  (граница там невозможна). Нормализация (как в FastCDC): до average_size проверяется
+     *  строгая маска, после - мягкая, что сужает распределение размеров чанков
+     *  Параметр шаблона: RollingHash - скользящий хеш (тип хеш-значения не шире 64 бит)
+     */
+    template<RollingHashFunction RollingHash>
+    class ContentDefinedChunker {
+    public:
+        /*
+         *  Входные параметры:
+         *      1. rolling_hash - скользящий хеш с окном parameters.window_size
+         *      2. parameters - параметры разбиения
+         */
+        ContentDefinedChunker(RollingHash rolling_hash, const ChunkingParameters& parameters);
+
+        /*
+         *  Ищет конец первого чанка данных
+         *  Входной параметр: data - данные потока, начиная с начала чанка
+         *  Выходное значение: длина чанка. Если граница не найдена, а данных меньше max_size,
+         *  возвращает std::nullopt (нужны следующие данные потока или data - последний чанк)
+         */
+        std::optional<size_t> FindChunkEnd(std::string_view data);
+
+        /*
+         *  Разбивает данные на чанки. Остаток данных без границы считается последним чанком
+         *  Параметр шаблона: функция, которая принимает std::string_view (чанк)
+         *  Входные параметры:
+         *      1. data - данные (весь поток)
+         *      2. callback - вызывается для каждого чанка по порядку
+         */
+        template<typename Callback>
+        void Split(std::string_view data, Callback&& callback);
+
+        // Возвращает параметры разбиения
+        [[nodiscard]] const ChunkingParameters& GetParameters() const;
+
+    private:
+        // Сдвигает окно хеша по байтам [begin, end) данных и возвращает позицию после первой границы
+        // или 0, если граница не найдена. Окно хеша должно заканчиваться на позиции begin
+        size_t Roll(const unsigned char* bytes, size_t begin, size_t end, uint64_t mask);
+
+        RollingHash rolling_hash_;
+        ChunkingParameters parameters_;
+        ChunkingMasks masks_;
+    };
+
+// ==================================================
+
+    template<RollingHashFunction RollingHash>
+    ContentDefinedChunker<RollingHash>::ContentDefinedChunker(RollingHash rolling_hash,
+                                                              const ChunkingParameters& parameters)
+            : rolling_hash_(std::move(rolling_hash))
+            , parameters_(parameters)
+            , masks_(GetChunkingMasks(parameters)) {
+    }
+
+    // Ищет конец первого чанка данных
+    template<RollingHashFunction RollingHash>
+    std::optional<size_t> ContentDefinedChunker<RollingHash>::FindChunkEnd(std::string_view data) {
+        const size_t size = data.size();
+        if (size <= parameters_.min_size) {
+            return std::nullopt;
+        }
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        const size_t end = std::min<size_t>(size, parameters_.max_size);
+        const size_t normal_end = std::min<size_t>(end, parameters_.average_size);
+
+        // Окно хеша заполняется байтами перед первой возможной границей
+        rolling_hash_.reset();
+        for (size_t pos = parameters_.min_size - parameters_.window_size; pos < parameters_.min_size; ++pos) {
+            rolling_hash_.eat(bytes[pos]);
+        }
+        if ((static_cast<uint64_t>(rolling_hash_.hashvalue) & masks_.strict) == 0) {
+            return parameters_.min_size;
+        }
+
+        size_t chunk_end = Roll(bytes, parameters_.min_size, normal_end, masks_.strict);
+        if (chunk_end == 0) {
+            chunk_end = Roll(bytes, normal_end, end, masks_.loose);
+        }
+        if (chunk_end != 0) {
+            return chunk_end;
+        }
+        // Без границы чанк обрезается на max_size
+        if (size >= parameters_.max_size) {
+            return parameters_.max_size;
+        }
+        return std::nullopt;
+    }
+
+    // Сдвигает окно хеша по байтам [begin, end) и возвращает позицию после первой границы
+    template<RollingHashFunction RollingHash>
+    size_t ContentDefinedChunker<RollingHash>::Roll(const unsigned char* bytes, size_t begin, size_t end,
+                                                    uint64_t mask) {
+        const size_t window_size = parameters_.window_size;
+        for (size_t pos = begin; pos < end; ++pos) {
+            rolling_hash_.update(bytes[pos - window_size], bytes[pos]);
+            if ((static_cast<uint64_t>(rolling_hash_.hashvalue) & mask) == 0) {
+                return pos + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Разбивает данные на чанки
+    template<RollingHashFunction RollingHash>
+    template<typename Callback>
+    void ContentDefinedChunker<RollingHash>::Split(std::string_view data, Callback&& callback) {
+        while (!data.empty()) {
+            const size_t chunk_size = FindChunkEnd(data).value_or(data.size());
+            callback(data.substr(0, chunk_size));
+            data.remove_prefix(chunk_size);
+        }
+    }
+
+    // Возвращает параметры разбиения
+    template<RollingHashFunction RollingHash>
+    const ChunkingParameters& ContentDefinedChunker<RollingHash>::GetParameters() const {
+        return parameters_;
+    }
+}
+
+#endif //THESIS_WORK_CHUNKING_H
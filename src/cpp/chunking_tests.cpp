@@ -0,0 +1,313 @@
+#include "chunking_tests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_set>
+
+#include <boost/assert.hpp>
+
+#include <rolling_hash/adler32.h>
+#include <rolling_hash/cyclichash.h>
+#include <rolling_hash/generalhash.h>
+#include <rolling_hash/rabinkarphash.h>
+#include <rolling_hash/threewisehash.h>
+
+#include "benchmark.h"
+#include "generators.h"
+#include "hash_wrappers.h"
+#include "mapped_file.h"
+
+namespace tests {
+    namespace out {
+        // Формирует json-файл, в который будет сохранена информация с теста
+        // разбиения данных на чанки по содержимому
+        OutputJson GetChunkingTestJson(const hfl::ChunkingParameters& parameters, out::Logger& logger) {
+            const std::filesystem::path report_test_dir = "Chunking tests";
+            const auto report_test_path = logger.GetLogDirPath() / report_test_dir;
+            std::filesystem::create_directories(report_test_path);
+
+            const std::filesystem::path out_path = report_test_path / "Chunking.json";
+            std::ofstream out(out_path);
+            BOOST_ASSERT_MSG(out, "Failed to create file");
+
+            boost::json::object obj;
+            obj["Test name"] = "Content-Defined Chunking Tests";
+            obj["Min chunk size"] = parameters.min_size;
+            obj["Average chunk size"] = parameters.average_size;
+            obj["Max chunk size"] = parameters.max_size;
+            obj["Window size"] = parameters.window_size;
+            obj["Normalization level"] = parameters.normalization_level;
+            return OutputJson{std::move(obj), std::move(out)};
+        }
+
+        // Переводит результаты разбиения одним скользящим хешем в json
+        boost::json::object ChunkingResultToJson(const ChunkingResult& chunking_result) {
+            const ChunkSizeStatistics& chunk_sizes = chunking_result.chunk_sizes;
+            boost::json::array histogram;
+            for (const uint64_t count : chunk_sizes.histogram) {
+                histogram.emplace_back(count);
+            }
+
+            boost::json::object sizes_obj;
+            sizes_obj["Number of chunks"] = chunk_sizes.num_chunks;
+            sizes_obj["Max-size chunks"] = chunk_sizes.num_max_size_chunks;
+            sizes_obj["Min"] = chunk_sizes.num_chunks == 0 ? 0 : chunk_sizes.min_chunk_size;
+            sizes_obj["Max"] = chunk_sizes.max_chunk_size;
+            sizes_obj["Mean"] = chunk_sizes.Mean();
+            sizes_obj["Standard deviation"] = chunk_sizes.StandardDeviation();
+            sizes_obj["Histogram bucket size"] = ChunkSizeStatistics::histogram_bucket_size;
+            sizes_obj["Histogram"] = std::move(histogram);
+
+            boost::json::object obj;
+            obj["GB per second"] = chunking_result.gb_per_second;
+            obj["Dedup ratio"] = chunking_result.dedup_ratio;
+            obj["Chunk sizes"] = std::move(sizes_obj);
+            return obj;
+        }
+    }
+
+    namespace chunking {
+        constexpr uint32_t version_size = 8 * 1024 * 1024;     // Размер первой версии сгенерированных данных
+        constexpr uint16_t num_versions = 8;                    // Число версий
+        constexpr uint16_t edits_per_version = 64;              // Число правок в каждой следующей версии
+        constexpr uint32_t max_edit_length = 64;                // Максимальная длина правки
+        // ThreeWiseHash пересчитывает все окно на каждом байте, поэтому запусков меньше, чем в тесте скорости
+        constexpr bench::BenchmarkParameters benchmark_parameters{1, 5};
+    }
+
+    // Создает пустое распределение для чанков не больше max_size байт
+    ChunkSizeStatistics::ChunkSizeStatistics(uint32_t max_size)
+            : max_size(max_size)
+            , histogram(max_size / histogram_bucket_size + 1, 0) {
+    }
+
+    // Добавляет чанк размера size
+    void ChunkSizeStatistics::AddChunk(uint64_t size) {
+        ++num_chunks;
+        num_max_size_chunks += size == max_size;
+        min_chunk_size = std::min(min_chunk_size, size);
+        max_chunk_size = std::max(max_chunk_size, size);
+        sum_sizes += static_cast<double>(size);
+        sum_squared_sizes += static_cast<double>(size) * static_cast<double>(size);
+        ++histogram[std::min<uint64_t>(size / histogram_bucket_size, histogram.size() - 1)];
+    }
+
+    // Возвращает средний размер чанка
+    double ChunkSizeStatistics::Mean() const {
+        return num_chunks == 0 ? 0 : sum_sizes / static_cast<double>(num_chunks);
+    }
+
+    // Возвращает стандартное отклонение размера чанка
+    double ChunkSizeStatistics::StandardDeviation() const {
+        if (num_chunks == 0) {
+            return 0;
+        }
+        const double mean = Mean();
+        return std::sqrt(std::max(sum_squared_sizes / static_cast<double>(num_chunks) - mean * mean, 0.0));
+    }
+
+    // Генерирует несколько версий одного буфера со случайными правками
+    std::string GenerateBackupVersions(pcg64& rng, uint32_t version_size, uint16_t num_versions,
+                                       uint16_t edits_per_version) {
+        enum class Edit {INSERT, ERASE, REPLACE};
+        std::uniform_int_distribution<int> edit_distribution(0, 2);
+        std::uniform_int_distribution<uint32_t> length_distribution(1, chunking::max_edit_length);
+
+        std::string version = GenerateRandomDataBlock(rng, version_size);
+        std::string versions;
+        versions.reserve(static_cast<size_t>(num_versions) * (version_size + edits_per_version * chunking::max_edit_length));
+        for (uint16_t i = 0; i < num_versions; ++i) {
+            if (i != 0) {
+                for (uint16_t j = 0; j < edits_per_version; ++j) {
+                    const uint32_t length = length_distribution(rng);
+                    const size_t pos = std::uniform_int_distribution<size_t>(0, version.size() - length)(rng);
+                    switch (Edit{edit_distribution(rng)}) {
+                        case Edit::INSERT:
+                            version.insert(pos, GenerateRandomDataBlock(rng, length));
+                            break;
+                        case Edit::ERASE:
+                            version.erase(pos, length);
+                            break;
+                        case Edit::REPLACE:
+                            GenerateRandomDataBlock(rng, version.data() + pos, length);
+                            break;
+                    }
+                }
+            }
+            versions += version;
+        }
+        return versions;
+    }
+
+    /*
+     *  Adler32 с перемешанным хеш-значением (финализатор fmix32 из MurmurHash3). Младшие 16 бит
+     *  Adler32 - сумма байтов окна (sum1), в окне из 48 байт она меньше 2^15, поэтому строгая маска
+     *  по младшим битам без перемешивания никогда бы не совпала. fmix32 - биекция, после нее
+     *  младшие биты зависят от обеих сумм
+     */
+    class MixedAdler32 {
+    public:
+        explicit MixedAdler32(int window)
+                : adler32_(window) {
+        }
+
+        void reset() {
+            adler32_.reset();
+            hashvalue = 0;
+        }
+
+        void eat(unsigned char inchar) {
+            adler32_.eat(inchar);
+            hashvalue = Mix(adler32_.hashvalue);
+        }
+
+        void update(unsigned char outchar, unsigned char inchar) {
+            adler32_.update(outchar, inchar);
+            hashvalue = Mix(adler32_.hashvalue);
+        }
+
+        uint32_t hashvalue = 0;
+
+    private:
+        static uint32_t Mix(uint32_t hash) {
+            hash ^= hash >> 16;
+            hash *= 0x85ebca6b;
+            hash ^= hash >> 13;
+            hash *= 0xc2b2ae35;
+            hash ^= hash >> 16;
+            return hash;
+        }
+
+        Adler32 adler32_;
+    };
+
+    /*
+     *  Тестирование разбиения на чанки одним скользящим хешем. Каждый поток данных (файл)
+     *  разбивается отдельно, повторы чанков ищутся во всех потоках. Сначала замеряется только
+     *  разбиение, затем отдельным проходом собирается распределение размеров и уникальные чанки.
+     *  Чанки сравниваются по 64-битному хешу XXH3: вероятность коллизии на миллионах чанков пренебрежимо мала
+     */
+    template<hfl::RollingHashFunction RollingHash>
+    ChunkingResult ChunkingTest(std::string_view name, RollingHash rolling_hash,
+                                const std::vector<std::string_view>& streams,
+                                const hfl::ChunkingParameters& parameters, out::Logger& logger) {
+        hfl::ContentDefinedChunker chunker(std::move(rolling_hash), parameters);
+
+        uint64_t total_bytes = 0;
+        for (const std::string_view stream : streams) {
+            total_bytes += stream.size();
+        }
+
+        const bench::TrialsResult result = bench::RunTrials([&chunker, &streams]() {
+            uint64_t num_chunks = 0;
+            for (const std::string_view stream : streams) {
+                chunker.Split(stream, [&num_chunks](std::string_view) {
+                    ++num_chunks;
+                });
+            }
+            return num_chunks;
+        }, chunking::benchmark_parameters);
+
+        ChunkingResult chunking_result{std::string{name}, 0, ChunkSizeStatistics{parameters.max_size}, 0};
+        chunking_result.gb_per_second = static_cast<double>(total_bytes) / bench::MedianSeconds(result) / 1e9;
+
+        const hfl::wrappers::XXH3_64BitsWrapper fingerprint;
+        std::unordered_set<uint64_t> fingerprints;
+        uint64_t unique_bytes = 0;
+        for (const std::string_view stream : streams) {
+            chunker.Split(stream, [&](std::string_view chunk) {
+                chunking_result.chunk_sizes.AddChunk(chunk.size());
+                if (fingerprints.insert(fingerprint.Hash(chunk)).second) {
+                    unique_bytes += chunk.size();
+                }
+            });
+        }
+        chunking_result.dedup_ratio = unique_bytes == 0 ? 0 : static_cast<double>(total_bytes) / unique_bytes;
+
+        const ChunkSizeStatistics& chunk_sizes = chunking_result.chunk_sizes;
+        logger << boost::format("\t\t%1%: %2% GB/s, chunks: %3% (mean %4%, sd %5%, max-size %6%), dedup ratio: %7%\n")
+                  % chunking_result.name % chunking_result.gb_per_second % chunk_sizes.num_chunks
+                  % chunk_sizes.Mean() % chunk_sizes.StandardDeviation() % chunk_sizes.num_max_size_chunks
+                  % chunking_result.dedup_ratio;
+        return chunking_result;
+    }
+
+    // Тестирование разбиения на чанки всеми скользящими хешами из rolling_hash.
+    // Окно хешей - parameters.window_size байт, хеш-значения 32-битные (GeneralHash поддерживает только 19 бит).
+    // BuzHash и Rabin-Karp используются в вариантах с битностью в параметре шаблона (сдвиги на константы),
+    // GeneralHash - с предвычисленными значениями байтов, которые покидают окно, Adler32 - с перемешанным
+    // хеш-значением (MixedAdler32).
+    // Случайные значения байтов генерируются из постоянных сидов, чтобы границы чанков
+    // не менялись от запуска к запуску
+    boost::json::object ChunkingTests(const std::vector<std::string_view>& streams,
+                                      const hfl::ChunkingParameters& parameters, out::Logger& logger) {
+        const int window_size = static_cast<int>(parameters.window_size);
+        const auto seed1 = static_cast<uint32_t>(SEED_64_1);
+        const auto seed2 = static_cast<uint32_t>(SEED_64_2);
+        const std::vector<ChunkingResult> results{
+            ChunkingTest("BuzHash", CyclicHashBits<uint32_t>(window_size, seed1, seed2), streams, parameters,
+                         logger),
+            ChunkingTest("Rabin-Karp", KarpRabinHashBits<uint32_t>(window_size, seed1, seed2), streams, parameters,
+                         logger),
+            ChunkingTest("ThreeWiseHash", ThreeWiseHash<uint32_t>(window_size, seed1, seed2, 32), streams,
+                         parameters, logger),
+            ChunkingTest("GeneralHash", GeneralHash<CHARPRECOMP, uint32_t>(window_size, seed1, seed2, 19), streams,
+                         parameters, logger),
+            ChunkingTest("Adler32", MixedAdler32(window_size), streams, parameters, logger)
+        };
+
+        boost::json::object hashes_obj;
+        for (const ChunkingResult& chunking_result : results) {
+            hashes_obj[chunking_result.name] = out::ChunkingResultToJson(chunking_result);
+        }
+        return hashes_obj;
+    }
+
+    // Запускает тестирование разбиения на чанки по содержимому
+    void RunChunkingTests(out::Logger& logger) {
+        out::StartAndEndLogTest start_and_end_log(logger, "CHUNKING");
+        const hfl::ChunkingParameters parameters;
+        auto out_json = out::GetChunkingTestJson(parameters, logger);
+
+        // Версии одного буфера: повторы чанков появляются только из-за общего содержимого версий
+        pcg64 rng;
+        const std::string versions = GenerateBackupVersions(rng, chunking::version_size, chunking::num_versions,
+                                                            chunking::edits_per_version);
+        logger << boost::format("\n\tgenerated data (%1% versions, %2% bytes):\n") % chunking::num_versions
+                  % versions.size();
+        boost::json::object generated_obj;
+        generated_obj["Number of versions"] = chunking::num_versions;
+        generated_obj["Version size"] = chunking::version_size;
+        generated_obj["Edits per version"] = chunking::edits_per_version;
+        generated_obj["Bytes"] = versions.size();
+        generated_obj["Hashes"] = ChunkingTests({versions}, parameters, logger);
+        out_json.obj["Generated data"] = std::move(generated_obj);
+
+        // Файлы из каталога data/chunking (например, несколько версий одного архива)
+        const auto files_dir = std::filesystem::current_path() / "data/chunking";
+        if (std::filesystem::is_directory(files_dir)) {
+            std::vector<std::unique_ptr<hfl::MappedFile>> files;
+            std::vector<std::string_view> streams;
+            uint64_t total_bytes = 0;
+            for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(files_dir)) {
+                if (dir_entry.is_regular_file()) {
+                    files.push_back(std::make_unique<hfl::MappedFile>(dir_entry.path()));
+                    streams.push_back(files.back()->GetData());
+                    total_bytes += files.back()->Size();
+                }
+            }
+            logger << boost::format("\n\tfiles (%1% files, %2% bytes):\n") % files.size() % total_bytes;
+            boost::json::object files_obj;
+            files_obj["Number of files"] = files.size();
+            files_obj["Bytes"] = total_bytes;
+            files_obj["Hashes"] = ChunkingTests(streams, parameters, logger);
+            out_json.obj["Files"] = std::move(files_obj);
+        } else {
+            logger << boost::format("\n\tdirectory %1% not found, files are skipped\n") % files_dir.string();
+        }
+
+        out_json.out << out_json.obj;
+    }
+}
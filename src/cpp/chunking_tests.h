@@ -0,0 +1,92 @@
+#ifndef THESIS_WORK_CHUNKING_TESTS_H
+#define THESIS_WORK_CHUNKING_TESTS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/json.hpp>
+#include <pcg_random.hpp>
+
+#include "chunking.h"
+#include "output.h"
+
+namespace tests {
+    namespace out {
+        /*
+         *  Формирует json-файл, в который будет сохранена информация с теста
+         *  разбиения данных на чанки по содержимому
+         *  Входные параметры:
+         *      1. parameters - параметры разбиения
+         *      2. logger - записывает лог в файл и выводит его на консоль
+         */
+        OutputJson GetChunkingTestJson(const hfl::ChunkingParameters& parameters, out::Logger& logger);
+    }
+
+    // Распределение размеров чанков
+    struct ChunkSizeStatistics {
+        // Создает пустое распределение для чанков не больше max_size байт
+        explicit ChunkSizeStatistics(uint32_t max_size);
+
+        // Добавляет чанк размера size
+        void AddChunk(uint64_t size);
+
+        // Возвращает средний размер чанка
+        [[nodiscard]] double Mean() const;
+
+        // Возвращает стандартное отклонение размера чанка
+        [[nodiscard]] double StandardDeviation() const;
+
+        static constexpr uint32_t histogram_bucket_size = 1024; // Ширина столбца гистограммы (байт)
+
+        uint32_t max_size;                                      // Максимальный размер чанка
+        uint64_t num_chunks = 0;                                // Число чанков
+        uint64_t num_max_size_chunks = 0;                       // Число чанков размера max_size (обрезанных)
+        uint64_t min_chunk_size = std::numeric_limits<uint64_t>::max();
+        uint64_t max_chunk_size = 0;
+        double sum_sizes = 0;                                   // Сумма размеров
+        double sum_squared_sizes = 0;                           // Сумма квадратов размеров
+        std::vector<uint64_t> histogram;                        // Число чанков в столбцах по histogram_bucket_size байт
+    };
+
+    // Результаты разбиения данных одним скользящим хешем
+    struct ChunkingResult {
+        std::string name;
+        double gb_per_second = 0;           // Скорость разбиения (ГБ/с)
+        ChunkSizeStatistics chunk_sizes;    // Распределение размеров чанков
+        double dedup_ratio = 0;             // Объем данных, деленный на объем уникальных чанков
+    };
+
+    namespace out {
+        // Переводит результаты разбиения одним скользящим хешем в json
+        boost::json::object ChunkingResultToJson(const ChunkingResult& chunking_result);
+    }
+
+    /*
+     *  Генерирует данные, похожие на поток резервного копирования: несколько версий одного буфера,
+     *  записанных подряд. Каждая версия получается из предыдущей случайными правками
+     *  (вставка, удаление или замена нескольких байт), которые сдвигают остальные данные
+     *  Входные параметры:
+     *      1. rng - генератор PCG-64
+     *      2. version_size - размер первой версии
+     *      3. num_versions - число версий
+     *      4. edits_per_version - число правок в каждой следующей версии
+     *  Выходное значение: все версии подряд
+     */
+    std::string GenerateBackupVersions(pcg64& rng, uint32_t version_size, uint16_t num_versions,
+                                       uint16_t edits_per_version);
+
+    /*
+     *  Запускает тестирование разбиения на чанки по содержимому скользящими хешами из rolling_hash
+     *  (BuzHash, Rabin-Karp, ThreeWiseHash, GeneralHash, Adler32) на сгенерированных данных
+     *  и на файлах из каталога data/chunking (если он есть)
+     *  Входной параметр: logger - записывает лог в файл и выводит его на консоль
+     */
+    void RunChunkingTests(out::Logger& logger);
+}
+
+#endif //THESIS_WORK_CHUNKING_TESTS_H
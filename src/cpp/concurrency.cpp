@@ -0,0 +1,184 @@
+#include "concurrency.h"
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace {
+    // Признак того, что поток выполняет задачу пула (вложенные вызовы Broadcast выполняются последовательно)
+    thread_local bool inside_pool_job = false;
+
+    // Выполняет задачу пула, отмечая поток как занятый задачей
+    void RunJob(const ThreadPool::Job& job, uint16_t thread_index) {
+        const bool was_inside = inside_pool_job;
+        inside_pool_job = true;
+        job(thread_index);
+        inside_pool_job = was_inside;
+    }
+
+    // Доля диапазона, принадлежащая одному потоку. Выровнена по кэш-линии,
+    // чтобы захват частей разными потоками не вызывал ложного разделения
+    struct alignas(64) WorkRange {
+        std::mutex mutex;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+    };
+
+    // Число частей на поток, если размер части выбирается автоматически
+    constexpr uint64_t chunks_per_thread = 8;
+}
+
+// Запускает num_threads - 1 потоков (еще один поток - вызывающий)
+ThreadPool::ThreadPool(uint16_t num_threads) {
+    BOOST_ASSERT_MSG(num_threads > 0, "Number of threads must be positive");
+    workers_.reserve(num_threads - 1);
+    for (uint16_t i = 1; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+// Завершает потоки пула
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+// Возвращает общий пул процесса
+ThreadPool& ThreadPool::GetInstance() {
+    static ThreadPool pool(GetNumThreads());
+    return pool;
+}
+
+// Возвращает число потоков (вместе с вызывающим)
+uint16_t ThreadPool::Size() const {
+    return static_cast<uint16_t>(workers_.size() + 1);
+}
+
+// Выполняет job(i) для всех i из [0, num_threads) и ждет завершения
+void ThreadPool::Broadcast(uint16_t num_threads, const Job& job) {
+    BOOST_ASSERT_MSG(num_threads <= Size(), "Not enough threads in the pool");
+    if (num_threads <= 1 || inside_pool_job) {
+        for (uint16_t i = 0; i < num_threads; ++i) {
+            RunJob(job, i);
+        }
+        return;
+    }
+
+    std::lock_guard broadcast_lock(broadcast_mutex_);
+    {
+        std::lock_guard lock(mutex_);
+        job_ = &job;
+        num_job_threads_ = num_threads;
+        num_running_ = num_threads - 1;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    RunJob(job, 0);
+
+    std::unique_lock lock(mutex_);
+    done_cv_.wait(lock, [this] { return num_running_ == 0; });
+    job_ = nullptr;
+}
+
+// Возвращает true, если вызывающий поток выполняет задачу пула
+bool ThreadPool::IsInsidePoolJob() {
+    return inside_pool_job;
+}
+
+// Цикл потока пула
+void ThreadPool::WorkerLoop(uint16_t thread_index) {
+    uint64_t last_generation = 0;
+    for (;;) {
+        const Job* job = nullptr;
+        {
+            std::unique_lock lock(mutex_);
+            start_cv_.wait(lock, [this, last_generation] { return stop_ || generation_ != last_generation; });
+            if (stop_) {
+                return;
+            }
+            last_generation = generation_;
+            if (thread_index >= num_job_threads_) {
+                continue;
+            }
+            job = job_;
+        }
+
+        RunJob(*job, thread_index);
+
+        std::lock_guard lock(mutex_);
+        if (--num_running_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+namespace detail {
+    // Выполняет task для частей диапазона [begin, end) в потоках общего пула
+    void RunRanges(uint64_t begin, uint64_t end, uint64_t grain, uint16_t num_threads, const RangeTask& task) {
+        if (begin >= end) {
+            return;
+        }
+        ThreadPool& pool = ThreadPool::GetInstance();
+        const uint64_t size = end - begin;
+        num_threads = std::clamp<uint16_t>(num_threads, 1, pool.Size());
+        if (grain == 0) {
+            grain = std::max<uint64_t>(size / (num_threads * chunks_per_thread), 1);
+        }
+        // Потоков не больше, чем частей
+        num_threads = static_cast<uint16_t>(std::min<uint64_t>(num_threads, (size + grain - 1) / grain));
+
+        // Начальное разбиение диапазона на равные доли
+        std::vector<WorkRange> ranges(num_threads);
+        const uint64_t share = size / num_threads;
+        for (uint16_t i = 0; i < num_threads; ++i) {
+            ranges[i].begin = begin + share * i;
+            ranges[i].end = (i + 1 == num_threads) ? end : begin + share * (i + 1);
+        }
+
+        pool.Broadcast(num_threads, [&ranges, &task, grain, num_threads](uint16_t thread_index) {
+            WorkRange& own = ranges[thread_index];
+            for (;;) {
+                uint64_t first = 0;
+                uint64_t last = 0;
+                {   // Часть из начала своей доли
+                    std::lock_guard lock(own.mutex);
+                    first = own.begin;
+                    last = std::min(own.end, first + grain);
+                    own.begin = last;
+                }
+                if (first < last) {
+                    task(thread_index, first, last);
+                    continue;
+                }
+
+                // Своя доля закончилась: кража половины остатка (с конца) у первого потока с непустой долей
+                for (uint16_t i = 1; i < num_threads && first == last; ++i) {
+                    WorkRange& victim = ranges[(thread_index + i) % num_threads];
+                    std::lock_guard lock(victim.mutex);
+                    const uint64_t remaining = victim.end - victim.begin;
+                    if (remaining > 0) {
+                        const uint64_t stolen = (remaining <= grain) ? remaining : remaining / 2;
+                        first = victim.end - stolen;
+                        last = victim.end;
+                        victim.end = first;
+                    }
+                }
+                if (first == last) {
+                    return;
+                }
+
+                // Украденная часть становится своей долей, чтобы ее могли красть другие потоки
+                std::lock_guard lock(own.mutex);
+                own.begin = first;
+                own.end = last;
+            }
+        });
+    }
+}
@@ -1,7 +1,10 @@
 #ifndef THESIS_WORK_CONCURRENCY_H
 #define THESIS_WORK_CONCURRENCY_H
 
-#include <future>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -11,115 +14,123 @@ static inline uint16_t GetNumThreads() {
     return hardware_threads != 0 ? hardware_threads : 1;
 }
 
-// Класс, в котором запускаются функции в разных потоках.
-// ResultType - возвращаемое значение для функции, которая запускается в отдельном потоке
-template<typename ResultType>
-class ThreadTasks {
-    // Функция запускаемая, в отдельном потоке
-    using TaskFunction = std::function<ResultType(uint64_t, uint64_t)>;
-    // Функция, которая объединяет информацию полученную из разных потоков
-    using MergeResultFunction = std::function<void(ResultType&, const ResultType&)>;
-    // Фьючерс, в который будет записан результат выполнения функции запущенной в отдельном потоке
-    using Future = std::future<ResultType>;
-    // Обертка над функцией запускаемой, в отдельном потоке.
-    // Необходима для получения фьючерса (Future)
-    using PackagedTask = std::packaged_task<ResultType(uint64_t, uint64_t)>;
-
+/*
+ *  Пул потоков, которые создаются один раз и переиспользуются всеми тестами (по образцу
+ *  highwayhash::ThreadPool из highwayhash/data_parallel.h). Поток, вызвавший Broadcast,
+ *  выполняет задачу с индексом 0, потоки пула - задачи с индексами 1, 2, ...
+ */
+class ThreadPool {
 public:
-    ThreadTasks(const ThreadTasks&) = delete;
-    ThreadTasks(ThreadTasks&&) = default;
-
-    ThreadTasks& operator=(const ThreadTasks&) = delete;
-    ThreadTasks& operator=(ThreadTasks&&) = default;
-
-    // Конструктор, который запускает выполнение функций (task) в разных потоках
-    ThreadTasks(TaskFunction task, MergeResultFunction merge_results, uint16_t num_threads, size_t num_iterations)
-        : task_(task)
-        , merge_results_(merge_results)
-        , num_par_threads_(num_threads - 1)
-        , num_iterations_(num_iterations)
-        , block_size_(num_iterations / num_threads) {
-        StartThreads();
-    }
+    // Задача, которая получает индекс потока
+    using Job = std::function<void(uint16_t)>;
 
-    // Возвращает объединенный результат вычисления из всех потокв
-    ResultType GetResult()  {
-        for(size_t i = 0; i < num_par_threads_; ++i) {
-            auto current_result = futures_[i].get();
-            merge_results_(result_, current_result);
-        }
-        return result_;
-    }
+    // Запускает num_threads - 1 потоков (еще один поток - вызывающий)
+    explicit ThreadPool(uint16_t num_threads);
 
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
 
-private:
-    // который запускает выполнение функций (task) в разных потоках
-    void StartThreads()  {
-        for (uint64_t i = 0; i < num_par_threads_; ++i) {
-            PackagedTask current_task(task_);
-            futures_.emplace_back(std::move(current_task.get_future()));
-            threads_.emplace_back(std::move(current_task), 0, block_size_);
-        }
-
-        const uint64_t last_block_size = num_iterations_ - block_size_ * num_par_threads_;
-        result_ = task_(0, last_block_size);
-    }
+    // Завершает потоки пула
+    ~ThreadPool();
 
-    TaskFunction task_;                 // Функция, которая запускается в отдельном потоке
-    MergeResultFunction merge_results_; // Функция, которая объединяет результаты вычисления из разных потоков
-    uint16_t num_par_threads_;          // Число потоков
-    size_t num_iterations_;             // Число итераций для всех потоков
-    size_t block_size_;                 // Размер блока, запускаемого в отдельном потоке
-    std::vector<Future> futures_;       // Фьючерсы, в которые будут записаны результаты выполнения потоков
-    std::vector<std::jthread> threads_; // Потоки выполнения
-    ResultType result_;                 // Общий результат выполнения всех потоков
-};
+    // Возвращает общий пул процесса из GetNumThreads() потоков
+    static ThreadPool& GetInstance();
 
+    // Возвращает число потоков (вместе с вызывающим)
+    [[nodiscard]] uint16_t Size() const;
 
-// Специализация ThreadTasks, потоки в которой ничего не возвращают
-template<>
-class ThreadTasks<void> {
-    using TaskFunction = std::function<void(uint64_t, uint64_t)>;
+    /*
+     *  Выполняет job(i) для всех i из [0, num_threads), каждый индекс - в своем потоке, и ждет завершения.
+     *  Все задачи выполняются одновременно, поэтому они могут синхронизироваться барьером.
+     *  Вызов из задачи пула выполняет задачи последовательно в вызывающем потоке
+     *  (такие задачи не должны ждать друг друга)
+     *  Входные параметры:
+     *      1. num_threads - число задач (не больше Size())
+     *      2. job - задача
+     */
+    void Broadcast(uint16_t num_threads, const Job& job);
 
-public:
-    ThreadTasks(const ThreadTasks&) = delete;
-    ThreadTasks(ThreadTasks&&) = default;
-
-    ThreadTasks& operator=(const ThreadTasks&) = delete;
-    ThreadTasks& operator=(ThreadTasks&&) = default;
-
-    ThreadTasks(TaskFunction task, uint16_t num_threads, size_t num_iterations)
-            : task_(task)
-            , num_par_threads_(num_threads - 1)
-            , num_iterations_(num_iterations)
-            , block_size_(num_iterations / num_threads)
-            , threads_(num_par_threads_){
-        StartThreads();
-        JoinThreads();
-    }
+    // Возвращает true, если вызывающий поток выполняет задачу пула (Broadcast выполнит задачи последовательно)
+    static bool IsInsidePoolJob();
 
 private:
-    void StartThreads()  {
-        uint64_t start_block = 0;
-        for (auto& t : threads_) {
-            uint64_t end_block = start_block + block_size_;
-            t = std::thread(task_, start_block, end_block);
-            start_block = end_block;
-        }
-        task_(start_block, num_iterations_);
-    }
+    // Цикл потока пула: ожидание задачи, выполнение, сообщение о завершении
+    void WorkerLoop(uint16_t thread_index);
+
+    std::vector<std::thread> workers_;      // Потоки пула
+
+    std::mutex broadcast_mutex_;            // Упорядочивает одновременные вызовы Broadcast
+    std::mutex mutex_;                      // Защищает поля ниже
+    std::condition_variable start_cv_;      // Сигнал о новой задаче или о завершении пула
+    std::condition_variable done_cv_;       // Сигнал о том, что все потоки выполнили задачу
+    const Job* job_ = nullptr;              // Текущая задача
+    uint16_t num_job_threads_ = 0;          // Число потоков, которые выполняют текущую задачу
+    uint16_t num_running_ = 0;              // Число потоков пула, которые еще не выполнили задачу
+    uint64_t generation_ = 0;               // Номер текущей задачи
+    bool stop_ = false;                     // Флаг завершения пула
+};
 
-    void JoinThreads() {
-        for (auto& t : threads_) {
-            t.join();
-        }
-    }
+namespace detail {
+    // Задача для части диапазона: индекс потока, начало и конец части
+    using RangeTask = std::function<void(uint16_t, uint64_t, uint64_t)>;
+
+    /*
+     *  Выполняет task для частей диапазона [begin, end) в потоках общего пула.
+     *  Диапазон делится поровну между потоками, каждый поток берет из своей доли части по grain элементов,
+     *  а закончив свою долю, крадет половину остатка доли другого потока (work stealing)
+     *  Входные параметры:
+     *      1. begin, end - диапазон индексов
+     *      2. grain - размер части (0 - выбирается автоматически)
+     *      3. num_threads - число потоков (ограничивается размером пула)
+     *      4. task - задача
+     */
+    void RunRanges(uint64_t begin, uint64_t end, uint64_t grain, uint16_t num_threads, const RangeTask& task);
+}
 
-    TaskFunction task_;
-    uint16_t num_par_threads_;
-    size_t num_iterations_;
-    size_t block_size_;
-    std::vector<std::thread> threads_;
-};
+/*
+ *  Выполняет function(first, last) для частей диапазона [begin, end) в потоках общего пула
+ *  Входные параметры:
+ *      1. begin, end - диапазон индексов
+ *      2. grain - размер части (0 - выбирается автоматически)
+ *      3. function - функция, которая обрабатывает часть [first, last)
+ *      4. num_threads - число потоков
+ */
+template<typename Function>
+void ParallelFor(uint64_t begin, uint64_t end, uint64_t grain, const Function& function,
+                 uint16_t num_threads = GetNumThreads()) {
+    detail::RunRanges(begin, end, grain, num_threads, [&function](uint16_t, uint64_t first, uint64_t last) {
+        function(first, last);
+    });
+}
+
+/*
+ *  Выполняет task(result, first, last) для частей диапазона [begin, end) в потоках общего пула.
+ *  У каждого потока свой результат, который в начале равен identity. В конце результаты
+ *  объединяются функцией merge(result, other) в порядке индексов потоков
+ *  Параметр шаблона: ResultType - тип результата
+ *  Входные параметры:
+ *      1. begin, end - диапазон индексов
+ *      2. grain - размер части (0 - выбирается автоматически)
+ *      3. identity - начальное значение результата
+ *      4. task - функция, которая добавляет к результату потока часть [first, last)
+ *      5. merge - функция, которая объединяет результаты потоков
+ *      6. num_threads - число потоков
+ *  Выходное значение: объединенный результат
+ */
+template<typename ResultType, typename Task, typename Merge>
+ResultType ParallelReduce(uint64_t begin, uint64_t end, uint64_t grain, const ResultType& identity,
+                          const Task& task, const Merge& merge, uint16_t num_threads = GetNumThreads()) {
+    std::vector<ResultType> results(num_threads, identity);
+    detail::RunRanges(begin, end, grain, num_threads,
+                      [&results, &task](uint16_t thread_index, uint64_t first, uint64_t last) {
+        task(results[thread_index], first, last);
+    });
+
+    ResultType result = std::move(results[0]);
+    for (size_t i = 1; i < results.size(); ++i) {
+        merge(result, results[i]);
+    }
+    return result;
+}
 
 #endif //THESIS_WORK_CONCURRENCY_H
@@ -1,5 +1,85 @@
 #include "count_collisions.h"
 
+#include <algorithm>
+#include <array>
+
+#include <boost/assert.hpp>
+
+#include "concurrency.h"
+
+namespace {
+    // Число бит в разряде поразрядной сортировки и число корзин
+    constexpr uint16_t radix_bits = 8;
+    constexpr size_t num_buckets = 1ull << radix_bits;
+
+    // Массивы меньшего размера сортируются std::sort (поразрядная сортировка не окупается)
+    constexpr size_t min_radix_sort_size = 1ull << 16;
+
+    // Параллельная поразрядная сортировка (LSD). Каждый поток обрабатывает свой непрерывный
+    // диапазон массива, а смещения корзин распределяются по порядку потоков, поэтому
+    // каждый проход устойчив
+    void RadixSort(std::vector<uint64_t>& values, uint16_t num_threads) {
+        const size_t size = values.size();
+        ThreadPool& pool = ThreadPool::GetInstance();
+        num_threads = std::min(num_threads, pool.Size());
+
+        // Разряды, одинаковые у всех значений, не меняют порядок. Для 16-64-битных хешей
+        // старшие байты часто нулевые, и их проходы пропускаются
+        uint64_t all_or = 0;
+        uint64_t all_and = ~0ull;
+        for (const uint64_t value : values) {
+            all_or |= value;
+            all_and &= value;
+        }
+        const uint64_t varying_bits = all_or ^ all_and;
+
+        const size_t block_size = (size + num_threads - 1) / num_threads;
+        auto block_begin = [block_size, size](uint16_t thread_index) {
+            return std::min(block_size * thread_index, size);
+        };
+        auto block_end = [block_size, size](uint16_t thread_index) {
+            return std::min(block_size * (thread_index + 1), size);
+        };
+
+        std::vector<uint64_t> buffer(size);
+        std::vector<std::array<size_t, num_buckets>> offsets(num_threads);
+        for (uint16_t shift = 0; shift < 64; shift += radix_bits) {
+            if (((varying_bits >> shift) & (num_buckets - 1)) == 0) {
+                continue;
+            }
+
+            // Гистограммы разрядов в диапазонах потоков
+            pool.Broadcast(num_threads, [&](uint16_t thread_index) {
+                std::array<size_t, num_buckets>& counts = offsets[thread_index];
+                counts.fill(0);
+                for (size_t i = block_begin(thread_index); i < block_end(thread_index); ++i) {
+                    ++counts[(values[i] >> shift) & (num_buckets - 1)];
+                }
+            });
+
+            // Префиксные суммы: корзина за корзиной, внутри корзины - поток за потоком
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < num_buckets; ++bucket) {
+                for (std::array<size_t, num_buckets>& counts : offsets) {
+                    const size_t count = counts[bucket];
+                    counts[bucket] = offset;
+                    offset += count;
+                }
+            }
+
+            // Раскладка значений по корзинам
+            pool.Broadcast(num_threads, [&](uint16_t thread_index) {
+                std::array<size_t, num_buckets>& positions = offsets[thread_index];
+                for (size_t i = block_begin(thread_index); i < block_end(thread_index); ++i) {
+                    const uint64_t value = values[i];
+                    buffer[positions[(value >> shift) & (num_buckets - 1)]++] = value;
+                }
+            });
+
+            values.swap(buffer);
+        }
+    }
+}
 
 // Вычисляет число коллизий
 uint64_t CountCollisions(const std::map<uint64_t, uint64_t>& hash_values) {
@@ -9,4 +89,20 @@ uint64_t CountCollisions(const std::map<uint64_t, uint64_t>& hash_values) {
         collisions += tmp;
     }
     return collisions;
-}
\ No newline at end of file
+}
+
+// Вычисляет число коллизий в плоском массиве хеш-значений
+uint64_t CountCollisions(std::vector<uint64_t> hash_values, uint16_t num_threads) {
+    BOOST_ASSERT_MSG(num_threads > 0, "Number of threads must be positive");
+    if (hash_values.size() < min_radix_sort_size) {
+        std::sort(hash_values.begin(), hash_values.end());
+    } else {
+        RadixSort(hash_values, num_threads);
+    }
+
+    uint64_t collisions = 0;
+    for (size_t i = 1; i < hash_values.size(); ++i) {
+        collisions += (hash_values[i] == hash_values[i - 1]);
+    }
+    return collisions;
+}
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <map>
+#include <vector>
 
 /*
  *  Вычисляет число коллизий
@@ -12,4 +13,16 @@
  */
 uint64_t CountCollisions(const std::map<uint64_t, uint64_t>& hash_values);
 
+/*
+ *  Вычисляет число коллизий в плоском массиве хеш-значений.
+ *  Массив сортируется параллельной поразрядной сортировкой (LSD, разряд - 1 байт; байты,
+ *  одинаковые у всех значений, пропускаются), затем подсчитываются соседние повторы.
+ *  Дополнительная память - один буфер размера массива, поэтому подходит для сотен миллионов ключей
+ *  Входные параметры:
+ *      1. hash_values - хеш-значения (передаются по значению, так как сортируются)
+ *      2. num_threads - число потоков сортировки
+ *  Выходной параметр: число коллизий (число значений минус число различных значений)
+ */
+uint64_t CountCollisions(std::vector<uint64_t> hash_values, uint16_t num_threads = 1);
+
 #endif //THESIS_WORK_COUNT_COLLISIONS_H
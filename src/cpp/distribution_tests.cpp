@@ -1,5 +1,6 @@
 #include "distribution_tests.h"
 
+#include <bit>
 #include <span>
 
 namespace tests {
@@ -86,7 +87,7 @@ namespace tests {
             auto lambda = [this](uint64_t start_bar, uint64_t end_bar) {
                 this->CollectingStatistics(start_bar, end_bar);
             };
-            ThreadTasks<void> thread_tasks(lambda, parameters_.num_threads, num_bars);
+            ParallelFor(0, num_bars, 1, lambda, parameters_.num_threads);
         }
 
         // Собирает информацию
@@ -172,7 +173,10 @@ namespace tests {
         out::OutputJson GetDistTestJson(const DistTestParameters& parameters, const std::string& hash_name,
                                         out::Logger& logger) {
             using namespace std::literals;
-            const std::filesystem::path check_dist_dir = "Distribution tests";
+            // Результаты подсчета общим массивом атомарных счетчиков сохраняются в отдельный каталог
+            const std::filesystem::path check_dist_dir = parameters.strategy == CountingStrategy::PARTITIONED
+                    ? "Distribution tests"s
+                    : "Distribution tests ("s + CountingStrategyToString(parameters.strategy) + ")";
             const std::filesystem::path hash_bits_dir = std::to_string(parameters.hash_bits);
             const std::filesystem::path report_name = hash_name + " with "s + TestFlagToString(parameters.mode) + " mode.json";
             const auto hash_bits_path = logger.GetLogDirPath() / check_dist_dir / hash_bits_dir;
@@ -204,9 +208,13 @@ namespace tests {
     namespace out {
         // Сохраняет результаты тестов в json файл
         void SaveReport(const std::vector<std::atomic<Bucket>>& buckets, const DistTestParameters& parameters,
-                        const std::string& hash_name, out::Logger& logger) {
+                        const std::string& hash_name, double keys_per_second, out::Logger& logger) {
             auto out_json = GetDistTestJson(parameters, hash_name, logger);
             out_json.obj = ProcessingStatistics(buckets, parameters, hash_name);
+            out_json.obj["Counting strategy"] = CountingStrategyToString(parameters.strategy);
+            out_json.obj["Keys per second"] = keys_per_second;
+            logger << boost::format("\t\tkeys per second (%1%): %2%\n")
+                      % CountingStrategyToString(parameters.strategy) % keys_per_second;
             PrintDistributionTestLog(out_json.obj, logger);
             out_json.out << out_json.obj;
         }
@@ -233,22 +241,90 @@ namespace tests {
         return buckets_;
     }
 
+    PartitionedDistributionHashes::PartitionedDistributionHashes(size_t num_buckets, uint16_t num_threads)
+        : buckets_(num_buckets)
+        , num_threads_(num_threads)
+        , staging_(num_threads) {
+        BOOST_ASSERT_MSG(num_buckets > 0, "num_buckets == 0");
+        // Номер раздела - старшие биты индекса счетчика. Число разделов не больше числа счетчиков
+        const auto index_bits = static_cast<uint16_t>(std::bit_width(num_buckets - 1));
+        const uint16_t partition_bits = std::min(max_partition_bits, index_bits);
+        partition_shift_ = index_bits - partition_bits;
+        num_partitions_ = 1ull << partition_bits;
+
+        for (StagingBuffer& staging : staging_) {
+            staging.values.reserve(max_staging_size);
+            staging.offsets.resize(num_partitions_ + 1);
+            staging.positions.resize(num_partitions_);
+        }
+    }
+
+    // Раскладывает хеш-значения потока thread_index по разделам (сортировка подсчетом по номеру раздела)
+    void PartitionedDistributionHashes::AddHashes(uint16_t thread_index, std::span<const uint64_t> hash_values) {
+        BOOST_ASSERT_MSG(hash_values.size() <= max_staging_size, "hash_values.size() > max_staging_size");
+        StagingBuffer& staging = staging_[thread_index];
+
+        // Подсчет размеров разделов
+        std::ranges::fill(staging.offsets, 0);
+        for (const uint64_t hash_value : hash_values) {
+            ++staging.offsets[GetPartition(hash_value) + 1];
+        }
+        std::partial_sum(staging.offsets.begin(), staging.offsets.end(), staging.offsets.begin());
+
+        // Раскладка хеш-значений по разделам
+        std::copy(staging.offsets.begin(), staging.offsets.end() - 1, staging.positions.begin());
+        staging.values.resize(hash_values.size());
+        for (const uint64_t hash_value : hash_values) {
+            staging.values[staging.positions[GetPartition(hash_value)]++] = hash_value;
+        }
+    }
+
+    // Переносит в счетчики хеш-значения из разделов, которые принадлежат потоку thread_index.
+    // Раздел partition принадлежит потоку partition % num_threads_
+    void PartitionedDistributionHashes::Flush(uint16_t thread_index) {
+        for (size_t partition = thread_index; partition < num_partitions_; partition += num_threads_) {
+            for (const StagingBuffer& staging : staging_) {
+                const auto first = static_cast<ptrdiff_t>(staging.offsets[partition]);
+                const auto last = static_cast<ptrdiff_t>(staging.offsets[partition + 1]);
+                for (auto it = staging.values.begin() + first; it != staging.values.begin() + last; ++it) {
+                    // Счетчик изменяет только один поток, поэтому CAS не нужен
+                    std::atomic<Bucket>& current_bucket = buckets_[*it];
+                    const Bucket old_bucket = current_bucket.load(std::memory_order_relaxed);
+                    if (old_bucket != DistributionHashes::max_bucket) {
+                        current_bucket.store(old_bucket + 1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    }
+
+    // Возвращает вектор хеш-значений
+    const std::vector<std::atomic<Bucket>>& PartitionedDistributionHashes::GetBuckets() const {
+        return buckets_;
+    }
+
+    // Возвращает номер раздела для хеш-значения
+    size_t PartitionedDistributionHashes::GetPartition(uint64_t hash_value) const {
+        return hash_value >> partition_shift_;
+    }
+
     // Запускает тестирование распределительных свойств
     // всех хеш функций одной битности
     template<hfl::UnsignedIntegral UintT>
-    static void RunDistributionTestsImpl(uint16_t num_threads, out::Logger& logger) {
-        constexpr uint16_t bits = std::numeric_limits<UintT>::digits;
-        const auto hashes = hfl::BuildHashes<UintT>();
+    static void RunDistributionTestsImpl(uint16_t num_threads, CountingStrategy strategy, out::Logger& logger) {
+        constexpr uint16_t bits = hfl::hash_bits_v<UintT>;
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
 
-        if constexpr(std::is_same_v<UintT, uint64_t>) {
-            const uint64_t num_keys_and_buckets = 1ull << (bits - 32);
+        // 64 и 128-битные хеш-значения подсчитываются по 2^32 бинам
+        if constexpr(bits >= bits64) {
+            const uint64_t num_keys_and_buckets = 1ull << 32;
             const DistTestParameters parameters{bits, num_threads, num_keys_and_buckets, num_keys_and_buckets,
-                                                TestFlag::BINS};
+                                                TestFlag::BINS, strategy};
             DistributionTest(hashes, parameters, logger);
         } else {
             const uint64_t num_keys_and_buckets = 1ull << bits;
             const DistTestParameters parameters{bits, num_threads, num_keys_and_buckets, num_keys_and_buckets,
-                                                TestFlag::NORMAL};
+                                                TestFlag::NORMAL, strategy};
             DistributionTest(hashes, parameters, logger);
         }
     }
@@ -260,8 +336,13 @@ namespace tests {
         const uint16_t num_threads = GetNumThreads();
         logger << boost::format("\tnum_threads = %1%\n\n") % num_threads;
 
-        RunDistributionTestsImpl<uint16_t>(num_threads, logger);
-        RunDistributionTestsImpl<uint32_t>(num_threads, logger);
-        RunDistributionTestsImpl<uint64_t>(num_threads, logger);
+        RunDistributionTestsImpl<uint16_t>(num_threads, CountingStrategy::PARTITIONED, logger);
+        RunDistributionTestsImpl<uint32_t>(num_threads, CountingStrategy::PARTITIONED, logger);
+        RunDistributionTestsImpl<uint64_t>(num_threads, CountingStrategy::PARTITIONED, logger);
+        RunDistributionTestsImpl<hfl::uint128_t>(num_threads, CountingStrategy::PARTITIONED, logger);
+
+        // 32-битные хеш функции подсчитываются еще и общим массивом атомарных счетчиков,
+        // чтобы сравнить пропускную способность (keys per second) двух способов подсчета
+        RunDistributionTestsImpl<uint32_t>(num_threads, CountingStrategy::ATOMIC, logger);
     }
 }
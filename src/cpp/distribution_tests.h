@@ -1,14 +1,20 @@
 #ifndef THESIS_WORK_CHECK_DISTRIBUTION_H
 #define THESIS_WORK_CHECK_DISTRIBUTION_H
 
+#include <algorithm>
 #include <atomic>
+#include <barrier>
+#include <chrono>
 #include <concepts>
 #include <iostream>
+#include <numeric>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
 
 
+#include <boost/assert.hpp>
 #include <boost/format.hpp>
 
 #include "concurrency.h"
@@ -26,16 +32,17 @@ namespace tests {
          *  Входные параметры:
          *      1. buckets - массив счетчиков хеш-значений
          *      2. parameters - параметры тестирования:
-         *          - битность хеша (16, 32 или 64)
+         *          - битность хеша (16, 32, 64 или 128)
          *          - число потоков (зависит от системы)
          *          - число ключей (целое положительное число)
          *          - размер массива buckets
          *          - флаг тестирования: NORMAL или BINS
          *      3. hash_name - название хеш функции
-         *      4. logger - записывает лог в файл и выводит его на консоль
+         *      4. keys_per_second - пропускная способность подсчета (число ключей в секунду)
+         *      5. logger - записывает лог в файл и выводит его на консоль
          */
         void SaveReport(const std::vector<std::atomic<Bucket>>& buckets, const DistTestParameters& parameters,
-                        const std::string& hash_name, out::Logger& logger);
+                        const std::string& hash_name, double keys_per_second, out::Logger& logger);
     }
 
     // Класс, в котором хранятся хеш-значения
@@ -55,37 +62,112 @@ namespace tests {
         std::vector<std::atomic<Bucket>> buckets_; // Массив счетчиков хеш-значений
     };
 
+    /*
+     *  Класс, в котором хранятся хеш-значения. Подсчет идет без атомарных операций в два этапа:
+     *      1. AddHashes - каждый поток раскладывает свои хеш-значения по разделам (старшие биты индекса
+     *         счетчика) в собственный буфер, который помещается в кэш
+     *      2. Flush - каждый поток переносит в счетчики значения своих разделов из буферов всех потоков.
+     *         Разделы разных потоков не пересекаются, поэтому счетчики изменяются обычными load/store
+     *  Между этапами потоки должны синхронизироваться (например, с помощью std::barrier)
+     */
+    class PartitionedDistributionHashes {
+    public:
+        // Максимальное число хеш-значений, которое поток добавляет за один вызов AddHashes
+        static constexpr size_t max_staging_size = 1ull << 15;
+
+        PartitionedDistributionHashes(size_t num_buckets, uint16_t num_threads);
+
+        // Раскладывает хеш-значения потока thread_index по разделам
+        void AddHashes(uint16_t thread_index, std::span<const uint64_t> hash_values);
+
+        // Переносит в счетчики хеш-значения из разделов, которые принадлежат потоку thread_index
+        void Flush(uint16_t thread_index);
+
+        // Возвращает вектор хеш-значений
+        [[nodiscard]] const std::vector<std::atomic<Bucket>>& GetBuckets() const;
+
+    private:
+        // Буфер потока, в котором хеш-значения сгруппированы по разделам
+        struct StagingBuffer {
+            std::vector<uint64_t> values;   // хеш-значения, упорядоченные по разделам
+            std::vector<size_t> offsets;    // начало каждого раздела в values (+ конец последнего)
+            std::vector<size_t> positions;  // текущие позиции записи при раскладке
+        };
+
+        // Возвращает номер раздела для хеш-значения
+        [[nodiscard]] size_t GetPartition(uint64_t hash_value) const;
+
+        static constexpr uint16_t max_partition_bits = 8;
+
+        std::vector<std::atomic<Bucket>> buckets_;  // Массив счетчиков хеш-значений
+        uint16_t num_threads_;                      // Число потоков
+        uint16_t partition_shift_;                  // Сдвиг, который выделяет номер раздела из хеш-значения
+        size_t num_partitions_;                     // Число разделов
+        std::vector<StagingBuffer> staging_;        // Буферы потоков
+    };
 
     /*
-     * Тестирование распределительных свойств одной хеш функции. Реализация описана ниже
+     * Хеширует числа и записывает в hash_values хеш-значения, измененные в соответствии с флагом тестирования
      *      1. hash - хеш-функция
-     *      2. parameters - параметры тестирования:
-     *          - битность хеша (16, 32 или 64)
+     *      2. parameters - параметры тестирования
+     *      3. numbers - хешируемые числа
+     *      4. hash_values - массив, в который записываются хеш-значения (размер равен numbers.size())
+     */
+    template<hfl::HashFunction HashType>
+    void HashNumbers(const HashType& hash, const DistTestParameters& parameters, std::span<const uint64_t> numbers,
+                     std::span<uint64_t> hash_values);
+
+    /*
+     * Функции подсчета хеш-значений группы хеш функций разными способами (CountingStrategy) за один
+     * совмещенный проход: каждый пакет чисел формируется один раз и хешируется всеми хеш функциями группы.
+     * Возвращают пропускную способность подсчета каждой хеш функции группы (число ключей в секунду)
+     *      1. hashes - набор хеш функций
+     *      2. group - группа хеш функций из набора, которые тестируются в этом проходе
+     *      3. parameters - параметры тестирования
+     *      4. distribution_hashes - счетчики хеш-значений для каждой хеш функции группы
+     */
+    template<typename Hashes>
+    std::vector<double> CountHashes(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                    std::vector<DistributionHashes>& distribution_hashes);
+
+    template<typename Hashes>
+    std::vector<double> CountHashes(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                    std::vector<PartitionedDistributionHashes>& distribution_hashes);
+
+    /*
+     * Тестирование распределительных свойств группы хеш функций за один совмещенный проход. Реализация описана ниже
+     *      1. hashes - набор хеш функций
+     *      2. group - группа хеш функций из набора
+     *      3. parameters - параметры тестирования:
+     *          - битность хеша (16, 32, 64 или 128)
      *          - число ключей (целое положительное число)
      *          - число потоков (зависит от системы)
      *          - размер массива счетчиков хеш-значений
      *          - флаг тестирования: NORMAL или BINS
-     *      3. logger - записывает лог в файл и выводит его на консоль
+     *          - способ подсчета хеш-значений: ATOMIC или PARTITIONED
+     *      4. logger - записывает лог в файл и выводит его на консоль
      */
-    template<hfl::UnsignedIntegral UintT>
-    void HashDistributionTest(const hfl::Hash<UintT>& hash, const DistTestParameters& parameters, out::Logger& logger);
+    template<typename Hashes>
+    void HashGroupDistributionTest(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                   out::Logger& logger);
 
     /*
-     * Тестирование распределительных свойств хеш функций. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     * Тестирование распределительных свойств хеш функций. Реализация описана ниже.
+     * Хеш функции делятся на группы, счетчики которых помещаются в память (SplitIntoHashGroups),
+     * и каждая группа тестируется за один совмещенный проход
+     *  Параметр шаблона: набор хеш функций (кортеж из hfl::StaticHash или вектор из hfl::Hash)
      *  Входные параметры:
-     *      1. hashes - массив со всеми хеш-функциями одной битности
+     *      1. hashes - набор со всеми хеш-функциями одной битности
      *      2. parameters - параметры тестирования:
-     *          - битность хеша (16, 32 или 64)
+     *          - битность хеша (16, 32, 64 или 128)
      *          - число потоков (зависит от системы)
      *          - число ключей (целое положительное число)
      *          - размер массива счетчиков хеш-значений
      *          - флаг тестирования: NORMAL или BINS
      *      3. logger - записывает лог в файл и выводит его на консоль
      */
-    template<hfl::UnsignedIntegral UintT>
-    void DistributionTest(const std::vector<hfl::Hash<UintT>>& hashes, const DistTestParameters& parameters,
-                          out::Logger& logger);
+    template<typename Hashes>
+    void DistributionTest(const Hashes& hashes, const DistTestParameters& parameters, out::Logger& logger);
 
     //  Запускает тестирование распределительных свойств всех хеш функций
     //  Входной параметр: logger - записывает лог в файл и выводит его на консоль
@@ -93,38 +175,213 @@ namespace tests {
 
 // ==================================================
 
-    // Тестирование распределительных свойств одной хеш функции
-    template<hfl::UnsignedIntegral UintT>
-    void HashDistributionTest(const hfl::Hash<UintT>& hash, const DistTestParameters& parameters, out::Logger& logger) {
-        out::LogDuration log_duration("\t\ttime", logger);
-        logger << boost::format("\t%1%: \n") % hash.GetName();
-
-        DistributionHashes distribution_hashes{parameters.num_buckets};
-
-        // Функция, которая непосредственно тестирует хеш функцию.
-        // Запускается в отдельном потоке
-        auto lambda = [&hash, &parameters, &distribution_hashes](uint64_t start, uint64_t end) {
-            for (uint64_t number = start; number < end; ++number) {
-                const uint64_t hash_value = hash(number);
-                const uint64_t modified_value = ModifyHash(parameters, hash_value);
-                distribution_hashes.AddHash(modified_value);
+    // Хеширует числа
+    template<hfl::HashFunction HashType>
+    void HashNumbers(const HashType& hash, const DistTestParameters& parameters, std::span<const uint64_t> numbers,
+                     std::span<uint64_t> hash_values) {
+        hash.HashBatch(numbers, hash_values);
+        for (uint64_t& hash_value : hash_values) {
+            hash_value = ModifyHash(parameters, hash_value);
+        }
+    }
+
+    // Подсчет хеш-значений группы хеш функций в общих массивах атомарных счетчиков
+    template<typename Hashes>
+    std::vector<double> CountHashes(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                    std::vector<DistributionHashes>& distribution_hashes) {
+        using Clock = std::chrono::steady_clock;
+
+        // Функция, которая выполняется в потоке пула. Числа формируются пакетами по hash_batch_size штук,
+        // каждый пакет хешируется всеми хеш функциями группы. Время хеширования и подсчета
+        // каждой хеш функцией суммируется в seconds
+        auto task = [&hashes, group, &parameters, &distribution_hashes](std::vector<double>& seconds,
+                                                                        uint64_t start, uint64_t end) {
+            std::vector<uint64_t> numbers(hash_batch_size);
+            std::vector<uint64_t> hash_values(hash_batch_size);
+            for (uint64_t first = start; first < end; first += hash_batch_size) {
+                const size_t batch_size = std::min<uint64_t>(hash_batch_size, end - first);
+                const std::span numbers_batch(numbers.data(), batch_size);
+                const std::span hashes_batch(hash_values.data(), batch_size);
+                std::iota(numbers_batch.begin(), numbers_batch.end(), first);
+
+                hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+                    if (!group.Contains(hash_index)) {
+                        return;
+                    }
+                    const size_t index = hash_index - group.first;
+                    const auto start_time = Clock::now();
+                    HashNumbers(hash, parameters, numbers_batch, hashes_batch);
+                    for (const uint64_t hash_value : hashes_batch) {
+                        distribution_hashes[index].AddHash(hash_value);
+                    }
+                    const std::chrono::duration<double> duration = Clock::now() - start_time;
+                    seconds[index] += duration.count();
+                });
             }
         };
 
-        // Запуск теста в разных потоках
-        ThreadTasks<void> thread_tasks(lambda, parameters.num_threads, parameters.num_keys);
+        auto merge = [](std::vector<double>& seconds, const std::vector<double>& other_seconds) {
+            for (size_t i = 0; i < seconds.size(); ++i) {
+                seconds[i] += other_seconds[i];
+            }
+        };
+
+        // Запуск теста в потоках пула. Часть, которую поток берет за раз, - 16 пакетов
+        const std::vector<double> seconds = ParallelReduce(0, parameters.num_keys, 16 * hash_batch_size,
+                                                           std::vector<double>(group.Size()), task, merge,
+                                                           parameters.num_threads);
+
+        // Пропускная способность - число ключей за секунду одного потока, умноженное на число потоков
+        std::vector<double> keys_per_second(group.Size());
+        for (size_t i = 0; i < group.Size(); ++i) {
+            keys_per_second[i] = static_cast<double>(parameters.num_keys) * parameters.num_threads / seconds[i];
+        }
+        return keys_per_second;
+    }
+
+    // Подсчет хеш-значений группы хеш функций с разбиением по разделам (без атомарных операций)
+    template<typename Hashes>
+    std::vector<double> CountHashes(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                    std::vector<PartitionedDistributionHashes>& distribution_hashes) {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr size_t round_size = PartitionedDistributionHashes::max_staging_size;
+        const uint16_t num_threads = parameters.num_threads;
+        const uint64_t keys_per_thread = (parameters.num_keys + num_threads - 1) / num_threads;
+        // Все потоки выполняют одинаковое число раундов, так как раунды разделены барьером
+        const uint64_t num_rounds = (keys_per_thread + round_size - 1) / round_size;
+        std::barrier sync_point(num_threads);
+        // Время хеширования и подсчета каждой хеш функцией группы в каждом потоке
+        std::vector<std::vector<double>> thread_seconds(num_threads, std::vector<double>(group.Size()));
+
+        // Функция, запускаемая в отдельном потоке. В каждом раунде поток формирует до round_size своих чисел,
+        // хеширует их каждой хеш функцией группы и раскладывает хеш-значения по разделам, а затем
+        // переносит в счетчики свои разделы всех хеш функций группы
+        auto thread_task = [&hashes, group, &parameters, &distribution_hashes, &sync_point, &thread_seconds,
+                            keys_per_thread, num_rounds](uint16_t thread_index) {
+            const uint64_t start = std::min(parameters.num_keys, thread_index * keys_per_thread);
+            const uint64_t end = std::min(parameters.num_keys, start + keys_per_thread);
+            std::vector<double>& seconds = thread_seconds[thread_index];
+            std::vector<uint64_t> numbers(round_size);
+            std::vector<uint64_t> hash_values(round_size);
+
+            for (uint64_t round = 0; round < num_rounds; ++round) {
+                const uint64_t round_first = std::min(end, start + round * round_size);
+                const uint64_t round_last = std::min(end, round_first + round_size);
+                const size_t round_length = round_last - round_first;
+                std::iota(numbers.begin(), numbers.begin() + static_cast<ptrdiff_t>(round_length), round_first);
+
+                hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+                    if (!group.Contains(hash_index)) {
+                        return;
+                    }
+                    const size_t index = hash_index - group.first;
+                    const auto start_time = Clock::now();
+                    for (size_t offset = 0; offset < round_length; offset += hash_batch_size) {
+                        const size_t batch_size = std::min(hash_batch_size, round_length - offset);
+                        HashNumbers(hash, parameters, std::span(numbers.data() + offset, batch_size),
+                                    std::span(hash_values.data() + offset, batch_size));
+                    }
+                    distribution_hashes[index].AddHashes(thread_index, std::span(hash_values.data(), round_length));
+                    const std::chrono::duration<double> duration = Clock::now() - start_time;
+                    seconds[index] += duration.count();
+                });
+                sync_point.arrive_and_wait();
+
+                for (size_t index = 0; index < group.Size(); ++index) {
+                    const auto start_time = Clock::now();
+                    distribution_hashes[index].Flush(thread_index);
+                    const std::chrono::duration<double> duration = Clock::now() - start_time;
+                    seconds[index] += duration.count();
+                }
+                sync_point.arrive_and_wait();
+            }
+        };
+
+        // Запуск теста в потоках пула (раунды синхронизируются барьером, поэтому все потоки работают одновременно).
+        // Из задачи пула Broadcast выполнил бы задачи последовательно, и первая из них ждала бы на барьере вечно
+        BOOST_ASSERT_MSG(num_threads <= 1 || !ThreadPool::IsInsidePoolJob(),
+                         "Partitioned counting cannot be started from a thread pool job");
+        ThreadPool::GetInstance().Broadcast(num_threads, thread_task);
+
+        // Пропускная способность - число ключей за секунду одного потока, умноженное на число потоков
+        std::vector<double> keys_per_second(group.Size());
+        for (size_t i = 0; i < group.Size(); ++i) {
+            double seconds = 0;
+            for (const std::vector<double>& current_seconds : thread_seconds) {
+                seconds += current_seconds[i];
+            }
+            keys_per_second[i] = static_cast<double>(parameters.num_keys) * num_threads / seconds;
+        }
+        return keys_per_second;
+    }
+
+    // Тестирование распределительных свойств группы хеш функций за один совмещенный проход
+    template<typename Hashes, typename Counters>
+    void HashGroupDistributionTestImpl(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                       std::vector<Counters>& distribution_hashes, out::Logger& logger) {
+        std::vector<double> keys_per_second;
+        {
+            out::LogDuration log_duration("\t\ttime", logger);
+            keys_per_second = CountHashes(hashes, group, parameters, distribution_hashes);
+        }
+
         // Сохранение результатов тестирования
-        out::SaveReport(distribution_hashes.GetBuckets(), parameters, hash.GetName(), logger);
+        hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+            if (!group.Contains(hash_index)) {
+                return;
+            }
+            const size_t index = hash_index - group.first;
+            logger << boost::format("\t%1%: \n") % hash.GetName();
+            out::SaveReport(distribution_hashes[index].GetBuckets(), parameters, hash.GetName(),
+                            keys_per_second[index], logger);
+        });
+    }
+
+    // Тестирование распределительных свойств группы хеш функций
+    template<typename Hashes>
+    void HashGroupDistributionTest(const Hashes& hashes, HashGroup group, const DistTestParameters& parameters,
+                                   out::Logger& logger) {
+        switch (parameters.strategy) {
+            case CountingStrategy::ATOMIC: {
+                std::vector<DistributionHashes> distribution_hashes;
+                distribution_hashes.reserve(group.Size());
+                for (size_t i = 0; i < group.Size(); ++i) {
+                    distribution_hashes.emplace_back(parameters.num_buckets);
+                }
+                HashGroupDistributionTestImpl(hashes, group, parameters, distribution_hashes, logger);
+                break;
+            }
+            case CountingStrategy::PARTITIONED: {
+                std::vector<PartitionedDistributionHashes> distribution_hashes;
+                distribution_hashes.reserve(group.Size());
+                for (size_t i = 0; i < group.Size(); ++i) {
+                    distribution_hashes.emplace_back(parameters.num_buckets, parameters.num_threads);
+                }
+                HashGroupDistributionTestImpl(hashes, group, parameters, distribution_hashes, logger);
+                break;
+            }
+            default:
+                BOOST_ASSERT_MSG(false, "Unknown strategy");
+                break;
+        }
     }
 
     // Тестирование распределительных свойств хеш функций
-    template<hfl::UnsignedIntegral UintT>
-    void DistributionTest(const std::vector<hfl::Hash<UintT>>& hashes, const DistTestParameters& parameters,
-                          out::Logger& logger) {
-        // В цикле запускает тесты для всех хеш-функций
+    template<typename Hashes>
+    void DistributionTest(const Hashes& hashes, const DistTestParameters& parameters, out::Logger& logger) {
         out::StartAndEndLogBitsTest log(logger, parameters.hash_bits);
-        for (const hfl::Hash<UintT>& hash : hashes) {
-            HashDistributionTest(hash, parameters, logger);
+
+        // Память под счетчики одной хеш функции (и буферы потоков при подсчете по разделам)
+        uint64_t bytes_per_hash = parameters.num_buckets * sizeof(Bucket);
+        if (parameters.strategy == CountingStrategy::PARTITIONED) {
+            bytes_per_hash += static_cast<uint64_t>(parameters.num_threads)
+                              * PartitionedDistributionHashes::max_staging_size * sizeof(uint64_t);
+        }
+
+        // Запускает тесты для каждой группы хеш-функций
+        for (const HashGroup group : SplitIntoHashGroups(hfl::NumHashes(hashes), bytes_per_hash)) {
+            HashGroupDistributionTest(hashes, group, parameters, logger);
         }
     }
 }
@@ -2,6 +2,8 @@
 
 #include <boost/assert.hpp>
 
+#include "concurrency.h"
+
 namespace tests {
     namespace out {
         OutputJson GetEnglishTestJson(const TestParameters& parameters, size_t num_words, out::Logger& logger) {
@@ -24,24 +26,15 @@ namespace tests {
     }
 
     // Парсинг слов из файла
-    std::vector<std::string> ParseWords(const std::filesystem::path& file_name) {
-        std::ifstream input(file_name);
-        BOOST_ASSERT_MSG(input, "Could not open the file");
-
-        std::vector<std::string> words;
-        while (input) {
-            std::string str;
-            input >> str;
-            words.push_back(std::move(str));
-        }
-        return words;
+    KeyArena ParseWords(const std::filesystem::path& file_name) {
+        return KeyArena::MapLines(file_name, GetNumThreads());
     }
 
     // Запуск тестирования устойчивости к коллизиям хеш функций одной битности
     template <hfl::UnsignedIntegral UintT>
-    static void RunTestWithEnglishWordsImpl(const std::vector<std::string>& words, out::Logger& logger) {
+    static void RunTestWithEnglishWordsImpl(const KeyArena& words, uint16_t num_threads, out::Logger& logger) {
         const auto hashes = hfl::BuildHashes<UintT>();
-        const TestParameters parameters{std::numeric_limits<UintT>::digits};
+        const TestParameters parameters{std::numeric_limits<UintT>::digits, num_threads};
         TestWithEnglishWords(hashes, words, parameters, logger);
     }
 
@@ -49,12 +42,14 @@ namespace tests {
     void RunTestWithEnglishWords(out::Logger& logger) {
         out::StartAndEndLogTest start_and_end_log(logger, "ENGLISH WORDS");
         const std::filesystem::path& file_name = "data/english_words.txt";
-        const std::vector<std::string> words = ParseWords(file_name);
-
-        RunTestWithEnglishWordsImpl<uint16_t>(words, logger);
-        RunTestWithEnglishWordsImpl<hfl::uint24_t>(words, logger);
-        RunTestWithEnglishWordsImpl<uint32_t>(words, logger);
-        RunTestWithEnglishWordsImpl<hfl::uint48_t>(words, logger);
-        RunTestWithEnglishWordsImpl<uint64_t>(words, logger);
+        const uint16_t num_threads = GetNumThreads();
+        logger << boost::format("\tnum_threads = %1%\n\n") % num_threads;
+        const KeyArena words = ParseWords(file_name);
+
+        RunTestWithEnglishWordsImpl<uint16_t>(words, num_threads, logger);
+        RunTestWithEnglishWordsImpl<hfl::uint24_t>(words, num_threads, logger);
+        RunTestWithEnglishWordsImpl<uint32_t>(words, num_threads, logger);
+        RunTestWithEnglishWordsImpl<hfl::uint48_t>(words, num_threads, logger);
+        RunTestWithEnglishWordsImpl<uint64_t>(words, num_threads, logger);
     }
 }
@@ -1,12 +1,13 @@
 #ifndef THESIS_WORK_ENGLISH_TESTS_H
 #define THESIS_WORK_ENGLISH_TESTS_H
 
-#include <map>
 #include <vector>
 
 #include <boost/format.hpp>
 
+#include "concurrency.h"
 #include "count_collisions.h"
+#include "key_arena.h"
 #include "output.h"
 #include "timers.h"
 #include "test_parameters.h"
@@ -28,11 +29,12 @@ namespace tests {
     }
 
     /*
-     *  Парсинг слов из файла
+     *  Парсинг слов из файла (одно слово в строке). Файл отображается в память и разбивается
+     *  на строки в нескольких потоках, слова не копируются
      *  Входной параметр: file_name - название текстового файла
-     *  Выходное значение: массив строк (английских слов)
+     *  Выходное значение: хранилище английских слов
      */
-    std::vector<std::string> ParseWords(const std::filesystem::path& file_name);
+    KeyArena ParseWords(const std::filesystem::path& file_name);
 
     /*
      *  Тестирование устойчивости к коллизиям одной хеш функции. Реализация описана ниже
@@ -46,7 +48,7 @@ namespace tests {
      *      4. logger - записывает лог в файл и выводит его на консоль
      */
     template <hfl::UnsignedIntegral UintT>
-    uint64_t HashTestWithEngWords(const hfl::Hash<UintT>& hash, const std::vector<std::string>& words,
+    uint64_t HashTestWithEngWords(const hfl::Hash<UintT>& hash, const KeyArena& words,
                                   const TestParameters& parameters, out::Logger& logger);
 
     /*
@@ -61,7 +63,7 @@ namespace tests {
      *      4. logger - записывает лог в файл и выводит его на консоль
      */
     template <hfl::UnsignedIntegral UintT>
-    void TestWithEnglishWords(const std::vector<hfl::Hash<UintT>>& hashes, const std::vector<std::string>& words,
+    void TestWithEnglishWords(const std::vector<hfl::Hash<UintT>>& hashes, const KeyArena& words,
                               const TestParameters& parameters, out::Logger& logger);
 
     //  Запуск тестирования устойчивости к коллизиям хеш функций.
@@ -70,22 +72,28 @@ namespace tests {
 
 // ========================================================================================
 
+    // Число слов в одной части, которую поток берет из общего списка
+    static inline constexpr uint64_t words_grain = 4096;
+
     // Тестирование устойчивости к коллизиям одной хеш функции
     template <hfl::UnsignedIntegral UintT>
-    uint64_t HashTestWithEngWords(const hfl::Hash<UintT>& hash, const std::vector<std::string>& words,
+    uint64_t HashTestWithEngWords(const hfl::Hash<UintT>& hash, const KeyArena& words,
                                   const TestParameters& parameters, out::Logger& logger) {
         out::LogDuration log_duration("\t\ttime", logger);
         logger << '\t' + hash.GetName() + ':' << std::endl;
 
-        // Вычисляет хеши слов и заполняет ими ассоциативный массив (hash_values)
-        std::map<uint64_t, uint64_t> hash_values;
-        for (const std::string& word : words) {
-            const auto hash_value = static_cast<uint64_t>(hash(word));
-            ++hash_values[hash_value];
-        }
+        // Вычисляет хеши слов и записывает их в плоский массив (hash_values).
+        // Слова делятся между потоками пула частями по words_grain, каждая часть записывается в свой диапазон массива
+        std::vector<uint64_t> hash_values(words.Size());
+        auto lambda = [&hash, &words, &hash_values](uint64_t start, uint64_t end) {
+            for (uint64_t i = start; i < end; ++i) {
+                hash_values[i] = static_cast<uint64_t>(hash(words[i]));
+            }
+        };
+        ParallelFor(0, words.Size(), words_grain, lambda, parameters.num_threads);
 
         // Вычисляет число коллизий
-        const uint32_t num_collisions = CountCollisions(hash_values);
+        const uint64_t num_collisions = CountCollisions(std::move(hash_values), parameters.num_threads);
         // Выводит лог
         logger << "\t\tcollisions: " << num_collisions << std::endl;
 
@@ -94,11 +102,11 @@ namespace tests {
 
     // Тестирование устойчивости к коллизиям хеш функций
     template <hfl::UnsignedIntegral UintT>
-    void TestWithEnglishWords(const std::vector<hfl::Hash<UintT>>& hashes, const std::vector<std::string>& words,
+    void TestWithEnglishWords(const std::vector<hfl::Hash<UintT>>& hashes, const KeyArena& words,
                               const TestParameters& parameters, out::Logger& logger) {
         out::StartAndEndLogBitsTest printer(logger, parameters.hash_bits);
 
-        auto out_json = out::GetEnglishTestJson(parameters, words.size(), logger);
+        auto out_json = out::GetEnglishTestJson(parameters, words.Size(), logger);
         boost::json::object collisions;
         // В цикле запускает тест для каждой хеш функции
         for (const hfl::Hash<UintT>& hash : hashes) {
@@ -33,7 +33,7 @@ namespace tests {
                                         uint16_t words_length, TestFlag mode, out::Logger& logger) {
         const uint64_t num_words = (1ull << shift);
         const GenBlocksParameters parameters {hash_bits, test_bits, num_threads, num_words, words_length, mode};
-        const auto hashes = hfl::BuildHashes<UintT>();
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
         TestWithGeneratedBlocks(hashes, parameters, logger);
     }
 
@@ -56,5 +56,7 @@ namespace tests {
                                                  TestFlag::MASK, logger);
         RunTestWithGeneratedBlocksImpl<uint64_t>(bits64, bits32, bits24, num_threads, words_length,
                                                  TestFlag::MASK, logger);
+        RunTestWithGeneratedBlocksImpl<hfl::uint128_t>(bits128, bits32, bits24, num_threads, words_length,
+                                                       TestFlag::MASK, logger);
     }
 }
\ No newline at end of file
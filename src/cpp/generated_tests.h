@@ -1,11 +1,13 @@
 #ifndef THESIS_WORK_WORDS_TESTS_H
 #define THESIS_WORK_WORDS_TESTS_H
 
+#include <algorithm>
 #include <barrier>
-#include <deque>
 #include <fstream>
 #include <future>
 #include <iostream>
+#include <span>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -13,9 +15,11 @@
 
 #include <pcg_random.hpp>
 
+#include "atomic_bitmap.h"
 #include "concurrency.h"
 #include "generators.h"
 #include "hashes.h"
+#include "key_arena.h"
 #include "output.h"
 #include "timers.h"
 
@@ -28,7 +32,7 @@ namespace tests {
          *  на устойчивости к коллизиям
          *  Входные параметры:
          *      1. parameters - параметры тестирования:
-         *          - битность хеша (16, 24, 32, 48 или 64)
+         *          - битность хеша (16, 24, 32, 48, 64 или 128)
          *          - битность маски (16, 24 или 32)
          *          - число потоков (зависит от системы)
          *          - число хешируемых блоков (целое положительное число)
@@ -40,32 +44,36 @@ namespace tests {
     }
 
     /*
-     *  Тестирование устойчивости к коллизиям одной хеш функции. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     *  Тестирование устойчивости к коллизиям группы хеш функций за один совмещенный проход. Реализация описана ниже.
+     *  Каждый пакет блоков генерируется один раз и хешируется всеми хеш функциями группы
+     *  Параметр шаблона: набор хеш функций (кортеж из hfl::StaticHash или вектор из hfl::Hash)
      *  Входные параметры:
-     *      1. hash - хеш-функция
-     *      2. parameters - параметры тестирования:
-     *          - битность хеша (16, 24, 32, 48 или 64)
+     *      1. hashes - набор хеш функций
+     *      2. group - группа хеш функций из набора, которые тестируются в этом проходе
+     *      3. parameters - параметры тестирования:
+     *          - битность хеша (16, 24, 32, 48, 64 или 128)
      *          - битность маски (16, 24 или 32)
      *          - число потоков (зависит от системы)
      *          - число хешируемых блоков (целое положительное число)
      *          - размер блока
      *          - флаг тестирования (NORMAL или MASK)
-     *      3. logger - записывает лог в файл и выводит его на консоль
-     *  Выходное значение: пара название хеш функции и число коллизий
+     *      4. logger - записывает лог в файл и выводит его на консоль
+     *  Выходное значение: число коллизий для каждой хеш функции группы (в порядке номеров)
      */
-    template<hfl::UnsignedIntegral UintT>
-    auto HashTestWithGenBlocks(const hfl::Hash<UintT>& hash,
-                               const GenBlocksParameters& parameters, out::Logger& logger);
+    template<typename Hashes>
+    std::vector<boost::json::object> HashGroupTestWithGenBlocks(const Hashes& hashes, HashGroup group,
+                                                                const GenBlocksParameters& parameters,
+                                                                out::Logger& logger);
 
     /*
-     *  Тестирование устойчивости к коллизиям хеш функций. Реализация описана ниже
-     *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
+     *  Тестирование устойчивости к коллизиям хеш функций. Реализация описана ниже.
+     *  Хеш функции делятся на группы, битовые карты которых помещаются в память (SplitIntoHashGroups)
+     *  Параметр шаблона: набор хеш функций (кортеж из hfl::StaticHash или вектор из hfl::Hash)
      *  Входные параметры:
-     *      1. hashes - массив со всеми хеш-функциями одной битности
+     *      1. hashes - набор со всеми хеш-функциями одной битности
      *      2. words - массив хешируемых слов
      *      3. parameters - параметры тестирования:
-     *          - битность хеша (16, 24, 32, 48 или 64)
+     *          - битность хеша (16, 24, 32, 48, 64 или 128)
      *          - битность маски (16, 24 или 32)
      *          - число потоков (зависит от системы)
      *          - число хешируемых блоков (целое положительное число)
@@ -73,28 +81,36 @@ namespace tests {
      *          - флаг тестирования (NORMAL или MASK)
      *      4. logger - записывает лог в файл и выводит его на консоль
      */
-    template<hfl::UnsignedIntegral UintT>
-    void TestWithGeneratedBlocks(const std::vector<hfl::Hash<UintT>>& hashes,
-                                 const GenBlocksParameters& parameters, out::Logger& logger);
+    template<typename Hashes>
+    void TestWithGeneratedBlocks(const Hashes& hashes, const GenBlocksParameters& parameters, out::Logger& logger);
 
     // Запуск тестирования устойчивости к коллизиям хеш функций
     void RunTestWithGeneratedBlocks(uint16_t words_length, out::Logger& logger);
 
     // ===============================================================================
 
-    // Тестирование устойчивости к коллизиям одной хеш функции
-    template<hfl::UnsignedIntegral UintT>
-    auto HashTestWithGenBlocks(const hfl::Hash<UintT>& hash, const GenBlocksParameters& parameters,
-                               out::Logger& logger) {
+    // Тестирование устойчивости к коллизиям группы хеш функций за один совмещенный проход
+    template<typename Hashes>
+    std::vector<boost::json::object> HashGroupTestWithGenBlocks(const Hashes& hashes, HashGroup group,
+                                                                const GenBlocksParameters& parameters,
+                                                                out::Logger& logger) {
         out::LogDuration log_duration("\t\ttime", logger);
-        logger << boost::format("\n\t%1%: \n") % hash.GetName();
+
+        // Названия хеш функций группы (для лога)
+        std::vector<std::string> hash_names;
+        hash_names.reserve(group.Size());
+        hfl::ForEachHashIndexed(hashes, [group, &hash_names](size_t hash_index, const auto& hash) {
+            if (group.Contains(hash_index)) {
+                hash_names.push_back(hash.GetName());
+            }
+        });
 
         // Выдает генераторы, число которых равно числу запускаемых потоков
         std::uint64_t num_generated_numbers = (parameters.num_keys * parameters.words_length) / 8;
-        std::vector<pcg64> generators = GetGenerators(parameters.num_threads, num_generated_numbers);   \
+        std::vector<pcg64> generators = GetGenerators(parameters.num_threads, num_generated_numbers);
 
-        boost::json::object collisions;
-        std::atomic_uint64_t num_collisions = 0;
+        std::vector<boost::json::object> collisions(group.Size());
+        std::vector<std::atomic_uint64_t> num_collisions(group.Size());
 
         size_t num_words = (1 << (parameters.mask_bits >> 1));
         size_t step = (parameters.mask_bits != 24) ? 1 : 2;
@@ -104,69 +120,113 @@ namespace tests {
         // Функция, запускаемая барьером sync_point (описан ниже) после выполнения
         // внутреннего цикла в thread_task
         auto loop_completion_task =
-                [&logger, &num_words, &num_collisions, &collisions, &loop_conditional, 
+                [&logger, &hash_names, &num_words, &num_collisions, &collisions, &loop_conditional,
                  &parameters, step] () noexcept{
-            logger << boost::format("\t\t%1% words:\t%2% collisions\n") % num_words % num_collisions;
-            std::string index = std::to_string(num_words);
-            collisions[index] = num_collisions;
+            logger << boost::format("\t\t%1% words:\n") % num_words;
+            const std::string index = std::to_string(num_words);
+            for (size_t i = 0; i < hash_names.size(); ++i) {
+                logger << boost::format("\t\t\t%1%:\t%2% collisions\n") % hash_names[i] % num_collisions[i];
+                collisions[i][index] = num_collisions[i].load();
+            }
             num_words <<= step;
             loop_conditional = (num_words <= parameters.num_keys);
         };
 
+        // Битовые карты хеш-значений для каждой хеш функции группы
         const uint64_t num_hashes = 1ull << parameters.mask_bits;
-        std::deque<std::atomic_bool> coll_flags(num_hashes);
+        std::vector<AtomicBitmap> coll_flags;
+        coll_flags.reserve(group.Size());
+        for (size_t i = 0; i < group.Size(); ++i) {
+            coll_flags.emplace_back(num_hashes);
+        }
 
         std::atomic_size_t gen_index = 0;
         std::barrier sync_point(parameters.num_threads, loop_completion_task);
 
-        // Функция, запускаемая в отдельном потоке. Подсчитывает число коллизий
-        auto thread_task = [&loop_conditional, &num_words, &parameters, &generators, &gen_index, &hash, &coll_flags,
-                            &num_collisions, &sync_point] () {
+        // Число блоков, которые генерируются и хешируются за один вызов HashBatch.
+        // Ограничено так, чтобы буфер блоков занимал не более max_batch_bytes байт
+        constexpr size_t max_batch_bytes = 1ull << 20;
+        const size_t words_per_batch = std::clamp<size_t>(max_batch_bytes / parameters.words_length,
+                                                          1, hash_batch_size);
+
+        // Функция, запускаемая в отдельном потоке. Подсчитывает число коллизий.
+        // Каждый пакет блоков генерируется один раз и хешируется всеми хеш функциями группы
+        auto thread_task = [&loop_conditional, &num_words, &parameters, &generators, &gen_index, &hashes, group,
+                            &coll_flags, &num_collisions, &sync_point, words_per_batch] () {
             pcg64& rng = generators[gen_index++];
+            const uint32_t length = parameters.words_length;
+
+            // Хранилище, в котором лежат сгенерированные блоки одного пакета. Блоки каждого
+            // следующего пакета генерируются на месте предыдущих
+            KeyArena blocks(words_per_batch, words_per_batch * length);
+            for (size_t j = 0; j < words_per_batch; ++j) {
+                blocks.Append(length);
+            }
+            const std::vector<std::string_view> words = blocks.GetViews();
+            std::vector<uint64_t> hash_values(words_per_batch);
+
             for (size_t i = 0; loop_conditional; ) {
                 size_t thread_num_words = num_words / parameters.num_threads;
-                for (; i < thread_num_words; ++i) {
-                    std::string str = GenerateRandomDataBlock(rng, parameters.words_length);
-                    const uint64_t hash_value = hash(str);
-                    const uint64_t modified_hash_value = ModifyHash(parameters, hash_value);
-                    num_collisions += coll_flags[modified_hash_value].exchange(true);
+                while (i < thread_num_words) {
+                    const size_t batch_size = std::min(words_per_batch, thread_num_words - i);
+                    for (size_t j = 0; j < batch_size; ++j) {
+                        GenerateRandomDataBlock(rng, blocks.Data(j), length);
+                    }
+
+                    const std::span words_batch(words.data(), batch_size);
+                    const std::span hashes_batch(hash_values.data(), batch_size);
+                    hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+                        if (!group.Contains(hash_index)) {
+                            return;
+                        }
+                        const size_t index = hash_index - group.first;
+                        hash.HashBatch(words_batch, hashes_batch);
+                        uint64_t batch_collisions = 0;
+                        for (const uint64_t hash_value : hashes_batch) {
+                            const uint64_t modified_hash_value = ModifyHash(parameters, hash_value);
+                            batch_collisions += coll_flags[index].TestAndSet(modified_hash_value);
+                        }
+                        num_collisions[index] += batch_collisions;
+                    });
+                    i += batch_size;
                 }
                 sync_point.arrive_and_wait();
             }
         };
 
-        {   // Запуск thread_task в нескольких потоках
-            std::vector<std::jthread> threads(parameters.num_threads - 1);
-            for (auto& t : threads) {
-                t = std::jthread(thread_task);
-            }
+        // Запуск thread_task в потоках пула (потоки синхронизируются барьером, поэтому работают одновременно)
+        ThreadPool::GetInstance().Broadcast(parameters.num_threads, [&thread_task](uint16_t) {
             thread_task();
-        }
+        });
 
-        // Возвращение результатов теста
-        auto hash_name = static_cast<boost::json::string>(hash.GetName());
-        if (parameters.mode == TestFlag::MASK) {
-            hash_name += " (mask " + std::to_string(parameters.mask_bits) + " bits)";
-        }
-        boost::json::object result;
-        result[hash_name] = collisions;
-        return std::pair{std::move(hash_name), std::move(collisions)};
+        return collisions;
     }
 
 
     // Тестирование устойчивости к коллизиям хеш функций
-    template<hfl::UnsignedIntegral UintT>
-    void TestWithGeneratedBlocks(const std::vector<hfl::Hash<UintT>>& hashes, const GenBlocksParameters& parameters,
-                                 out::Logger& logger) {
+    template<typename Hashes>
+    void TestWithGeneratedBlocks(const Hashes& hashes, const GenBlocksParameters& parameters, out::Logger& logger) {
         out::StartAndEndLogBitsTest log(logger, parameters.hash_bits);
 
         auto out_json = out::GetGenTestJson(parameters, logger);
         boost::json::object collisions;
 
-        // В цикле запускаются тесты (HashTestWithGenBlocks) для каждой хеш функции
-        for (const auto& hash : hashes) {
-            auto [hash_name, counters] = HashTestWithGenBlocks(hash, parameters, logger);
-            collisions[hash_name] = std::move(counters);
+        // Запускаются тесты (HashGroupTestWithGenBlocks) для каждой группы хеш функций.
+        // Битовая карта одной хеш функции занимает 2^mask_bits бит
+        const uint64_t bytes_per_hash = (1ull << parameters.mask_bits) / 8;
+        for (const HashGroup group : SplitIntoHashGroups(hfl::NumHashes(hashes), bytes_per_hash)) {
+            std::vector<boost::json::object> group_collisions = HashGroupTestWithGenBlocks(hashes, group,
+                                                                                           parameters, logger);
+            hfl::ForEachHashIndexed(hashes, [&](size_t hash_index, const auto& hash) {
+                if (!group.Contains(hash_index)) {
+                    return;
+                }
+                auto hash_name = static_cast<boost::json::string>(hash.GetName());
+                if (parameters.mode == TestFlag::MASK) {
+                    hash_name += " (mask " + std::to_string(parameters.mask_bits) + " bits)";
+                }
+                collisions[hash_name] = std::move(group_collisions[hash_index - group.first]);
+            });
         }
 
         // Сохранение результатов тестирования
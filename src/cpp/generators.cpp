@@ -21,7 +21,7 @@ std::vector<pcg64> GetGenerators(size_t num_generators, size_t num_generate_numb
     generators.reserve(num_generators);
 
     // В цикле помещаются генераторы в вектор с заданным шагом
-    for (size_t i = 0; i < num_generators - 1; ++i) {
+    for (size_t i = 0; i < num_generators; ++i) {
         generators.emplace_back(rng);
         rng.advance(step);
     }
@@ -35,41 +35,43 @@ std::string GenerateRandomDataBlock(pcg64& rng, uint32_t length) {
     // блок данных
     std::string word;
     word.resize(length);
+    GenerateRandomDataBlock(rng, word.data(), length);
 
+    BOOST_ASSERT_MSG(word.size() == length, "words.size() != length");
+    return word;
+}
+
+// Генерирует случайный блок данных заданной длины (length) и записывает его в block
+void GenerateRandomDataBlock(pcg64& rng, char* block, uint32_t length) {
     // Размер генерируемого блока
     constexpr uint64_t chunk_size = sizeof(uint64_t);
     // Число генерируемых блоков
     const uint64_t num_chunks = length / chunk_size;
 
-    // В цикле генерируются блоки и помещаются в строку
+    // В цикле генерируются блоки и помещаются в block
     for (uint64_t i = 0; i < num_chunks; ++i) {
         uint64_t src = rng();
         uint64_t step = i * chunk_size;
-        std::memcpy(word.data() + step, &src, chunk_size);
+        std::memcpy(block + step, &src, chunk_size);
     }
 
     // Генерация последнего блока данных
     uint64_t src = rng();
     const uint64_t all_chunks_size = num_chunks * chunk_size;
     const uint64_t diff = length - all_chunks_size;
-    std::memcpy(word.data() + all_chunks_size, &src, diff);
-
-    BOOST_ASSERT_MSG(word.size() == length, "words.size() != length");
-    return word;
+    std::memcpy(block + all_chunks_size, &src, diff);
 }
 
-// Генерирует вектор из случайных блоков данных заданной длины (length)
-std::vector<std::string> GenerateRandomDataBlocks(pcg64& rng, uint64_t num_blocks, uint32_t block_length) {
-    // Создается вектор, в который будут помещены
+// Генерирует случайные блоки данных заданной длины (length) в одном хранилище
+tests::KeyArena GenerateRandomDataBlocks(pcg64& rng, uint64_t num_blocks, uint32_t block_length) {
+    // Создается хранилище, в которое будут помещены
     // сгенерированные блоки данных
-    std::vector<std::string> generated_blocks;
-    generated_blocks.reserve(num_blocks);
+    tests::KeyArena generated_blocks(num_blocks, num_blocks * block_length);
 
-    // В цикле генерируются блоки данных и помещаются в вектор
+    // В цикле генерируются блоки данных сразу в хранилище
     for (uint64_t i = 0; i < num_blocks; ++i) {
-        std::string str = GenerateRandomDataBlock(rng, block_length);
-        generated_blocks.push_back(std::move(str));
+        GenerateRandomDataBlock(rng, generated_blocks.Append(block_length), block_length);
     }
 
     return generated_blocks;
-}
\ No newline at end of file
+}
@@ -7,6 +7,8 @@
 
 #include <pcg_random.hpp>
 
+#include "key_arena.h"
+
 /*
  *  Генерирует сиды (seeds) для хеш-функций
  *  Параметры шаблона:
@@ -89,14 +91,22 @@ std::vector<pcg64> GetGenerators(size_t num_generators, size_t num_generate_numb
  */
 std::string GenerateRandomDataBlock(pcg64& rng, uint32_t length);
 
+/*  Генерирует случайный блок данных заданной длины и записывает его в block
+ *  Входные параметры:
+ *      1. rng - генератор PCG-64
+ *      2. block - указатель на начало блока данных (не менее length байт)
+ *      3. length - размер блока данных
+ */
+void GenerateRandomDataBlock(pcg64& rng, char* block, uint32_t length);
+
 /*
- *  Генерирует вектор из случайных блоков данных заданной длины
+ *  Генерирует случайные блоки данных заданной длины. Блоки записываются подряд в одно хранилище
  *  Входные параметры:
  *      1. rng - генератор PCG-64
  *      2. num_blocks - число блоков
  *      3. block_length - размер блока данных
- *  Выходное значение: массив блоков данных
+ *  Выходное значение: хранилище блоков данных
  */
-std::vector<std::string> GenerateRandomDataBlocks(pcg64& rng, uint64_t num_blocks, uint32_t block_length);
+tests::KeyArena GenerateRandomDataBlocks(pcg64& rng, uint64_t num_blocks, uint32_t block_length);
 
 #endif //THESIS_WORK_GENERATORS_H
@@ -1,10 +1,15 @@
 //#include <endian.h>
 
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+
 #include <cityhash/city.h>
 #include <farmhash/farmhash.h>
 #include <fasthash/fasthash.h>
 #include <highwayhash/sip_hash.h>
 #include <highwayhash/highwayhash.h>
+#include <multi_lane/multi_lane.h>
 #include <murmur_hash/MurmurHash1.h>
 #include <murmur_hash/MurmurHash2.h>
 #include <murmur_hash/MurmurHash3.h>
@@ -20,6 +25,7 @@
 #include <siphash/siphash_impl.h>
 #include <spooky_hash/spooky.h>
 #include <xx_hash/xxhash.h>
+#include <xx_hash/xxh3_targets.h>
 #include <wyhash/wyhash.h>
 #include <wyhash/wyhash32.h>
 
@@ -28,6 +34,74 @@
 #include "hash_wrappers.h"
 #include "generators.h"
 
+namespace hfl::wrappers::detail {
+    bool MultiLaneHasher::IsKernelSupported(Isa isa) {
+        return std::find(isas.begin(), isas.end(), isa) != isas.end() && IsIsaSupported(isa);
+    }
+
+    size_t MultiLaneHasher::NumLanes(Isa isa) {
+        switch (isa) {
+            case Isa::AVX2:
+                return multi_lane::avx2::lanes;
+            case Isa::SSE41:
+                return multi_lane::sse41::lanes;
+            default:
+                return 1;
+        }
+    }
+
+    MultiLaneHasher::MultiLaneHasher(Isa isa, Kernels kernels)
+        : isa_(isa)
+        , kernel_(nullptr) {
+        BOOST_ASSERT_MSG(IsKernelSupported(isa), "Multi-lane kernel is not supported");
+        switch (isa) {
+            case Isa::AVX2:
+                kernel_ = kernels.avx2;
+                break;
+            case Isa::SSE41:
+                kernel_ = kernels.sse41;
+                break;
+            default:
+                break;
+        }
+    }
+
+    Isa MultiLaneHasher::GetIsa() const {
+        return isa_;
+    }
+
+    // Ядро записывает 32-битные хеш-значения в буфер, которые затем расширяются до uint64_t
+    bool MultiLaneHasher::HashLanes(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const {
+        if (kernel_ == nullptr) {
+            return false;
+        }
+        std::array<uint32_t, max_keys_per_call> lane_hashes{};
+        for (size_t first = 0; first < keys.size(); first += max_keys_per_call) {
+            const size_t num_keys = std::min(max_keys_per_call, keys.size() - first);
+            kernel_(keys.data() + first, num_keys, lane_hashes.data());
+            std::copy_n(lane_hashes.begin(), num_keys, hashes.begin() + static_cast<std::ptrdiff_t>(first));
+        }
+        return true;
+    }
+
+    // Числа передаются ядру как строки из sizeof(uint64_t) байт
+    bool MultiLaneHasher::HashLanes(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const {
+        if (kernel_ == nullptr) {
+            return false;
+        }
+        std::array<std::string_view, max_keys_per_call> keys;
+        for (size_t first = 0; first < numbers.size(); first += max_keys_per_call) {
+            const size_t num_keys = std::min(max_keys_per_call, numbers.size() - first);
+            for (size_t i = 0; i < num_keys; ++i) {
+                const char* bytes = reinterpret_cast<const char*>(reinterpret_cast<const void*>(&numbers[first + i]));
+                keys[i] = std::string_view(bytes, sizeof(uint64_t));
+            }
+            HashLanes(std::span(keys.data(), num_keys), hashes.subspan(first, num_keys));
+        }
+        return true;
+    }
+}
+
 namespace hfl::wrappers {
 
     constexpr uint8_t shift16 = 16;
@@ -35,6 +109,20 @@ namespace hfl::wrappers {
     constexpr uint8_t shift32 = 32;
     constexpr uint8_t shift48 = 48;
 
+    //----- Bernstein's hash DJB2 ------
+
+    DJB2HashWrapper<uint32_t>::DJB2HashWrapper()
+        : DJB2HashWrapper(SelectBestIsa<DJB2HashWrapper>()) {
+    }
+
+    DJB2HashWrapper<uint32_t>::DJB2HashWrapper(Isa isa)
+        : MultiLaneHasher(isa, {multi_lane::sse41::DJB2Hash32, multi_lane::avx2::DJB2Hash32}) {
+    }
+
+    uint32_t DJB2HashWrapper<uint32_t>::HashImpl(const char *message, size_t length) const {
+        return DJB2Hash<uint32_t>(message, length);
+    }
+
     //----------- CityHash ----------
 
     uint32_t CityHash32Wrapper::HashImpl(const char *message, size_t length) const {
@@ -53,6 +141,16 @@ namespace hfl::wrappers {
         return city::CityHash64WithSeeds(message, length, SEED_64_1, SEED_64_2);
     }
 
+    uint128_t CityHash128Wrapper::HashImpl(const char *message, size_t length) const {
+        const city::uint128 hash = city::CityHash128(message, length);
+        return MakeUint128(city::Uint128High64(hash), city::Uint128Low64(hash));
+    }
+
+    uint128_t CityHash128WithSeedWrapper::HashImpl(const char *message, size_t length) const {
+        const city::uint128 hash = city::CityHash128WithSeed(message, length, {SEED_64_1, SEED_64_2});
+        return MakeUint128(city::Uint128High64(hash), city::Uint128Low64(hash));
+    }
+
     //----------- FarmHash ----------
 
     uint32_t FarmHash32Wrapper::HashImpl(const char *message, size_t length) const {
@@ -116,6 +214,20 @@ namespace hfl::wrappers {
         return hash;
     }
 
+    FNV1aHash32Wrapper::FNV1aHash32Wrapper()
+        : FNV1aHash32Wrapper(SelectBestIsa<FNV1aHash32Wrapper>()) {
+    }
+
+    FNV1aHash32Wrapper::FNV1aHash32Wrapper(Isa isa)
+        : MultiLaneHasher(isa, {
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::sse41::FNV1aHash32(keys, num_keys, SEED_32, hashes);
+            },
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::avx2::FNV1aHash32(keys, num_keys, SEED_32, hashes);
+            }}) {
+    }
+
     uint32_t FNV1aHash32Wrapper::HashImpl(const char *message, size_t length) const {
         return FNV32a(message, static_cast<int>(length), SEED_32);
     }
@@ -133,17 +245,82 @@ namespace hfl::wrappers {
 
     //---------- HighwayHash -----------
 
+    bool HighwayHashWrapper::IsKernelSupported(Isa isa) {
+        return std::find(isas.begin(), isas.end(), isa) != isas.end() && IsIsaSupported(isa);
+    }
+
+    HighwayHashWrapper::HighwayHashWrapper()
+        : HighwayHashWrapper(SelectBestIsa<HighwayHashWrapper>()) {
+    }
+
+    namespace detail {
+        // Вычисляет состояние HighwayHash для ядра набора инструкций isa
+        HighwayHashState MakeHighwayHashState(Isa isa) {
+            const highwayhash::HHKey key = {SEED_64_1, SEED_64_2, SEED_64_3, SEED_64_4};
+            switch (isa) {
+#if HH_ARCH_X64
+                case Isa::AVX2:
+                    return highwayhash::HighwayHashKeyed<HH_TARGET_AVX2>{key};
+                case Isa::SSE41:
+                    return highwayhash::HighwayHashKeyed<HH_TARGET_SSE41>{key};
+#endif
+                default:
+                    return highwayhash::HighwayHashKeyed<HH_TARGET_Portable>{key};
+            }
+        }
+    }
+
+    HighwayHashWrapper::HighwayHashWrapper(Isa isa)
+        : isa_(isa)
+        , state_(detail::MakeHighwayHashState(isa)) {
+        BOOST_ASSERT_MSG(IsKernelSupported(isa), "HighwayHash kernel is not supported");
+    }
+
+    Isa HighwayHashWrapper::GetIsa() const {
+        return isa_;
+    }
+
     uint64_t HighwayHashWrapper::HashImpl(const char *message, size_t length) const {
-        static const std::array key HH_ALIGNAS(32) = {SEED_64_1, SEED_64_2, SEED_64_3, SEED_64_4};
-        highwayhash::HHStateT<HH_TARGET> state{key.data()};
-        highwayhash::HHResult64 result = 0;
-        highwayhash::HighwayHashT(&state, message, length, &result);
-        return result;
+        highwayhash::HHResult64 hash = 0;
+        std::visit([&](const auto& state) {
+            state(message, length, &hash);
+        }, state_);
+        return hash;
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> HighwayHashWrapper::CreateStreamingState() const {
+        const highwayhash::HHKey key = {SEED_64_1, SEED_64_2, SEED_64_3, SEED_64_4};
+        return CreateHighwayHashStreamingState(key);
+    }
+
+    HighwayHash128Wrapper::HighwayHash128Wrapper()
+        : state_(detail::MakeHighwayHashState(SelectBestIsa<HighwayHashWrapper>())) {
+    }
+
+    uint128_t HighwayHash128Wrapper::HashImpl(const char *message, size_t length) const {
+        highwayhash::HHResult128 hash{};
+        std::visit([&](const auto& state) {
+            state(message, length, &hash);
+        }, state_);
+        return MakeUint128(hash[1], hash[0]);
     }
 
 
     //--------- Jenkins hash -----------
 
+    OneTimeHashWrapper<uint32_t>::OneTimeHashWrapper()
+        : OneTimeHashWrapper(SelectBestIsa<OneTimeHashWrapper>()) {
+    }
+
+    OneTimeHashWrapper<uint32_t>::OneTimeHashWrapper(Isa isa)
+        : MultiLaneHasher(isa, {multi_lane::sse41::OneAtATimeHash32, multi_lane::avx2::OneAtATimeHash32}) {
+    }
+
+    uint32_t OneTimeHashWrapper<uint32_t>::HashImpl(const char *message, size_t length) const {
+        const uint8_t* key = reinterpret_cast<const uint8_t*>(message);
+        return one_at_a_time_hash<uint32_t>(key, length);
+    }
+
     uint16_t SpookyHash16Wrapper::HashImpl(const char *message, size_t length) const {
         auto hash = spooky_hash32(message, length, SEED_32);
         return static_cast<uint32_t>(hash);
@@ -167,12 +344,39 @@ namespace hfl::wrappers {
         return spooky_hash64(message, length, SEED_64_1);
     }
 
+    uint128_t SpookyHash128Wrapper::HashImpl(const char *message, size_t length) const {
+        uint64_t hash1 = SEED_64_1;
+        uint64_t hash2 = SEED_64_2;
+        spooky_hash128(message, length, &hash1, &hash2);
+        return MakeUint128(hash2, hash1);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint16_t>> SpookyHash16Wrapper::CreateStreamingState() const {
+        return CreateSpookyHashStreamingState<uint16_t>(SEED_32);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint24_t>> SpookyHash24Wrapper::CreateStreamingState() const {
+        return CreateSpookyHashStreamingState<uint24_t>(SEED_32);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint32_t>> SpookyHash32Wrapper::CreateStreamingState() const {
+        return CreateSpookyHashStreamingState<uint32_t>(SEED_32);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint48_t>> SpookyHash48Wrapper::CreateStreamingState() const {
+        return CreateSpookyHashStreamingState<uint48_t>(SEED_64_1);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> SpookyHash64Wrapper::CreateStreamingState() const {
+        return CreateSpookyHashStreamingState<uint64_t>(SEED_64_1);
+    }
+
     //------------ MetroHash -----------
 
     uint64_t MetroHash64_Wrapper::HashImpl(const char *message, size_t length) const {
         uint64_t hash = 0;
         static const size_t bytes_in_hash = 8;
-        std::vector<uint8_t> hash_array(bytes_in_hash, 0);
+        std::array<uint8_t, bytes_in_hash> hash_array{};
         MetroHash64::Hash(reinterpret_cast<const uint8_t*>(message), length, hash_array.data(), SEED_64_1);
         memcpy(&hash, hash_array.data(), bytes_in_hash);
         return hash;
@@ -196,12 +400,38 @@ namespace hfl::wrappers {
         return MurmurHash64A(message, static_cast<int>(length), SEED_64_1);
     }
 
+    MurmurHash3Wrapper::MurmurHash3Wrapper()
+        : MurmurHash3Wrapper(SelectBestIsa<MurmurHash3Wrapper>()) {
+    }
+
+    MurmurHash3Wrapper::MurmurHash3Wrapper(Isa isa)
+        : MultiLaneHasher(isa, {
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::sse41::MurmurHash3_x86_32(keys, num_keys, SEED_32, hashes);
+            },
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::avx2::MurmurHash3_x86_32(keys, num_keys, SEED_32, hashes);
+            }}) {
+    }
+
     uint32_t MurmurHash3Wrapper::HashImpl(const char *message, size_t length) const {
         uint32_t hash = 0;
         MurmurHash3_x86_32(message, static_cast<int>(length), SEED_32, &hash);
         return hash;
     }
 
+    uint128_t MurmurHash3_x86_128Wrapper::HashImpl(const char *message, size_t length) const {
+        std::array<uint64_t, 2> hash{};
+        MurmurHash3_x86_128(message, static_cast<int>(length), SEED_32, hash.data());
+        return MakeUint128(hash[1], hash[0]);
+    }
+
+    uint128_t MurmurHash3_x64_128Wrapper::HashImpl(const char *message, size_t length) const {
+        std::array<uint64_t, 2> hash{};
+        MurmurHash3_x64_128(message, static_cast<int>(length), SEED_32, hash.data());
+        return MakeUint128(hash[1], hash[0]);
+    }
+
 
     //------------ MUM/mir -------------
 
@@ -238,7 +468,7 @@ namespace hfl::wrappers {
 
 //---------- PearsonHashes ---------
 
-    void PearsonHash16::Init() const {
+    PearsonHash16::PearsonHash16() {
         t16_.resize(table_size_);
         iota(t16_.begin(), t16_.end(), uint16_t(0));
         shuffle(t16_.begin(), t16_.end(), pcg64{});
@@ -259,11 +489,10 @@ namespace hfl::wrappers {
 
 
     uint16_t PearsonHash16Wrapper::HashImpl(const char *message, size_t length) const {
-        std::call_once(init_flag_, &PearsonHash16::Init, &hash_);
         return hash_(message, length);
     }
 
-    void PearsonHash24::Init() const {
+    PearsonHash24::PearsonHash24() {
         t12_.resize(table_size_);
         iota(t12_.begin(), t12_.end(), uint16_t(0));
         shuffle(t12_.begin(), t12_.end(), pcg32{});
@@ -289,17 +518,28 @@ namespace hfl::wrappers {
     }
 
     uint24_t PearsonHash24Wrapper::HashImpl(const char *message, size_t length) const {
-        std::call_once(init_flag_, &PearsonHash24::Init, &hash_);
         return hash_(message, length);
     }
 
+    // Заполняет общую таблицу pearson_hash_32/pearson_hash_64 при первом вызове
+    static void InitPearsonHashTable() {
+        static std::once_flag init_flag;
+        std::call_once(init_flag, pearson_hash_init);
+    }
+
+    PearsonHash32Wrapper::PearsonHash32Wrapper() {
+        InitPearsonHashTable();
+    }
+
+    PearsonHash64Wrapper::PearsonHash64Wrapper() {
+        InitPearsonHashTable();
+    }
+
     uint32_t PearsonHash32Wrapper::HashImpl(const char *message, size_t length) const {
-        std::call_once(init_flag_, pearson_hash_init);
         return pearson_hash_32(reinterpret_cast<const uint8_t*>(message), length, SEED_32);
     }
 
     uint64_t PearsonHash64Wrapper::HashImpl(const char *message, size_t length) const {
-        std::call_once(init_flag_, pearson_hash_init);
         return pearson_hash_64(reinterpret_cast<const uint8_t*>(message), length, SEED_64_1);
     }
 
@@ -309,6 +549,20 @@ namespace hfl::wrappers {
         return pengyhash(message, length, SEED_32);
     }
 
+    //-------------- SDBM --------------
+
+    SDBMHashWrapper<uint32_t>::SDBMHashWrapper()
+        : SDBMHashWrapper(SelectBestIsa<SDBMHashWrapper>()) {
+    }
+
+    SDBMHashWrapper<uint32_t>::SDBMHashWrapper(Isa isa)
+        : MultiLaneHasher(isa, {multi_lane::sse41::SDBMHash32, multi_lane::avx2::SDBMHash32}) {
+    }
+
+    uint32_t SDBMHashWrapper<uint32_t>::HashImpl(const char *message, size_t length) const {
+        return SDBMHash<uint32_t>(message, length);
+    }
+
     //------------- SIPHASH ------------
 
     uint64_t SipHashWrapper::HashImpl(const char *message, size_t length) const {
@@ -359,6 +613,51 @@ namespace hfl::wrappers {
         return t1ha2_atonce(message, length, SEED_64_1);
     }
 
+    bool T1HA0Wrapper::IsKernelSupported(Isa isa) {
+        if (std::find(isas.begin(), isas.end(), isa) == isas.end() || !IsIsaSupported(isa)) {
+            return false;
+        }
+        return isa == Isa::PORTABLE || (T1HA0_AESNI_AVAILABLE && IsAesSupported());
+    }
+
+    T1HA0Wrapper::T1HA0Wrapper()
+        : T1HA0Wrapper(SelectBestIsa<T1HA0Wrapper>()) {
+    }
+
+    T1HA0Wrapper::T1HA0Wrapper(Isa isa)
+        : isa_(isa)
+        , kernel_(nullptr) {
+        BOOST_ASSERT_MSG(IsKernelSupported(isa), "t1ha0 kernel is not supported");
+        switch (isa) {
+#if T1HA0_AESNI_AVAILABLE
+            case Isa::AVX2:
+                kernel_ = t1ha0_ia32aes_avx2;
+                break;
+            case Isa::AVX:
+                kernel_ = t1ha0_ia32aes_avx;
+                break;
+            case Isa::SSE2:
+                kernel_ = t1ha0_ia32aes_noavx;
+                break;
+#endif
+            default:
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+                kernel_ = t1ha1_le;
+#else
+                kernel_ = t1ha1_be;
+#endif
+                break;
+        }
+    }
+
+    Isa T1HA0Wrapper::GetIsa() const {
+        return isa_;
+    }
+
+    uint64_t T1HA0Wrapper::HashImpl(const char *message, size_t length) const {
+        return kernel_(message, length, SEED_64_1);
+    }
+
     //------------ wyHashes -----------
 
     uint32_t wyHash32Wrapper::HashImpl(const char *message, size_t length) const {
@@ -371,6 +670,20 @@ namespace hfl::wrappers {
 
     //------------ xxHash -----------
 
+    xxHash32Wrapper::xxHash32Wrapper()
+        : xxHash32Wrapper(SelectBestIsa<xxHash32Wrapper>()) {
+    }
+
+    xxHash32Wrapper::xxHash32Wrapper(Isa isa)
+        : MultiLaneHasher(isa, {
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::sse41::XXHash32(keys, num_keys, 0, hashes);
+            },
+            [](const std::string_view* keys, size_t num_keys, uint32_t* hashes) {
+                multi_lane::avx2::XXHash32(keys, num_keys, 0, hashes);
+            }}) {
+    }
+
     uint32_t xxHash32Wrapper::HashImpl(const char *message, size_t length) const {
         return XXH32(message, length, 0);
     }
@@ -379,11 +692,66 @@ namespace hfl::wrappers {
         return XXH64(message, length, 0);
     }
 
+    bool XXH3_64BitsWrapper::IsKernelSupported(Isa isa) {
+        return std::find(isas.begin(), isas.end(), isa) != isas.end() && IsIsaSupported(isa);
+    }
+
+    XXH3_64BitsWrapper::XXH3_64BitsWrapper()
+        : XXH3_64BitsWrapper(SelectBestIsa<XXH3_64BitsWrapper>()) {
+    }
+
+    XXH3_64BitsWrapper::XXH3_64BitsWrapper(Isa isa)
+        : isa_(isa)
+        , kernel_(nullptr) {
+        BOOST_ASSERT_MSG(IsKernelSupported(isa), "XXH3 kernel is not supported");
+        switch (isa) {
+            case Isa::AVX2:
+                kernel_ = XXH3_64bits_avx2;
+                break;
+            case Isa::SSE2:
+                kernel_ = XXH3_64bits_sse2;
+                break;
+            default:
+                kernel_ = XXH3_64bits_scalar;
+                break;
+        }
+    }
+
+    Isa XXH3_64BitsWrapper::GetIsa() const {
+        return isa_;
+    }
+
     uint64_t XXH3_64BitsWrapper::HashImpl(const char *message, size_t length) const {
-        return XXH3_64bits(message, length);
+        return kernel_(message, length);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> XXH3_64BitsWrapper::CreateStreamingState() const {
+        return CreateXXH3_64BitsStreamingState();
     }
 
+    // Получает секрет из сида так же, как XXH3_64bits_withSeed (через XXH3_64bits_reset_withSeed)
+    XXH3_64bits_withSeedWrapper::XXH3_64bits_withSeedWrapper() {
+        static_assert(secret_size_ == XXH3_SECRET_DEFAULT_SIZE);
+        XXH3_state_t state{};
+        XXH3_64bits_reset_withSeed(&state, SEED_64_1);
+        std::copy_n(state.customSecret, secret_size_, secret_.begin());
+    }
+
+    // Короткие сообщения хешируются с сидом (секрет для них не вычисляется),
+    // длинные - с заранее полученным секретом. Хеш-значения совпадают с XXH3_64bits_withSeed
     uint64_t XXH3_64bits_withSeedWrapper::HashImpl(const char *message, size_t length) const {
-        return XXH3_64bits_withSeed(message, length, SEED_64_1);
+        if (length <= XXH3_MIDSIZE_MAX) {
+            return XXH3_64bits_withSeed(message, length, SEED_64_1);
+        }
+        return XXH3_64bits_withSecret(message, length, secret_.data(), secret_.size());
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> XXH3_64bits_withSeedWrapper::CreateStreamingState() const {
+        return CreateXXH3_64BitsStreamingState(SEED_64_1);
+    }
+
+    uint128_t XXH3_128BitsWrapper::HashImpl(const char *message, size_t length) const {
+        const XXH128_hash_t hash = XXH3_128bits(message, length);
+        return MakeUint128(hash.high64, hash.low64);
     }
 }
\ No newline at end of file
@@ -4,36 +4,70 @@
 #include <array>
 #include <concepts>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <mutex>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 #include <boost/assert.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 
 #include <hash_functions.h>
+#include <highwayhash/highwayhash_target.h>
 #include <rolling_hash/cyclichash.h>
 
+#include "bit_width_uint.h"
+#include "isa.h"
+#include "mapped_file.h"
+#include "streaming_wrappers.h"
+
 // HFL = Hash function library
 namespace hfl {
     // 12-битное целое беззнаковое число
-    using uint12_t = boost::multiprecision::number<boost::multiprecision::cpp_int_backend<12, 12,
-            boost::multiprecision::unsigned_magnitude,
-            boost::multiprecision::unchecked, void>>;
+    using uint12_t = BitWidthUint<12>;
     // 24-битное целое беззнаковое число
-    using uint24_t = boost::multiprecision::number<boost::multiprecision::cpp_int_backend<24, 24,
-            boost::multiprecision::unsigned_magnitude,
-            boost::multiprecision::unchecked, void>>;
+    using uint24_t = BitWidthUint<24>;
     // 48-битное целое беззнаковое число
-    using uint48_t = boost::multiprecision::number<boost::multiprecision::cpp_int_backend<48, 48,
-            boost::multiprecision::unsigned_magnitude,
-            boost::multiprecision::unchecked, void>>;
+    using uint48_t = BitWidthUint<48>;
+
+    static_assert(std::is_trivially_copyable_v<uint24_t> && sizeof(uint24_t) == sizeof(uint32_t));
+    static_assert(std::is_trivially_copyable_v<uint48_t> && sizeof(uint48_t) == sizeof(uint64_t));
+
+    // Концепт для беззнаковых целых чисел. uint128_t перечислен отдельно: в строгом режиме стандарта
+    // std::is_integral_v для него ложно
+    template<typename T>
+    concept UnsignedIntegral = (std::is_integral_v<T> && !std::is_signed_v<T>) || is_bit_width_uint_v<T>
+                               || std::is_same_v<T, uint128_t>;
+
+    // Тип хеш-значения полной ширины: uint128_t для 128-битных хеш функций, uint64_t для остальных
+    template<UnsignedIntegral UintT>
+    using HashValueType = std::conditional_t<std::is_same_v<UintT, uint128_t>, uint128_t, uint64_t>;
 
-    // Концепт для беззнаковых целых чисел
+    // Число бит хеш-значения типа UintT
+    template<UnsignedIntegral UintT>
+    inline constexpr uint16_t hash_bits_v = std::is_same_v<UintT, uint128_t> ? 128 : std::numeric_limits<UintT>::digits;
+
+    // Составляет 128-битное хеш-значение из старшей и младшей 64-битных половин
+    constexpr uint128_t MakeUint128(uint64_t high, uint64_t low) {
+        return (static_cast<uint128_t>(high) << 64) | low;
+    }
+
+    // Приводит хеш-значение к uint64_t. 128-битное значение сворачивается (старшая половина XOR младшая),
+    // поэтому от результата зависят все биты хеша
     template<typename T>
-    concept UnsignedIntegral = (std::is_integral_v<T> && !std::is_signed_v<T>) || std::is_same_v<T, uint24_t>
-            || std::is_same_v<T, uint48_t>;
+    constexpr uint64_t FoldToUint64(T value) {
+        if constexpr (std::is_same_v<T, uint128_t>) {
+            return static_cast<uint64_t>(value >> 64) ^ static_cast<uint64_t>(value);
+        } else {
+            return static_cast<uint64_t>(value);
+        }
+    }
 }
 
 namespace hfl::wrappers::detail {
@@ -41,16 +75,40 @@ namespace hfl::wrappers::detail {
     template<UnsignedIntegral UintT>
     class BaseHashWrapper {
     public:
+        using UintType = UintT;
+
         // Методы для хеширования строки, бинарного файла и чисел
-        UintT Hash(const std::string& str) const;
+        UintT Hash(std::string_view str) const;
         UintT Hash(std::ifstream& file) const;
         UintT Hash(std::integral auto number) const;
 
+        // Метод для хеширования файла по пути. Файл отображается в память (MappedFile)
+        // и хешируется без копирования. Хеш-значение совпадает с Hash(std::ifstream&)
+        UintT HashFile(const std::filesystem::path& path) const;
+
+        // Методы для пакетного хеширования строк и 64-битных чисел.
+        // Хеш-значения приводятся к uint64_t (FoldToUint64) и записываются в hashes
+        void HashBatch(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const;
+        void HashBatch(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const;
+
+        // Создает состояние для потокового хеширования (Init/Update/Final). По умолчанию состояние
+        // накапливает сообщение в буфере и хеширует его в Final. Обертки над хеш функциями, которые
+        // поддерживают потоковое хеширование, перегружают этот метод.
+        // Состояние хранит ссылку на обертку и не должно ее пережить
+        [[nodiscard]] virtual std::unique_ptr<StreamingHashWrapper<UintT>> CreateStreamingState() const;
+
+        // Метод для хеширования потока (файла, канала, сокета) частями фиксированного размера
+        // через состояние для потокового хеширования. Хеш-значение совпадает с Hash(std::ifstream&)
+        UintT HashStream(std::istream& input) const;
+
         virtual ~BaseHashWrapper() = default;
 
     private:
         // Виртуальная функция хеширования. Перегружается в дочерних классах
         [[nodiscard]] virtual UintT HashImpl(const char *message, size_t length) const = 0;
+        // Виртуальные функции пакетного хеширования. Перегружаются в классе HashWrapper
+        virtual void HashBatchImpl(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const = 0;
+        virtual void HashBatchImpl(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const = 0;
         // Статичный метод, который считывает бинарный файл и записывает его в строку
         static std::string ReadFile(std::ifstream& file);
     };
@@ -58,7 +116,7 @@ namespace hfl::wrappers::detail {
 
     // Метод для хеширования строки
     template<UnsignedIntegral UintT>
-    UintT BaseHashWrapper<UintT>::Hash(const std::string& str) const {
+    UintT BaseHashWrapper<UintT>::Hash(std::string_view str) const {
         return HashImpl(str.data(), str.size());
     }
 
@@ -70,6 +128,28 @@ namespace hfl::wrappers::detail {
         return Hash(binary_file);
     }
 
+    // Метод для хеширования файла по пути
+    template<UnsignedIntegral UintT>
+    UintT BaseHashWrapper<UintT>::HashFile(const std::filesystem::path& path) const {
+        const MappedFile file(path);
+        BOOST_ASSERT_MSG(file.Size() != 0, "Could not read the file");
+        return Hash(file.GetData());
+    }
+
+    // Метод для хеширования потока частями фиксированного размера
+    template<UnsignedIntegral UintT>
+    UintT BaseHashWrapper<UintT>::HashStream(std::istream& input) const {
+        BOOST_ASSERT_MSG(input, "Could not open the stream");
+        constexpr size_t chunk_size = 1ull << 16;
+        std::vector<char> chunk(chunk_size);
+        const auto state = CreateStreamingState();
+        do {
+            input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            state->Update(chunk.data(), static_cast<size_t>(input.gcount()));
+        } while (input);
+        return state->Final();
+    }
+
     // Метод для хеширования чисел
     template<UnsignedIntegral UintT>
     UintT BaseHashWrapper<UintT>::Hash(std::integral auto number) const {
@@ -78,21 +158,185 @@ namespace hfl::wrappers::detail {
         return HashImpl(bytes, length);
     }
 
+    // Метод для пакетного хеширования строк
+    template<UnsignedIntegral UintT>
+    void BaseHashWrapper<UintT>::HashBatch(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const {
+        BOOST_ASSERT_MSG(keys.size() == hashes.size(), "keys.size() != hashes.size()");
+        HashBatchImpl(keys, hashes);
+    }
+
+    // Метод для пакетного хеширования чисел
+    template<UnsignedIntegral UintT>
+    void BaseHashWrapper<UintT>::HashBatch(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const {
+        BOOST_ASSERT_MSG(numbers.size() == hashes.size(), "numbers.size() != hashes.size()");
+        HashBatchImpl(numbers, hashes);
+    }
+
     // Статичный метод, который считывает бинарный файл и записывает его в строку
     template<UnsignedIntegral UintT>
     std::string BaseHashWrapper<UintT>::ReadFile(std::ifstream& file) {
         BOOST_ASSERT_MSG(file, "Could not open the file");
         std::string result;
-        size_t source_size = 0;
+
+        // Если размер файла известен, файл читается одним вызовом read без перевыделений строки
+        const std::streampos start = file.tellg();
+        file.seekg(0, std::ios_base::end);
+        const std::streampos end = file.tellg();
+        if (start != std::streampos(-1) && end != std::streampos(-1)) {
+            file.seekg(start);
+            result.resize(static_cast<size_t>(end - start));
+            file.read(result.data(), static_cast<std::streamsize>(result.size()));
+            result.resize(static_cast<size_t>(file.gcount()));
+            return result;
+        }
+
+        file.clear();
         do {
             char buff[1024];
             file.read(buff, sizeof buff);
             size_t read_size = file.gcount();
-            source_size += read_size;
             result.append(buff, read_size);
         } while (file);
         return result;
     }
+
+    // Потоковое хеширование для хеш функций без собственного потокового интерфейса:
+    // части сообщения накапливаются в буфере, который хешируется целиком в Final
+    template<UnsignedIntegral UintT>
+    class BufferedStreamingWrapper final : public StreamingHashWrapper<UintT> {
+    public:
+        explicit BufferedStreamingWrapper(const BaseHashWrapper<UintT>& hash)
+                : hash_(hash) {
+        }
+
+        void Init() override {
+            buffer_.clear();
+        }
+
+        void Update(const char* message, size_t length) override {
+            buffer_.append(message, length);
+        }
+
+        UintT Final() override {
+            const UintT hash = hash_.Hash(buffer_);
+            buffer_.clear();
+            return hash;
+        }
+
+        [[nodiscard]] bool IsBuffered() const override {
+            return true;
+        }
+
+    private:
+        const BaseHashWrapper<UintT>& hash_;    // Обертка над хеш функцией
+        std::string buffer_;                    // Накопленное сообщение
+    };
+
+    // Создает состояние для потокового хеширования, которое накапливает сообщение в буфере
+    template<UnsignedIntegral UintT>
+    std::unique_ptr<StreamingHashWrapper<UintT>> BaseHashWrapper<UintT>::CreateStreamingState() const {
+        return std::make_unique<BufferedStreamingWrapper<UintT>>(*this);
+    }
+
+    // Многоканальное ядро (HashLib multi_lane): хеширует num_keys ключей в дорожках векторных регистров
+    using MultiLaneKernel = void (*)(const std::string_view* keys, size_t num_keys, uint32_t* hashes);
+
+    /*
+     *  Базовый класс для 32-битных оберток с многоканальными ядрами: при пакетном хешировании ключи
+     *  хешируются по 4 (SSE4.1) или 8 (AVX2) одновременно, каждый в своей дорожке векторного регистра.
+     *  Хеш-значения совпадают с HashImpl обертки. Ядро выбирается во время выполнения (см. SelectBestIsa),
+     *  с Isa::PORTABLE пакет хешируется в цикле HashImpl
+     */
+    class MultiLaneHasher {
+    public:
+        // Наборы инструкций, для которых есть многоканальные ядра (от лучшего к худшему)
+        static constexpr std::array isas{Isa::AVX2, Isa::SSE41, Isa::PORTABLE};
+
+        // Проверяет, можно ли выполнить ядро для набора инструкций isa на текущем процессоре
+        static bool IsKernelSupported(Isa isa);
+
+        // Возвращает число ключей, которые ядро для набора инструкций isa хеширует одновременно
+        static size_t NumLanes(Isa isa);
+
+        // Возвращает набор инструкций ядра
+        [[nodiscard]] Isa GetIsa() const;
+
+        // Хешируют пакет строк или 64-битных чисел многоканальным ядром.
+        // Возвращают false, если многоканального ядра нет (Isa::PORTABLE)
+        bool HashLanes(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const;
+        bool HashLanes(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const;
+
+    protected:
+        // Многоканальные ядра хеш функции для SSE4.1 и AVX2
+        struct Kernels {
+            MultiLaneKernel sse41;
+            MultiLaneKernel avx2;
+        };
+
+        // Использует ядро из kernels для набора инструкций isa (должно поддерживаться процессором)
+        MultiLaneHasher(Isa isa, Kernels kernels);
+
+    private:
+        // Число ключей, которые передаются ядру за один вызов
+        static constexpr size_t max_keys_per_call = 256;
+
+        Isa isa_;
+        MultiLaneKernel kernel_;
+    };
+
+    // Шаблонный класс-посредник между BaseHashWrapper и оберткой Derived (CRTP).
+    // Реализует пакетное хеширование: HashImpl класса Derived вызывается в цикле
+    // без виртуальной диспетчеризации на каждый ключ. Обертки с многоканальными ядрами
+    // (MultiLaneHasher) хешируют пакет ядром
+    template<UnsignedIntegral UintT, typename Derived>
+    class HashWrapper : public BaseHashWrapper<UintT> {
+    public:
+        // Невиртуальный вызов HashImpl класса Derived.
+        // Используется, когда тип обертки известен на этапе компиляции (см. hfl::StaticHash)
+        [[nodiscard]] UintT HashDirect(const char *message, size_t length) const;
+
+    private:
+        void HashBatchImpl(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const final;
+        void HashBatchImpl(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const final;
+    };
+
+    // Невиртуальный вызов HashImpl класса Derived
+    template<UnsignedIntegral UintT, typename Derived>
+    UintT HashWrapper<UintT, Derived>::HashDirect(const char *message, size_t length) const {
+        return static_cast<const Derived&>(*this).Derived::HashImpl(message, length);
+    }
+
+    // Пакетное хеширование строк
+    template<UnsignedIntegral UintT, typename Derived>
+    void HashWrapper<UintT, Derived>::HashBatchImpl(std::span<const std::string_view> keys,
+                                                    std::span<uint64_t> hashes) const {
+        if constexpr (std::is_base_of_v<MultiLaneHasher, Derived>) {
+            if (static_cast<const Derived&>(*this).HashLanes(keys, hashes)) {
+                return;
+            }
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const UintT hash = HashDirect(keys[i].data(), keys[i].size());
+            hashes[i] = FoldToUint64(hash);
+        }
+    }
+
+    // Пакетное хеширование чисел
+    template<UnsignedIntegral UintT, typename Derived>
+    void HashWrapper<UintT, Derived>::HashBatchImpl(std::span<const uint64_t> numbers,
+                                                    std::span<uint64_t> hashes) const {
+        if constexpr (std::is_base_of_v<MultiLaneHasher, Derived>) {
+            if (static_cast<const Derived&>(*this).HashLanes(numbers, hashes)) {
+                return;
+            }
+        }
+        constexpr size_t length = sizeof(uint64_t);
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            const char* bytes = reinterpret_cast<const char*>(reinterpret_cast<const void*>(&numbers[i]));
+            const UintT hash = HashDirect(bytes, length);
+            hashes[i] = FoldToUint64(hash);
+        }
+    }
 }
 
 namespace hfl::wrappers {
@@ -102,11 +346,38 @@ namespace hfl::wrappers {
     using BaseHash32Wrapper = detail::BaseHashWrapper<uint32_t>;
     using BaseHash48Wrapper = detail::BaseHashWrapper<uint48_t>;
     using BaseHash64Wrapper = detail::BaseHashWrapper<uint64_t>;
+    using BaseHash128Wrapper = detail::BaseHashWrapper<uint128_t>;
+
+    // Псевдонимы для HashWrapper
+    template<typename Derived> using Hash16Wrapper = detail::HashWrapper<uint16_t, Derived>;
+    template<typename Derived> using Hash24Wrapper = detail::HashWrapper<uint24_t, Derived>;
+    template<typename Derived> using Hash32Wrapper = detail::HashWrapper<uint32_t, Derived>;
+    template<typename Derived> using Hash48Wrapper = detail::HashWrapper<uint48_t, Derived>;
+    template<typename Derived> using Hash64Wrapper = detail::HashWrapper<uint64_t, Derived>;
+    template<typename Derived> using Hash128Wrapper = detail::HashWrapper<uint128_t, Derived>;
+
+    /*
+     *  Выбирает ядро обертки с ядрами для разных наборов инструкций
+     *  Параметр шаблона: Wrapper - обертка со статическими полем isas (наборы инструкций,
+     *  от лучшего к худшему) и методом IsKernelSupported(isa)
+     *  Выходное значение: первый набор инструкций из Wrapper::isas, ядро для которого можно
+     *  выполнить на текущем процессоре
+     */
+    template<typename Wrapper>
+    Isa SelectBestIsa() {
+        for (const Isa isa : Wrapper::isas) {
+            if (Wrapper::IsKernelSupported(isa)) {
+                return isa;
+            }
+        }
+        return Isa::PORTABLE;
+    }
 
     //----- Bernstein's hash DJB2 ------
 
     template<UnsignedIntegral UintT>
-    class [[maybe_unused]] DJB2HashWrapper final : public detail::BaseHashWrapper<UintT> {
+    class [[maybe_unused]] DJB2HashWrapper final : public detail::HashWrapper<UintT, DJB2HashWrapper<UintT>> {
+        friend detail::HashWrapper<UintT, DJB2HashWrapper<UintT>>;
     private:
         [[nodiscard]] UintT HashImpl(const char *message, size_t length) const override;
     };
@@ -116,18 +387,33 @@ namespace hfl::wrappers {
         return DJB2Hash<UintT>(message, length);
     }
 
+    template<>
+    class [[maybe_unused]] DJB2HashWrapper<uint32_t> final : public Hash32Wrapper<DJB2HashWrapper<uint32_t>>,
+                                                            public detail::MultiLaneHasher {
+        friend Hash32Wrapper<DJB2HashWrapper<uint32_t>>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        DJB2HashWrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit DJB2HashWrapper(Isa isa);
+
+    private:
+        [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
+    };
+
 
     //----- Rolling Hash (BuzHash) -----
 
     template<UnsignedIntegral UintT>
-    class [[maybe_unused]] BuzHashWrapper final : public detail::BaseHashWrapper<UintT> {
+    class [[maybe_unused]] BuzHashWrapper final : public detail::HashWrapper<UintT, BuzHashWrapper<UintT>> {
+        friend detail::HashWrapper<UintT, BuzHashWrapper<UintT>>;
     public:
         BuzHashWrapper() noexcept = default;
 
     private:
         UintT HashImpl(const char *message, size_t length) const override;
 
-        mutable CyclicHash<UintT, char> hasher_{4096, sizeof(UintT) * 8};
+        mutable CyclicHash<UintT, unsigned char> hasher_{4096, sizeof(UintT) * 8};
     };
 
     template<UnsignedIntegral UintT>
@@ -138,118 +424,207 @@ namespace hfl::wrappers {
 
     //----------- CityHashes ----------
 
-    class [[maybe_unused]] CityHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] CityHash32Wrapper final : public Hash32Wrapper<CityHash32Wrapper> {
+        friend Hash32Wrapper<CityHash32Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] CityHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] CityHash64Wrapper final : public Hash64Wrapper<CityHash64Wrapper> {
+        friend Hash64Wrapper<CityHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] CityHash64WithSeedWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] CityHash64WithSeedWrapper final : public Hash64Wrapper<CityHash64WithSeedWrapper> {
+        friend Hash64Wrapper<CityHash64WithSeedWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] CityHash64WithSeedsWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] CityHash64WithSeedsWrapper final : public Hash64Wrapper<CityHash64WithSeedsWrapper> {
+        friend Hash64Wrapper<CityHash64WithSeedsWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
+    class [[maybe_unused]] CityHash128Wrapper final : public Hash128Wrapper<CityHash128Wrapper> {
+        friend Hash128Wrapper<CityHash128Wrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+    };
+
+    class [[maybe_unused]] CityHash128WithSeedWrapper final : public Hash128Wrapper<CityHash128WithSeedWrapper> {
+        friend Hash128Wrapper<CityHash128WithSeedWrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+    };
+
     //----------- FarmHashes ----------
 
-    class [[maybe_unused]] FarmHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] FarmHash32Wrapper final : public Hash32Wrapper<FarmHash32Wrapper> {
+        friend Hash32Wrapper<FarmHash32Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FarmHash32WithSeedWrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] FarmHash32WithSeedWrapper final : public Hash32Wrapper<FarmHash32WithSeedWrapper> {
+        friend Hash32Wrapper<FarmHash32WithSeedWrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FarmHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] FarmHash64Wrapper final : public Hash64Wrapper<FarmHash64Wrapper> {
+        friend Hash64Wrapper<FarmHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FarmHash64WithSeedWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] FarmHash64WithSeedWrapper final : public Hash64Wrapper<FarmHash64WithSeedWrapper> {
+        friend Hash64Wrapper<FarmHash64WithSeedWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FarmHash64WithSeedsWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] FarmHash64WithSeedsWrapper final : public Hash64Wrapper<FarmHash64WithSeedsWrapper> {
+        friend Hash64Wrapper<FarmHash64WithSeedsWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
 //------------ FastHash ------------
 
-    class [[maybe_unused]] FastHash16Wrapper final : public BaseHash16Wrapper {
+    class [[maybe_unused]] FastHash16Wrapper final : public Hash16Wrapper<FastHash16Wrapper> {
+        friend Hash16Wrapper<FastHash16Wrapper>;
     private:
         [[nodiscard]] uint16_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FastHash24Wrapper final : public BaseHash24Wrapper {
+    class [[maybe_unused]] FastHash24Wrapper final : public Hash24Wrapper<FastHash24Wrapper> {
+        friend Hash24Wrapper<FastHash24Wrapper>;
     private:
         [[nodiscard]] uint24_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FastHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] FastHash32Wrapper final : public Hash32Wrapper<FastHash32Wrapper> {
+        friend Hash32Wrapper<FastHash32Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FastHash48Wrapper final : public BaseHash48Wrapper {
+    class [[maybe_unused]] FastHash48Wrapper final : public Hash48Wrapper<FastHash48Wrapper> {
+        friend Hash48Wrapper<FastHash48Wrapper>;
     private:
         [[nodiscard]] uint48_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FastHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] FastHash64Wrapper final : public Hash64Wrapper<FastHash64Wrapper> {
+        friend Hash64Wrapper<FastHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
 //---------- FNV-1a hash -----------
 
-    class [[maybe_unused]] FNV1aHash16Wrapper final : public BaseHash16Wrapper {
+    class [[maybe_unused]] FNV1aHash16Wrapper final : public Hash16Wrapper<FNV1aHash16Wrapper> {
+        friend Hash16Wrapper<FNV1aHash16Wrapper>;
     private:
         [[nodiscard]] uint16_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FNV1aHash24Wrapper final : public BaseHash24Wrapper {
+    class [[maybe_unused]] FNV1aHash24Wrapper final : public Hash24Wrapper<FNV1aHash24Wrapper> {
+        friend Hash24Wrapper<FNV1aHash24Wrapper>;
     private:
         [[nodiscard]] uint24_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FNV1aHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] FNV1aHash32Wrapper final : public Hash32Wrapper<FNV1aHash32Wrapper>,
+                                                      public detail::MultiLaneHasher {
+        friend Hash32Wrapper<FNV1aHash32Wrapper>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        FNV1aHash32Wrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit FNV1aHash32Wrapper(Isa isa);
+
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FNV1aHash48Wrapper final : public BaseHash48Wrapper {
+    class [[maybe_unused]] FNV1aHash48Wrapper final : public Hash48Wrapper<FNV1aHash48Wrapper> {
+        friend Hash48Wrapper<FNV1aHash48Wrapper>;
     private:
         [[nodiscard]] uint48_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] FNV1aHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] FNV1aHash64Wrapper final : public Hash64Wrapper<FNV1aHash64Wrapper> {
+        friend Hash64Wrapper<FNV1aHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
     //---------- HighwayHash -----------
 
-    class [[maybe_unused]] HighwayHashWrapper final : public BaseHash64Wrapper {
+    namespace detail {
+        // Состояние HighwayHash, вычисленное из ключа один раз, для ядра одного набора инструкций
+#if HH_ARCH_X64
+        using HighwayHashState = std::variant<highwayhash::HighwayHashKeyed<HH_TARGET_Portable>,
+                                              highwayhash::HighwayHashKeyed<HH_TARGET_SSE41>,
+                                              highwayhash::HighwayHashKeyed<HH_TARGET_AVX2>>;
+#else
+        using HighwayHashState = std::variant<highwayhash::HighwayHashKeyed<HH_TARGET_Portable>>;
+#endif
+
+        // Вычисляет состояние HighwayHash с ключом из сидов SEED_64_* для ядра набора инструкций isa
+        HighwayHashState MakeHighwayHashState(Isa isa);
+    }
+
+    // Ядро HighwayHash выбирается во время выполнения. Начальное состояние ядра вычисляется
+    // из ключа в конструкторе, HashImpl хеширует его копию. Хеш-значения всех ядер совпадают
+    class [[maybe_unused]] HighwayHashWrapper final : public Hash64Wrapper<HighwayHashWrapper> {
+        friend Hash64Wrapper<HighwayHashWrapper>;
+    public:
+        // Наборы инструкций, для которых есть ядра (от лучшего к худшему)
+        static constexpr std::array isas{Isa::AVX2, Isa::SSE41, Isa::PORTABLE};
+
+        // Проверяет, можно ли выполнить ядро для набора инструкций isa на текущем процессоре
+        static bool IsKernelSupported(Isa isa);
+
+        // Использует наилучшее ядро, которое поддерживает процессор
+        HighwayHashWrapper();
+        // Использует ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit HighwayHashWrapper(Isa isa);
+
+        // Возвращает набор инструкций ядра
+        [[nodiscard]] Isa GetIsa() const;
+
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
+
+        Isa isa_;
+        detail::HighwayHashState state_;
+    };
+
+    // 128-битный HighwayHash. Ядро выбирается в конструкторе так же, как в HighwayHashWrapper.
+    // 256-битный HighwayHash не входит в обертки: его хеш-значение не помещается в uint128_t
+    class [[maybe_unused]] HighwayHash128Wrapper final : public Hash128Wrapper<HighwayHash128Wrapper> {
+        friend Hash128Wrapper<HighwayHash128Wrapper>;
+    public:
+        HighwayHash128Wrapper();
+
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+
+        detail::HighwayHashState state_;
     };
 
     //--------- Jenkins hash -----------
 
     template<UnsignedIntegral UintT>
-    class [[maybe_unused]] OneTimeHashWrapper final : public detail::BaseHashWrapper<UintT> {
+    class [[maybe_unused]] OneTimeHashWrapper final : public detail::HashWrapper<UintT, OneTimeHashWrapper<UintT>> {
+        friend detail::HashWrapper<UintT, OneTimeHashWrapper<UintT>>;
     private:
         [[nodiscard]] UintT HashImpl(const char *message, size_t length) const override;
     };
@@ -260,99 +635,170 @@ namespace hfl::wrappers {
         return one_at_a_time_hash<UintT>(key, length);
     }
 
-    class [[maybe_unused]] SpookyHash16Wrapper final : public BaseHash16Wrapper {
+    template<>
+    class [[maybe_unused]] OneTimeHashWrapper<uint32_t> final : public Hash32Wrapper<OneTimeHashWrapper<uint32_t>>,
+                                                               public detail::MultiLaneHasher {
+        friend Hash32Wrapper<OneTimeHashWrapper<uint32_t>>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        OneTimeHashWrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit OneTimeHashWrapper(Isa isa);
+
+    private:
+        [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
+    };
+
+    class [[maybe_unused]] SpookyHash16Wrapper final : public Hash16Wrapper<SpookyHash16Wrapper> {
+        friend Hash16Wrapper<SpookyHash16Wrapper>;
+    public:
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint16_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint16_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SpookyHash24Wrapper final : public BaseHash24Wrapper {
+    class [[maybe_unused]] SpookyHash24Wrapper final : public Hash24Wrapper<SpookyHash24Wrapper> {
+        friend Hash24Wrapper<SpookyHash24Wrapper>;
+    public:
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint24_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint24_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SpookyHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] SpookyHash32Wrapper final : public Hash32Wrapper<SpookyHash32Wrapper> {
+        friend Hash32Wrapper<SpookyHash32Wrapper>;
+    public:
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint32_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SpookyHash48Wrapper final : public BaseHash48Wrapper {
+    class [[maybe_unused]] SpookyHash48Wrapper final : public Hash48Wrapper<SpookyHash48Wrapper> {
+        friend Hash48Wrapper<SpookyHash48Wrapper>;
+    public:
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint48_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint48_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SpookyHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] SpookyHash64Wrapper final : public Hash64Wrapper<SpookyHash64Wrapper> {
+        friend Hash64Wrapper<SpookyHash64Wrapper>;
+    public:
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
+    class [[maybe_unused]] SpookyHash128Wrapper final : public Hash128Wrapper<SpookyHash128Wrapper> {
+        friend Hash128Wrapper<SpookyHash128Wrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+    };
+
 
     //------------ MetroHash -----------
 
-    class [[maybe_unused]] MetroHash64_Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] MetroHash64_Wrapper final : public Hash64Wrapper<MetroHash64_Wrapper> {
+        friend Hash64Wrapper<MetroHash64_Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
     //---------- MurmurHashes ---------
 
-    class [[maybe_unused]] MurmurHash1Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] MurmurHash1Wrapper final : public Hash32Wrapper<MurmurHash1Wrapper> {
+        friend Hash32Wrapper<MurmurHash1Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] MurmurHash2Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] MurmurHash2Wrapper final : public Hash32Wrapper<MurmurHash2Wrapper> {
+        friend Hash32Wrapper<MurmurHash2Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
-    class [[maybe_unused]] MurmurHash2AWrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] MurmurHash2AWrapper final : public Hash32Wrapper<MurmurHash2AWrapper> {
+        friend Hash32Wrapper<MurmurHash2AWrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] MurmurHash64AWrapper final : public BaseHash64Wrapper  {
+    class [[maybe_unused]] MurmurHash64AWrapper final : public Hash64Wrapper<MurmurHash64AWrapper> {
+        friend Hash64Wrapper<MurmurHash64AWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] MurmurHash3Wrapper final : public BaseHash32Wrapper  {
+    class [[maybe_unused]] MurmurHash3Wrapper final : public Hash32Wrapper<MurmurHash3Wrapper>,
+                                                      public detail::MultiLaneHasher {
+        friend Hash32Wrapper<MurmurHash3Wrapper>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        MurmurHash3Wrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit MurmurHash3Wrapper(Isa isa);
+
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
+    class [[maybe_unused]] MurmurHash3_x86_128Wrapper final : public Hash128Wrapper<MurmurHash3_x86_128Wrapper> {
+        friend Hash128Wrapper<MurmurHash3_x86_128Wrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+    };
+
+    class [[maybe_unused]] MurmurHash3_x64_128Wrapper final : public Hash128Wrapper<MurmurHash3_x64_128Wrapper> {
+        friend Hash128Wrapper<MurmurHash3_x64_128Wrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
+    };
+
     //----------- MUM/mir -----------
 
-    class [[maybe_unused]] MumHashWrapper final : public BaseHash64Wrapper  {
+    class [[maybe_unused]] MumHashWrapper final : public Hash64Wrapper<MumHashWrapper> {
+        friend Hash64Wrapper<MumHashWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] MirHashWrapper final : public BaseHash64Wrapper  {
+    class [[maybe_unused]] MirHashWrapper final : public Hash64Wrapper<MirHashWrapper> {
+        friend Hash64Wrapper<MirHashWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
     //------------- MX3 --------------
 
-    class [[maybe_unused]] MX3HashWrapper final : public BaseHash64Wrapper  {
+    class [[maybe_unused]] MX3HashWrapper final : public Hash64Wrapper<MX3HashWrapper> {
+        friend Hash64Wrapper<MX3HashWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
     //------------ NMHASH ------------
 
-    class [[maybe_unused]] nmHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] nmHash32Wrapper final : public Hash32Wrapper<nmHash32Wrapper> {
+        friend Hash32Wrapper<nmHash32Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] nmHash32XWrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] nmHash32XWrapper final : public Hash32Wrapper<nmHash32XWrapper> {
+        friend Hash32Wrapper<nmHash32XWrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
     //--- Paul Hsieh's SuperFastHash ---
 
-    class [[maybe_unused]] SuperFastHashWrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] SuperFastHashWrapper final : public Hash32Wrapper<SuperFastHashWrapper> {
+        friend Hash32Wrapper<SuperFastHashWrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
@@ -361,66 +807,75 @@ namespace hfl::wrappers {
 
     class [[maybe_unused]] PearsonHash16 {
     public:
+        // Заполняет таблицу перестановки
+        PearsonHash16();
+
         uint16_t operator()(const char *message, size_t length) const;
         uint16_t operator()(const std::string& message) const;
-        void Init() const;
     private:
 
-        mutable std::vector<uint16_t> t16_;
         const uint32_t table_size_ = 65536;
         const uint16_t mask_ = 65535;
+        std::vector<uint16_t> t16_;
     };
 
-    class [[maybe_unused]] PearsonHash16Wrapper final : public BaseHash16Wrapper {
+    class [[maybe_unused]] PearsonHash16Wrapper final : public Hash16Wrapper<PearsonHash16Wrapper> {
+        friend Hash16Wrapper<PearsonHash16Wrapper>;
     private:
         uint16_t HashImpl(const char *message, size_t length) const override;
 
-        mutable std::once_flag init_flag_;
         PearsonHash16 hash_;
     };
 
     class [[maybe_unused]] PearsonHash24 {
     public:
+        // Заполняет таблицу перестановки
+        PearsonHash24();
+
         uint24_t operator()(const char *message, size_t length) const;
         uint24_t operator()(const std::string& message) const;
-        void Init() const;
 
     private:
-        mutable std::vector<uint32_t> t12_;
         const uint16_t shift6_ = 6;
         const uint16_t shift12_ = 12;
         const uint32_t table_size_ = 1ull << shift12_;
         const uint32_t bits_mask_ = table_size_ - 1;
         const uint24_t hash_mask_ = 0x020100;
-
+        std::vector<uint32_t> t12_;
     };
 
-    class [[maybe_unused]] PearsonHash24Wrapper final : public BaseHash24Wrapper {
+    class [[maybe_unused]] PearsonHash24Wrapper final : public Hash24Wrapper<PearsonHash24Wrapper> {
+        friend Hash24Wrapper<PearsonHash24Wrapper>;
     private:
         [[nodiscard]] uint24_t HashImpl(const char *message, size_t length) const override;
 
-        mutable std::once_flag init_flag_;
         PearsonHash24 hash_;
     };
 
+    // Обертки над pearson_hash_32 и pearson_hash_64. Общая таблица библиотеки
+    // заполняется (один раз) при создании первой обертки, а не при каждом хешировании
+    class [[maybe_unused]] PearsonHash32Wrapper final : public Hash32Wrapper<PearsonHash32Wrapper> {
+        friend Hash32Wrapper<PearsonHash32Wrapper>;
+    public:
+        PearsonHash32Wrapper();
 
-    class [[maybe_unused]] PearsonHash32Wrapper final : public BaseHash32Wrapper {
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
-
-        mutable std::once_flag init_flag_;
     };
 
-    class [[maybe_unused]] PearsonHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] PearsonHash64Wrapper final : public Hash64Wrapper<PearsonHash64Wrapper> {
+        friend Hash64Wrapper<PearsonHash64Wrapper>;
+    public:
+        PearsonHash64Wrapper();
+
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
-
-        mutable std::once_flag init_flag_;
     };
 
     //----------- PengyHash ------------
 
-    class [[maybe_unused]] PengyHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] PengyHash64Wrapper final : public Hash64Wrapper<PengyHash64Wrapper> {
+        friend Hash64Wrapper<PengyHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
@@ -428,7 +883,8 @@ namespace hfl::wrappers {
     //------------ PJW Hash ------------
 
     template<UnsignedIntegral UintT>
-    class [[maybe_unused]] PJWHashWrapper final : public detail::BaseHashWrapper<UintT> {
+    class [[maybe_unused]] PJWHashWrapper final : public detail::HashWrapper<UintT, PJWHashWrapper<UintT>> {
+        friend detail::HashWrapper<UintT, PJWHashWrapper<UintT>>;
     private:
         [[nodiscard]] UintT HashImpl(const char *message, size_t length) const override;
     };
@@ -439,7 +895,8 @@ namespace hfl::wrappers {
     }
 
     template<>
-    class [[maybe_unused]] PJWHashWrapper<uint24_t> final : public detail::BaseHashWrapper<uint24_t> {
+    class [[maybe_unused]] PJWHashWrapper<uint24_t> final : public Hash24Wrapper<PJWHashWrapper<uint24_t>> {
+        friend Hash24Wrapper<PJWHashWrapper<uint24_t>>;
     private:
         [[nodiscard]] uint24_t HashImpl(const char *message, size_t length) const override {
             return PJWHash<uint24_t, 24>(message, length);
@@ -447,7 +904,8 @@ namespace hfl::wrappers {
     };
 
     template<>
-    class [[maybe_unused]] PJWHashWrapper<uint48_t> final : public detail::BaseHashWrapper<uint48_t> {
+    class [[maybe_unused]] PJWHashWrapper<uint48_t> final : public Hash48Wrapper<PJWHashWrapper<uint48_t>> {
+        friend Hash48Wrapper<PJWHashWrapper<uint48_t>>;
     private:
         [[nodiscard]] uint48_t HashImpl(const char *message, size_t length) const override {
             return PJWHash<uint48_t, 48>(message, length);
@@ -457,7 +915,8 @@ namespace hfl::wrappers {
     //-------------- SDBM --------------
 
     template<UnsignedIntegral UintT>
-    class [[maybe_unused]] SDBMHashWrapper final : public detail::BaseHashWrapper<UintT> {
+    class [[maybe_unused]] SDBMHashWrapper final : public detail::HashWrapper<UintT, SDBMHashWrapper<UintT>> {
+        friend detail::HashWrapper<UintT, SDBMHashWrapper<UintT>>;
     private:
         [[nodiscard]] UintT HashImpl(const char *message, size_t length) const override;
     };
@@ -467,78 +926,181 @@ namespace hfl::wrappers {
         return SDBMHash<UintT>(message, length);
     }
 
+    template<>
+    class [[maybe_unused]] SDBMHashWrapper<uint32_t> final : public Hash32Wrapper<SDBMHashWrapper<uint32_t>>,
+                                                            public detail::MultiLaneHasher {
+        friend Hash32Wrapper<SDBMHashWrapper<uint32_t>>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        SDBMHashWrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit SDBMHashWrapper(Isa isa);
+
+    private:
+        [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
+    };
+
     //------------- SipHash ------------
 
-    class [[maybe_unused]] SipHashWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] SipHashWrapper final : public Hash64Wrapper<SipHashWrapper> {
+        friend Hash64Wrapper<SipHashWrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
 
-    class [[maybe_unused]] SipHash13Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] SipHash13Wrapper final : public Hash64Wrapper<SipHash13Wrapper> {
+        friend Hash64Wrapper<SipHash13Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SipHashAVX2Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] SipHashAVX2Wrapper final : public Hash64Wrapper<SipHashAVX2Wrapper> {
+        friend Hash64Wrapper<SipHashAVX2Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] SipHash13AVX2Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] SipHash13AVX2Wrapper final : public Hash64Wrapper<SipHash13AVX2Wrapper> {
+        friend Hash64Wrapper<SipHash13AVX2Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] HalfSipHashWrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] HalfSipHashWrapper final : public Hash32Wrapper<HalfSipHashWrapper> {
+        friend Hash32Wrapper<HalfSipHashWrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
     //-------------- T1HA --------------
 
-    class [[maybe_unused]] T1HA1Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] T1HA1Wrapper final : public Hash64Wrapper<T1HA1Wrapper> {
+        friend Hash64Wrapper<T1HA1Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] T1HA2Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] T1HA2Wrapper final : public Hash64Wrapper<T1HA2Wrapper> {
+        friend Hash64Wrapper<T1HA2Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
+    // Ядро t1ha0 выбирается во время выполнения: с AES-NI - t1ha0_ia32aes_noavx/avx/avx2, без него - t1ha1_le
+    // (так же выбирает t1ha0_resolve). Хеш-значения ядер различаются (noavx и avx совпадают между собой),
+    // поэтому t1ha0 не входит в реестр и используется только в тестах скорости
+    class [[maybe_unused]] T1HA0Wrapper final : public Hash64Wrapper<T1HA0Wrapper> {
+        friend Hash64Wrapper<T1HA0Wrapper>;
+    public:
+        // Наборы инструкций, для которых есть ядра (от лучшего к худшему)
+        static constexpr std::array isas{Isa::AVX2, Isa::AVX, Isa::SSE2, Isa::PORTABLE};
+
+        // Проверяет, можно ли выполнить ядро для набора инструкций isa на текущем процессоре
+        static bool IsKernelSupported(Isa isa);
+
+        // Использует наилучшее ядро, которое поддерживает процессор
+        T1HA0Wrapper();
+        // Использует ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit T1HA0Wrapper(Isa isa);
+
+        // Возвращает набор инструкций ядра
+        [[nodiscard]] Isa GetIsa() const;
+
+    private:
+        [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
+
+        using Kernel = uint64_t (*)(const void*, size_t, uint64_t);
+
+        Isa isa_;
+        Kernel kernel_;
+    };
+
     //------------ wyHashes -----------
 
-    class [[maybe_unused]] wyHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] wyHash32Wrapper final : public Hash32Wrapper<wyHash32Wrapper> {
+        friend Hash32Wrapper<wyHash32Wrapper>;
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] wyHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] wyHash64Wrapper final : public Hash64Wrapper<wyHash64Wrapper> {
+        friend Hash64Wrapper<wyHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
     //------------ xxHashes -----------
 
-    class [[maybe_unused]] xxHash32Wrapper final : public BaseHash32Wrapper {
+    class [[maybe_unused]] xxHash32Wrapper final : public Hash32Wrapper<xxHash32Wrapper>,
+                                                   public detail::MultiLaneHasher {
+        friend Hash32Wrapper<xxHash32Wrapper>;
+    public:
+        // Использует наилучшее многоканальное ядро, которое поддерживает процессор
+        xxHash32Wrapper();
+        // Использует многоканальное ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit xxHash32Wrapper(Isa isa);
+
     private:
         [[nodiscard]] uint32_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] xxHash64Wrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] xxHash64Wrapper final : public Hash64Wrapper<xxHash64Wrapper> {
+        friend Hash64Wrapper<xxHash64Wrapper>;
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
     };
 
-    class [[maybe_unused]] XXH3_64BitsWrapper final : public BaseHash64Wrapper {
+    // Ядро XXH3 выбирается во время выполнения (xx_hash/xxh3_targets.h). Хеш-значения всех ядер совпадают
+    class [[maybe_unused]] XXH3_64BitsWrapper final : public Hash64Wrapper<XXH3_64BitsWrapper> {
+        friend Hash64Wrapper<XXH3_64BitsWrapper>;
+    public:
+        // Наборы инструкций, для которых есть ядра (от лучшего к худшему)
+        static constexpr std::array isas{Isa::AVX2, Isa::SSE2, Isa::PORTABLE};
+
+        // Проверяет, можно ли выполнить ядро для набора инструкций isa на текущем процессоре
+        static bool IsKernelSupported(Isa isa);
+
+        // Использует наилучшее ядро, которое поддерживает процессор
+        XXH3_64BitsWrapper();
+        // Использует ядро для набора инструкций isa (должно поддерживаться процессором)
+        explicit XXH3_64BitsWrapper(Isa isa);
+
+        // Возвращает набор инструкций ядра
+        [[nodiscard]] Isa GetIsa() const;
+
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
+
+        using Kernel = uint64_t (*)(const void*, size_t);
+
+        Isa isa_;
+        Kernel kernel_;
     };
 
-    class [[maybe_unused]] XXH3_64bits_withSeedWrapper final : public BaseHash64Wrapper {
+    class [[maybe_unused]] XXH3_64bits_withSeedWrapper final : public Hash64Wrapper<XXH3_64bits_withSeedWrapper> {
+        friend Hash64Wrapper<XXH3_64bits_withSeedWrapper>;
+    public:
+        XXH3_64bits_withSeedWrapper();
+
+        [[nodiscard]] std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateStreamingState() const override;
+
     private:
         [[nodiscard]] uint64_t HashImpl(const char *message, size_t length) const override;
+
+        // Размер секрета XXH3 (XXH3_SECRET_DEFAULT_SIZE)
+        static constexpr size_t secret_size_ = 192;
+        // Секрет, полученный из сида один раз. Длинные сообщения хешируются с ним
+        // (XXH3_64bits_withSeed вычисляет его заново при каждом вызове)
+        alignas(64) std::array<unsigned char, secret_size_> secret_{};
+    };
+
+    class [[maybe_unused]] XXH3_128BitsWrapper final : public Hash128Wrapper<XXH3_128BitsWrapper> {
+        friend Hash128Wrapper<XXH3_128BitsWrapper>;
+    private:
+        [[nodiscard]] uint128_t HashImpl(const char *message, size_t length) const override;
     };
 }
 
@@ -2,6 +2,12 @@
 #define THESIS_WORK_HASHES_H
 
 #include <memory>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "hash_wrappers.h"
 
@@ -13,13 +19,15 @@ namespace hfl {
     class Hash {
         using BaseHashWrapper = wrappers::detail::BaseHashWrapper<UintT>;
     public:
+        using UintType = UintT;
+
         Hash(std::string name, std::unique_ptr<BaseHashWrapper>&& function_pointer)
                 : hash_name_(std::move(name))
                 , hash_impl_(std::move(function_pointer)) {
         }
 
         // Метод для хеширования строки
-        uint64_t operator()(const std::string& str) const {
+        uint64_t operator()(std::string_view str) const {
             UintT hash = hash_impl_->Hash(str);
             return NumberToUint64(hash);
         }
@@ -30,20 +38,56 @@ namespace hfl {
             return NumberToUint64(hash);
         }
 
+        // Метод для хеширования файла по пути (файл отображается в память)
+        uint64_t HashFile(const std::filesystem::path& path) const {
+            UintT hash = hash_impl_->HashFile(path);
+            return NumberToUint64(hash);
+        }
+
+        // Метод для хеширования потока частями фиксированного размера
+        uint64_t HashStream(std::istream& input) const {
+            UintT hash = hash_impl_->HashStream(input);
+            return NumberToUint64(hash);
+        }
+
+        // Создает состояние для потокового хеширования (Init/Update/Final)
+        [[nodiscard]] std::unique_ptr<wrappers::StreamingHashWrapper<UintT>> CreateStreamingState() const {
+            return hash_impl_->CreateStreamingState();
+        }
+
         // Метод для хеширования чисел
         uint64_t operator()(std::integral auto number) const {
             UintT hash = hash_impl_->Hash(number);
             return NumberToUint64(hash);
         }
 
+        // Метод для пакетного хеширования строк
+        void HashBatch(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const {
+            hash_impl_->HashBatch(keys, hashes);
+        }
+
+        // Метод для пакетного хеширования чисел
+        void HashBatch(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const {
+            hash_impl_->HashBatch(numbers, hashes);
+        }
+
+        // Метод для пакетного хеширования чисел 128-битной хеш функцией без свертки хеш-значений
+        void HashBatch(std::span<const uint64_t> numbers, std::span<uint128_t> hashes) const
+                requires std::is_same_v<UintT, uint128_t> {
+            BOOST_ASSERT_MSG(numbers.size() == hashes.size(), "numbers.size() != hashes.size()");
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                hashes[i] = hash_impl_->Hash(numbers[i]);
+            }
+        }
+
         [[nodiscard]] std::string GetName() const {
             return hash_name_;
         }
 
     private:
-        // Метод, для приведения UintT к uint64_t
+        // Метод, для приведения UintT к uint64_t (128-битные хеш-значения сворачиваются)
         [[nodiscard]] uint64_t NumberToUint64(UintT number) const {
-            return static_cast<uint64_t>(number);
+            return FoldToUint64(number);
         }
 
         // Название хеш функции
@@ -52,16 +96,249 @@ namespace hfl {
         std::unique_ptr<BaseHashWrapper> hash_impl_{};
     };
 
+    // Класс обертка над классом-оберткой Wrapper, тип которого известен на этапе компиляции.
+    // Имеет тот же интерфейс, что и Hash, но хеширует без виртуальных вызовов,
+    // поэтому цикл теста инстанцируется отдельно для каждой хеш-функции
+    template<typename Wrapper>
+    class StaticHash {
+    public:
+        using UintType = typename Wrapper::UintType;
+
+        explicit StaticHash(std::string_view name)
+                : hash_name_(name) {
+        }
+
+        // Метод для хеширования строки
+        uint64_t operator()(std::string_view str) const {
+            return FoldToUint64(hash_impl_.HashDirect(str.data(), str.size()));
+        }
+
+        // Метод для хеширования бинарного файла
+        uint64_t operator()(std::ifstream& file) const {
+            return FoldToUint64(hash_impl_.Hash(file));
+        }
+
+        // Метод для хеширования файла по пути (файл отображается в память)
+        uint64_t HashFile(const std::filesystem::path& path) const {
+            const MappedFile file(path);
+            BOOST_ASSERT_MSG(file.Size() != 0, "Could not read the file");
+            return FoldToUint64(hash_impl_.HashDirect(file.GetData().data(), file.Size()));
+        }
+
+        // Метод для хеширования потока частями фиксированного размера
+        uint64_t HashStream(std::istream& input) const {
+            return FoldToUint64(hash_impl_.HashStream(input));
+        }
+
+        // Создает состояние для потокового хеширования (Init/Update/Final)
+        [[nodiscard]] auto CreateStreamingState() const {
+            return hash_impl_.CreateStreamingState();
+        }
+
+        // Метод для хеширования чисел
+        uint64_t operator()(std::integral auto number) const {
+            const char* bytes = reinterpret_cast<const char*>(reinterpret_cast<const void*>(&number));
+            return FoldToUint64(hash_impl_.HashDirect(bytes, sizeof(number)));
+        }
+
+        // Методы для пакетного хеширования строк и чисел: пакет хешируется оберткой целиком
+        // (многоканальными ядрами, если они есть у обертки, см. MultiLaneHasher)
+        void HashBatch(std::span<const std::string_view> keys, std::span<uint64_t> hashes) const {
+            hash_impl_.HashBatch(keys, hashes);
+        }
+
+        void HashBatch(std::span<const uint64_t> numbers, std::span<uint64_t> hashes) const {
+            hash_impl_.HashBatch(numbers, hashes);
+        }
+
+        // Метод для пакетного хеширования чисел 128-битной хеш функцией без свертки хеш-значений
+        void HashBatch(std::span<const uint64_t> numbers, std::span<uint128_t> hashes) const
+                requires std::is_same_v<UintType, uint128_t> {
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                const char* bytes = reinterpret_cast<const char*>(reinterpret_cast<const void*>(&numbers[i]));
+                hashes[i] = hash_impl_.HashDirect(bytes, sizeof(uint64_t));
+            }
+        }
+
+        [[nodiscard]] std::string GetName() const {
+            return hash_name_;
+        }
+
+    private:
+        // Название хеш функции
+        std::string hash_name_{};
+        // Хеш функция
+        Wrapper hash_impl_{};
+    };
+
+    // Концепт для классов Hash и StaticHash
+    template<typename HashT>
+    concept HashFunction = UnsignedIntegral<typename HashT::UintType> && requires(const HashT& hash) {
+        { hash.GetName() } -> std::convertible_to<std::string>;
+    };
+
+    //---------- HashRegistry ----------
+    // Реестр хеш функций времени компиляции. Каждая хеш функция задается
+    // элементом HashEntry: тип класса-обертки и название хеш функции
+
+    template<typename Wrapper>
+    struct HashEntry {
+        using WrapperType = Wrapper;
+        std::string_view name;
+    };
+
+    namespace registry {
+        // Универсальные хеш функции, которые есть во всех битностях
+        template<UnsignedIntegral UintT>
+        constexpr auto TemplateHashes() {
+            using namespace wrappers;
+            return std::tuple{HashEntry<DJB2HashWrapper<UintT>>{"DJB2 Hash"},
+                              HashEntry<SDBMHashWrapper<UintT>>{"SDBM Hash"},
+                              HashEntry<PJWHashWrapper<UintT>>{"PJW Hash"},
+                              HashEntry<OneTimeHashWrapper<UintT>>{"One at a time hash"}};
+        }
+
+        // 16-битные хеш функции
+        constexpr auto Hashes16() {
+            using namespace wrappers;
+            return std::tuple_cat(TemplateHashes<uint16_t>(),
+                                  std::tuple{HashEntry<FNV1aHash16Wrapper>{"FNV-1a Hash"},
+                                             HashEntry<SpookyHash16Wrapper>{"SpookyHash"},
+                                             HashEntry<FastHash16Wrapper>{"Fast-Hash"},
+                                             HashEntry<PearsonHash16Wrapper>{"PearsonHash"},
+                                             HashEntry<BuzHashWrapper<uint16_t>>{"BuzHash"}});
+        }
+
+        // 24-битные хеш функции
+        constexpr auto Hashes24() {
+            using namespace wrappers;
+            return std::tuple_cat(TemplateHashes<uint24_t>(),
+                                  std::tuple{HashEntry<FNV1aHash24Wrapper>{"FNV-1a Hash"},
+                                             HashEntry<SpookyHash24Wrapper>{"SpookyHash"},
+                                             HashEntry<FastHash24Wrapper>{"Fast-Hash"},
+                                             HashEntry<PearsonHash24Wrapper>{"PearsonHash"}});
+        }
+
+        // 32-битные хеш функции
+        constexpr auto Hashes32() {
+            using namespace wrappers;
+            return std::tuple_cat(TemplateHashes<uint32_t>(),
+                                  std::tuple{HashEntry<FNV1aHash32Wrapper>{"FNV-1a Hash"},
+                                             HashEntry<SpookyHash32Wrapper>{"SpookyHash"},
+                                             HashEntry<FastHash32Wrapper>{"Fast-Hash"},
+                                             HashEntry<PearsonHash32Wrapper>{"PearsonHash"},
+                                             HashEntry<BuzHashWrapper<uint32_t>>{"BuzHash"}},
+                                  std::tuple{HashEntry<SuperFastHashWrapper>{"SuperFastHash"},
+                                             HashEntry<MurmurHash1Wrapper>{"MurmurHash1"},
+                                             HashEntry<MurmurHash2Wrapper>{"MurmurHash2"},
+                                             HashEntry<MurmurHash2AWrapper>{"MurmurHash2A"},
+                                             HashEntry<MurmurHash3Wrapper>{"MurmurHash3"},
+                                             HashEntry<CityHash32Wrapper>{"CityHash32"},
+                                             HashEntry<FarmHash32Wrapper>{"FarmHash32"},
+                                             HashEntry<FarmHash32WithSeedWrapper>{"FarmHash32 with seed"},
+                                             HashEntry<xxHash32Wrapper>{"xxHash32"}},
+                                  std::tuple{HashEntry<wyHash32Wrapper>{"wyhash32"},
+                                             HashEntry<nmHash32Wrapper>{"NMHASH32"},
+                                             HashEntry<nmHash32XWrapper>{"NMHASH32x"},
+                                             HashEntry<HalfSipHashWrapper>{"HalfSipHash"}});
+        }
+
+        // 48-битные хеш функции
+        constexpr auto Hashes48() {
+            using namespace wrappers;
+            return std::tuple_cat(TemplateHashes<uint48_t>(),
+                                  std::tuple{HashEntry<FNV1aHash48Wrapper>{"FNV-1a Hash"},
+                                             HashEntry<SpookyHash48Wrapper>{"SpookyHash"},
+                                             HashEntry<FastHash48Wrapper>{"Fast-Hash"}});
+        }
+
+        // 64-битные хеш функции
+        constexpr auto Hashes64() {
+            using namespace wrappers;
+            return std::tuple_cat(TemplateHashes<uint64_t>(),
+                                  std::tuple{HashEntry<FNV1aHash64Wrapper>{"FNV-1a Hash"},
+                                             HashEntry<SpookyHash64Wrapper>{"SpookyHash"},
+                                             HashEntry<FastHash64Wrapper>{"Fast-Hash"},
+                                             HashEntry<PearsonHash64Wrapper>{"PearsonHash"},
+                                             HashEntry<BuzHashWrapper<uint64_t>>{"BuzHash"}},
+                                  std::tuple{HashEntry<MurmurHash64AWrapper>{"MurmurHash2 64 bits"},
+                                             HashEntry<CityHash64Wrapper>{"CityHash64"},
+                                             HashEntry<CityHash64WithSeedWrapper>{"CityHash64WithSeed"},
+                                             HashEntry<CityHash64WithSeedsWrapper>{"CityHash64WithSeeds"},
+                                             HashEntry<FarmHash64Wrapper>{"FarmHash64"},
+                                             HashEntry<FarmHash64WithSeedWrapper>{"FarmHash64WithSeed"},
+                                             HashEntry<FarmHash64WithSeedsWrapper>{"FarmHash64WithSeeds"},
+                                             HashEntry<MetroHash64_Wrapper>{"MetroHash64"},
+                                             HashEntry<T1HA1Wrapper>{"T1HA1 hash"},
+                                             HashEntry<T1HA2Wrapper>{"T1HA2 hash"},
+                                             HashEntry<xxHash64Wrapper>{"xxHash64"},
+                                             HashEntry<XXH3_64BitsWrapper>{"XXH3 64 bits"},
+                                             HashEntry<XXH3_64bits_withSeedWrapper>{"XXH3 64 bits with seed"}},
+                                  std::tuple{HashEntry<wyHash64Wrapper>{"wyhash64"},
+                                             HashEntry<PengyHash64Wrapper>{"PengyHash"},
+                                             HashEntry<MX3HashWrapper>{"MX3 hash"},
+                                             HashEntry<SipHashWrapper>{"SipHash"},
+                                             HashEntry<SipHash13Wrapper>{"SipHash13"},
+                                             HashEntry<SipHashAVX2Wrapper>{"SipHash (Google Impl)"},
+                                             HashEntry<SipHash13AVX2Wrapper>{"SipHash13 (Google Impl)"},
+                                             HashEntry<HighwayHashWrapper>{"HighwayHash"},
+                                             HashEntry<MumHashWrapper>{"MUM hash"},
+                                             HashEntry<MirHashWrapper>{"mir hash"}});
+        }
+
+        // 128-битные хеш функции
+        constexpr auto Hashes128() {
+            using namespace wrappers;
+            return std::tuple{HashEntry<SpookyHash128Wrapper>{"SpookyHash"},
+                              HashEntry<MurmurHash3_x86_128Wrapper>{"MurmurHash3 x86 128 bits"},
+                              HashEntry<MurmurHash3_x64_128Wrapper>{"MurmurHash3 x64 128 bits"},
+                              HashEntry<CityHash128Wrapper>{"CityHash128"},
+                              HashEntry<CityHash128WithSeedWrapper>{"CityHash128WithSeed"},
+                              HashEntry<XXH3_128BitsWrapper>{"XXH3 128 bits"},
+                              HashEntry<HighwayHash128Wrapper>{"HighwayHash 128 bits"}};
+        }
+    }
+
+    template<class> inline constexpr bool always_false_v = false;
+
+    // Возвращает реестр хеш функций заданной битности
+    template<UnsignedIntegral UintT>
+    constexpr auto HashRegistry() {
+        if constexpr (std::is_same_v<UintT, uint16_t>)
+            return registry::Hashes16();
+        else if constexpr (std::is_same_v<UintT, uint24_t>)
+            return registry::Hashes24();
+        else if constexpr (std::is_same_v<UintT, uint32_t>)
+            return registry::Hashes32();
+        else if constexpr (std::is_same_v<UintT, uint48_t>)
+            return registry::Hashes48();
+        else if constexpr (std::is_same_v<UintT, uint64_t>)
+            return registry::Hashes64();
+        else if constexpr (std::is_same_v<UintT, uint128_t>)
+            return registry::Hashes128();
+        else
+            static_assert(always_false_v<UintT>, "non-exhaustive visitor!");
+    }
+
+    // Конструирует хеш функции заданной битности из реестра.
+    // Возвращает кортеж из StaticHash (по одному типу на каждую хеш функцию)
+    template<UnsignedIntegral UintT>
+    auto BuildStaticHashes() {
+        return std::apply([](const auto&... entries) {
+            return std::tuple<StaticHash<typename std::remove_cvref_t<decltype(entries)>::WrapperType>...>{
+                entries.name...};
+        }, HashRegistry<UintT>());
+    }
+
     //----------- BuildHashes ----------
-    // Функции для конструирования хеш функций.
-    // Возвращают вектор из хеш-функций
+    // Функции для конструирования хеш функций во время выполнения.
+    // Возвращают вектор из хеш-функций (используется, когда нужен динамический выбор хешей)
     std::vector<Hash<uint16_t>> Build16bitsHashes();
     std::vector<Hash<uint24_t>> Build24bitsHashes();
     std::vector<Hash<uint32_t>> Build32bitsHashes();
     std::vector<Hash<uint48_t>> Build48bitsHashes();
     std::vector<Hash<uint64_t>> Build64bitsHashes();
-
-    template<class> inline constexpr bool always_false_v = false;
+    std::vector<Hash<uint128_t>> Build128bitsHashes();
 
     // Универсальная функция для конструирования хеш функций заданной битности.
     // Возвращает вектор из хеш-функций
@@ -77,9 +354,77 @@ namespace hfl {
             return Build48bitsHashes();
         else if constexpr (std::is_same_v<UintT, uint64_t>)
             return Build64bitsHashes();
+        else if constexpr (std::is_same_v<UintT, uint128_t>)
+            return Build128bitsHashes();
         else
             static_assert(always_false_v<UintT>, "non-exhaustive visitor!");
     }
+
+    //----------- HashesUintType ----------
+    // Тип хеш-значения хеш функций набора hashes (все хеш функции набора одной битности)
+
+    template<typename Hashes>
+    struct HashesUintType;
+
+    template<typename FirstHash, typename... HashTypes>
+    struct HashesUintType<std::tuple<FirstHash, HashTypes...>> {
+        using type = typename FirstHash::UintType;
+    };
+
+    template<UnsignedIntegral UintT>
+    struct HashesUintType<std::vector<Hash<UintT>>> {
+        using type = UintT;
+    };
+
+    template<typename Hashes>
+    using HashesUintT = typename HashesUintType<Hashes>::type;
+
+    //----------- ForEachHash ----------
+    // Вызывает func для каждой хеш функции из набора hashes
+
+    // Набор хеш функций времени компиляции: перебор с помощью fold-выражения
+    template<typename... HashTypes, typename Function>
+    void ForEachHash(const std::tuple<HashTypes...>& hashes, Function&& func) {
+        std::apply([&func](const auto&... hash) { (func(hash), ...); }, hashes);
+    }
+
+    // Набор хеш функций времени выполнения: перебор в цикле
+    template<UnsignedIntegral UintT, typename Function>
+    void ForEachHash(const std::vector<Hash<UintT>>& hashes, Function&& func) {
+        for (const Hash<UintT>& hash : hashes) {
+            func(hash);
+        }
+    }
+
+    //----------- ForEachHashIndexed ----------
+    // Вызывает func(index, hash) для каждой хеш функции из набора hashes (index - номер хеш функции в наборе)
+
+    template<typename... HashTypes, typename Function>
+    void ForEachHashIndexed(const std::tuple<HashTypes...>& hashes, Function&& func) {
+        [&]<size_t... indices>(std::index_sequence<indices...>) {
+            (func(indices, std::get<indices>(hashes)), ...);
+        }(std::index_sequence_for<HashTypes...>{});
+    }
+
+    template<UnsignedIntegral UintT, typename Function>
+    void ForEachHashIndexed(const std::vector<Hash<UintT>>& hashes, Function&& func) {
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            func(i, hashes[i]);
+        }
+    }
+
+    //----------- NumHashes ----------
+    // Возвращает число хеш функций в наборе hashes
+
+    template<typename... HashTypes>
+    constexpr size_t NumHashes(const std::tuple<HashTypes...>&) {
+        return sizeof...(HashTypes);
+    }
+
+    template<UnsignedIntegral UintT>
+    size_t NumHashes(const std::vector<Hash<UintT>>& hashes) {
+        return hashes.size();
+    }
 }
 
 #endif //THESIS_WORK_HASHES_H
\ No newline at end of file
@@ -24,23 +24,42 @@ namespace tests {
         }
     }
 
+    // Однократно обходит дерево каталогов и составляет список файлов
+    std::vector<std::filesystem::path> ScanImages(const std::filesystem::path& images_dir) {
+        namespace fs = std::filesystem;
+        BOOST_ASSERT_MSG(fs::is_directory(images_dir), "Could not find the images directory");
+
+        std::vector<fs::path> files;
+        for (const auto& dir_entry: fs::recursive_directory_iterator(images_dir)) {
+            if (dir_entry.is_regular_file()) {
+                files.push_back(dir_entry.path());
+            }
+        }
+        return files;
+    }
+
     // Запуск тестирования устойчивости к коллизиям хеш функций одной битности
     template <hfl::UnsignedIntegral UintT>
-    void RunImagesTestsImpl(uint16_t bits, uint16_t num_threads, out::Logger& logger) {
+    void RunImagesTestsImpl(uint16_t bits, const std::vector<std::filesystem::path>& files, uint16_t num_threads,
+                            out::Logger& logger) {
         const auto hashes = hfl::BuildHashes<UintT>();
         const TestParameters parameters{bits, num_threads};
-        TestWithImages(hashes, parameters, logger);
+        TestWithImages(hashes, files, parameters, logger);
     }
 
     // Запуск тестирования устойчивости к коллизиям всех хеш функций
     void RunImagesTests(out::Logger& logger) {
         out::StartAndEndLogTest start_and_end_log(logger, "IMAGES");
         const uint16_t num_threads = GetNumThreads();
-        RunImagesTestsImpl<uint16_t>(bits16, num_threads, logger);
-        RunImagesTestsImpl<hfl::uint24_t>(bits24, num_threads, logger);
-        RunImagesTestsImpl<uint32_t>(bits32, num_threads, logger);
-        RunImagesTestsImpl<hfl::uint48_t>(bits48, num_threads, logger);
-        RunImagesTestsImpl<uint64_t>(bits64, num_threads, logger);
+        // Дерево каталогов обходится один раз для всех битностей
+        const auto files = ScanImages(std::filesystem::current_path() / "data/images");
+        logger << boost::format("\tnumber of files: %1%\n") % files.size();
+
+        RunImagesTestsImpl<uint16_t>(bits16, files, num_threads, logger);
+        RunImagesTestsImpl<hfl::uint24_t>(bits24, files, num_threads, logger);
+        RunImagesTestsImpl<uint32_t>(bits32, files, num_threads, logger);
+        RunImagesTestsImpl<hfl::uint48_t>(bits48, files, num_threads, logger);
+        RunImagesTestsImpl<uint64_t>(bits64, files, num_threads, logger);
     }
 
 }
@@ -2,7 +2,11 @@
 #define THESIS_WORK_IMAGES_TESTS_H
 
 //#include <deque>
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
 
 #include <boost/format.hpp>
 
@@ -27,102 +31,149 @@ namespace tests {
         OutputJson GetImagesTestJson(const TestParameters& parameters, out::Logger& logger);
     }
 
+    // Результаты теста одной хеш функции на изображениях
+    struct ImagesTestResult {
+        uint64_t num_collisions{};  // Число коллизий
+        double bytes_per_second{};  // Скорость хеширования файлов (байт в секунду, все потоки вместе)
+    };
+
     /*
-     *  Тестирование устойчивости к коллизиям одной хеш функции. Реализация описана ниже
+     *  Однократно обходит дерево каталогов и составляет список файлов
+     *  Входной параметр: images_dir - корневой каталог с изображениями
+     *  Выходное значение: пути ко всем файлам (в порядке обхода)
+     */
+    std::vector<std::filesystem::path> ScanImages(const std::filesystem::path& images_dir);
+
+    /*
+     *  Хеширует изображения всеми хеш функциями одной битности за один проход.
+     *  Потоки пула берут файлы по одному (ParallelReduce с кражей работы), поэтому неравномерный
+     *  размер файлов не приводит к простою потоков. Каждый файл читается (отображается в память)
+     *  один раз и хешируется всеми хеш функциями из одного буфера
      *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
      *  Входные параметры:
-     *      1. hash - хеш-функция
-     *      2. parameters - параметры тестирования:
+     *      1. hashes - массив со всеми хеш-функциями одной битности
+     *      2. files - список файлов (результат ScanImages)
+     *      3. parameters - параметры тестирования:
      *          - битность хеша (16, 24, 32, 48 или 64)
      *          - число потоков (зависит от системы)
-     *      3. logger - записывает лог в файл и выводит его на консоль
-     *  Выходное значение: число коллизий
+     *  Выходное значение: число коллизий и скорость хеширования для каждой хеш функции (в порядке hashes)
      */
     template <hfl::UnsignedIntegral UintT>
-    uint64_t HashTestWithImages(const hfl::Hash<UintT>& hash, const TestParameters& parameters, out::Logger& logger);
+    std::vector<ImagesTestResult> HashTestWithImages(const std::vector<hfl::Hash<UintT>>& hashes,
+                                                     const std::vector<std::filesystem::path>& files,
+                                                     const TestParameters& parameters);
 
     /*
      *  Тестирование устойчивости к коллизиям хеш функций. Реализация описана ниже
      *  Параметр шаблона: целое беззнаковое число - тип хеш-значения
      *  Входные параметры:
      *      1. hashes - массив со всеми хеш-функциями одной битности
+     *      2. files - список файлов (результат ScanImages)
      *      3. parameters - параметры тестирования:
      *          - битность хеша (16, 24, 32, 48 или 64)
      *          - число потоков (зависит от системы)
      *      4. logger - записывает лог в файл и выводит его на консоль
      */
     template <hfl::UnsignedIntegral UintT>
-    void TestWithImages(const std::vector<hfl::Hash<UintT>>& hashes, const TestParameters& parameters,
-                        out::Logger& logger);
+    void TestWithImages(const std::vector<hfl::Hash<UintT>>& hashes, const std::vector<std::filesystem::path>& files,
+                        const TestParameters& parameters, out::Logger& logger);
+
+    // Запуск тестирования устойчивости к коллизиям хеш функций.
+    void RunImagesTests(out::Logger& logger);
 
 // =======================================================================================
 
-    // Тестирование устойчивости к коллизиям одной хеш функции
+    // Хеширует изображения всеми хеш функциями одной битности за один проход
     template <hfl::UnsignedIntegral UintT>
-    uint64_t HashTestWithImages(const hfl::Hash<UintT>& hash, const TestParameters& parameters, out::Logger& logger) {
-        namespace fs = std::filesystem;
-        using HashMap = std::map<uint64_t, uint64_t>;
-
-        out::LogDuration log_duration("\t\ttime", logger);
-        logger << boost::format("\n\t%1%: \n") % hash.GetName();
-
-        fs::path general_images_dir = std::filesystem::current_path() / "data/images";
-        std::atomic_uint8_t dir_number;
-
-        // Функция, запускаемая в отдельном потоке
-        auto thread_task = [&hash, &parameters, &dir_number, general_images_dir](uint64_t, uint64_t) {
-            fs::path current_images_dir = general_images_dir / std::to_string(dir_number++);
-            HashMap hash_values;
-            std::vector<fs::path> removed_path;
-            // Вычисляет хеши изображений и заполняет ими ассоциативный массив (hash_values)
-            for (const auto& dir_entry: fs::recursive_directory_iterator(current_images_dir)) {
-                const auto& path = dir_entry.path();
-                const auto status = fs::status(path);
-                if (!fs::is_directory(status)) {
-                    std::ifstream image_file = std::ifstream(path, std::ios_base::binary);
-                    const uint64_t hash_value = hash(image_file);
-                    ++hash_values[hash_value];
+    std::vector<ImagesTestResult> HashTestWithImages(const std::vector<hfl::Hash<UintT>>& hashes,
+                                                     const std::vector<std::filesystem::path>& files,
+                                                     const TestParameters& parameters) {
+        using Clock = std::chrono::steady_clock;
+
+        // Результаты одного потока: хеш-значения и время хеширования для каждой хеш функции
+        struct ThreadResult {
+            std::vector<std::vector<uint64_t>> hash_values;
+            std::vector<double> seconds;
+            uint64_t num_bytes = 0;
+        };
+
+        const size_t num_hashes = hashes.size();
+        ThreadResult identity;
+        identity.hash_values.resize(num_hashes);
+        identity.seconds.resize(num_hashes);
+
+        // Функция, которая хеширует файлы [first, last) и добавляет результаты к результату потока
+        auto task = [&hashes, &files, num_hashes](ThreadResult& result, uint64_t first, uint64_t last) {
+            for (uint64_t file_index = first; file_index < last; ++file_index) {
+                const hfl::MappedFile file(files[file_index]);
+                // Пустой файл не отображается в память (GetData возвращает нулевой указатель),
+                // поэтому он хешируется как пустая строка
+                const std::string_view data = file.Size() != 0 ? file.GetData() : std::string_view("");
+                result.num_bytes += data.size();
+                for (size_t i = 0; i < num_hashes; ++i) {
+                    const auto start_time = Clock::now();
+                    result.hash_values[i].push_back(hashes[i](data));
+                    const std::chrono::duration<double> duration = Clock::now() - start_time;
+                    result.seconds[i] += duration.count();
                 }
             }
-            return hash_values;
         };
 
-        // Функция, которая объединяет результаты выполнения thread_task,
-        // запущенных в разных потоках
-        auto merge_results = [](HashMap& all_hashes, const HashMap& part_hashes) {
-            for (const auto& [hash_value, count] : part_hashes) {
-                all_hashes[hash_value] += count;
+        // Функция, которая объединяет результаты двух потоков
+        auto merge = [num_hashes](ThreadResult& result, ThreadResult& other) {
+            for (size_t i = 0; i < num_hashes; ++i) {
+                result.hash_values[i].insert(result.hash_values[i].end(),
+                                             other.hash_values[i].begin(), other.hash_values[i].end());
+                std::vector<uint64_t>().swap(other.hash_values[i]);
+                result.seconds[i] += other.seconds[i];
             }
+            result.num_bytes += other.num_bytes;
         };
 
-        // Запуск теста в разных потоках
-        ThreadTasks<HashMap> tasks(thread_task, merge_results, parameters.num_threads, parameters.num_threads);
-        const auto hashes = tasks.GetResult();
-
-        // Вычисление числа коллизий
-        const auto num_collisions = CountCollisions(hashes);
-
-        logger << boost::format("\t\tcollisions: %1%\n") % num_collisions;
-        return num_collisions;
+        // Потоки пула берут файлы по одному, так как размеры файлов сильно различаются
+        ThreadResult result = ParallelReduce(0, files.size(), 1, identity, task, merge, parameters.num_threads);
+
+        // Вычисление числа коллизий и скорости хеширования.
+        // Скорость - байт за секунду хеширования одного потока, умноженная на число потоков
+        std::vector<ImagesTestResult> test_results(num_hashes);
+        for (size_t i = 0; i < num_hashes; ++i) {
+            const double seconds = result.seconds[i];
+            test_results[i].num_collisions = CountCollisions(std::move(result.hash_values[i]), parameters.num_threads);
+            test_results[i].bytes_per_second = (seconds > 0)
+                    ? static_cast<double>(result.num_bytes) * parameters.num_threads / seconds
+                    : 0;
+        }
+        return test_results;
     }
 
     // Тестирование устойчивости к коллизиям хеш функций
     template <hfl::UnsignedIntegral UintT>
-    void TestWithImages(const std::vector<hfl::Hash<UintT>>& hashes, const TestParameters& parameters,
-                        out::Logger& logger) {
+    void TestWithImages(const std::vector<hfl::Hash<UintT>>& hashes, const std::vector<std::filesystem::path>& files,
+                        const TestParameters& parameters, out::Logger& logger) {
         out::StartAndEndLogBitsTest printer(logger, parameters.hash_bits);
 
         auto out_json = out::GetImagesTestJson(parameters, logger);
         boost::json::object collisions;
-        // В цикле запускает тест для каждой хеш функции
-        for (const auto& hash : hashes) {
-            collisions[hash.GetName()] = HashTestWithImages(hash, parameters, logger);
+        boost::json::object bytes_per_second;
+
+        std::vector<ImagesTestResult> results;
+        {
+            out::LogDuration log_duration("\ttime (all hashes)", logger);
+            results = HashTestWithImages(hashes, files, parameters);
         }
+
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            const std::string hash_name = hashes[i].GetName();
+            logger << boost::format("\n\t%1%: \n") % hash_name;
+            logger << boost::format("\t\tcollisions: %1%\n") % results[i].num_collisions;
+            logger << boost::format("\t\tspeed: %1% bytes/sec\n") % results[i].bytes_per_second;
+            collisions[hash_name] = results[i].num_collisions;
+            bytes_per_second[hash_name] = results[i].bytes_per_second;
+        }
+        out_json.obj["Number of files"] = files.size();
         out_json.obj["Collisions"] = collisions;
+        out_json.obj["Bytes per second"] = bytes_per_second;
         out_json.out << out_json.obj;
     }
-
-    // Запуск тестирования устойчивости к коллизиям хеш функций.
-    void RunImagesTests(out::Logger& logger);
 }
 #endif //THESIS_WORK_IMAGES_TESTS_H
@@ -0,0 +1,75 @@
+#include "isa.h"
+
+#include <array>
+
+#include <boost/assert.hpp>
+
+#include <highwayhash/instruction_sets.h>
+
+namespace hfl {
+    // Конвертор набора инструкций в строку
+    std::string IsaToString(Isa isa) {
+        switch (isa) {
+            case Isa::PORTABLE:
+                return "Portable";
+            case Isa::SSE2:
+                return "SSE2";
+            case Isa::SSE41:
+                return "SSE4.1";
+            case Isa::AVX:
+                return "AVX";
+            case Isa::AVX2:
+                return "AVX2";
+            default: {
+                BOOST_ASSERT_MSG(false, "Unknown ISA");
+                return std::string{};
+            }
+        }
+    }
+
+    // Проверяет, поддерживает ли процессор набор инструкций
+    bool IsIsaSupported(Isa isa) {
+#if HH_ARCH_X64
+        const highwayhash::TargetBits supported = highwayhash::InstructionSets::Supported();
+        switch (isa) {
+            case Isa::PORTABLE:
+                return true;
+            case Isa::SSE2:
+                return __builtin_cpu_supports("sse2");
+            case Isa::SSE41:
+                return (supported & HH_TARGET_SSE41) != 0;
+            case Isa::AVX:
+                return __builtin_cpu_supports("avx");
+            case Isa::AVX2:
+                return (supported & HH_TARGET_AVX2) != 0;
+            default: {
+                BOOST_ASSERT_MSG(false, "Unknown ISA");
+                return false;
+            }
+        }
+#else
+        return isa == Isa::PORTABLE;
+#endif
+    }
+
+    // Проверяет, поддерживает ли процессор инструкции AES-NI
+    bool IsAesSupported() {
+#if HH_ARCH_X64
+        return __builtin_cpu_supports("aes");
+#else
+        return false;
+#endif
+    }
+
+    // Возвращает все наборы инструкций, которые поддерживает процессор (от лучшего к худшему)
+    std::vector<Isa> GetSupportedIsas() {
+        constexpr std::array isas{Isa::AVX2, Isa::AVX, Isa::SSE41, Isa::SSE2, Isa::PORTABLE};
+        std::vector<Isa> supported;
+        for (const Isa isa : isas) {
+            if (IsIsaSupported(isa)) {
+                supported.push_back(isa);
+            }
+        }
+        return supported;
+    }
+}
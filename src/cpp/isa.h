@@ -0,0 +1,34 @@
+#ifndef THESIS_WORK_ISA_H
+#define THESIS_WORK_ISA_H
+
+#include <string>
+#include <vector>
+
+namespace hfl {
+    // Наборы инструкций, для которых в HashLib есть отдельные ядра хеш функций (от худшего к лучшему)
+    enum class Isa {
+        PORTABLE,   // Без SIMD-инструкций
+        SSE2,       // SSE2 (XXH3, t1ha0 с AES-NI без AVX)
+        SSE41,      // SSE4.1 (HighwayHash)
+        AVX,        // AVX (t1ha0 с AES-NI)
+        AVX2        // AVX2 (HighwayHash, XXH3, t1ha0 с AES-NI)
+    };
+
+    // Конвертор набора инструкций в строку
+    std::string IsaToString(Isa isa);
+
+    /*
+     *  Проверяет, поддерживает ли процессор набор инструкций. SSE4.1 и AVX2 определяются
+     *  так же, как в highwayhash (highwayhash::InstructionSets::Supported), то есть с проверкой
+     *  того, что ОС сохраняет AVX-регистры. PORTABLE поддерживается всегда
+     */
+    bool IsIsaSupported(Isa isa);
+
+    // Проверяет, поддерживает ли процессор инструкции AES-NI (нужны ядрам t1ha0)
+    bool IsAesSupported();
+
+    // Возвращает все наборы инструкций, которые поддерживает процессор (от лучшего к худшему)
+    std::vector<Isa> GetSupportedIsas();
+}
+
+#endif //THESIS_WORK_ISA_H
@@ -0,0 +1,150 @@
+#include "key_arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/assert.hpp>
+
+#include "concurrency.h"
+
+namespace tests {
+    KeyArena::KeyArena()
+            : offsets_{0} {
+    }
+
+    // Создает пустое хранилище и резервирует память
+    KeyArena::KeyArena(size_t num_keys, uint64_t num_bytes)
+            : KeyArena() {
+        Reserve(num_keys, num_bytes);
+    }
+
+    // Отображает текстовый файл в память и разбивает его на строки
+    KeyArena KeyArena::MapLines(const std::filesystem::path& path, uint16_t num_threads) {
+        BOOST_ASSERT_MSG(num_threads > 0, "Number of threads must be positive");
+        num_threads = std::min(num_threads, ThreadPool::GetInstance().Size());
+
+        KeyArena arena;
+        arena.mapping_ = std::make_unique<hfl::MappedFile>(path);
+        const std::string_view text = arena.mapping_->GetData();
+        arena.data_ = text.data();
+
+        // Строки одной части файла
+        struct Lines {
+            std::vector<uint64_t> begins;
+            std::vector<uint64_t> ends;
+            uint64_t num_bytes = 0;
+        };
+
+        // Часть с индексом i содержит строки, которые начинаются в [i * part_size, (i + 1) * part_size)
+        std::vector<Lines> parts(num_threads);
+        const size_t part_size = (text.size() + num_threads - 1) / num_threads;
+        auto split_part = [&text, &parts, part_size](uint16_t part_index) {
+            size_t line_begin = std::min(part_size * part_index, text.size());
+            const size_t part_end = std::min(part_size * (part_index + 1), text.size());
+            // Строка, начатая в предыдущей части, принадлежит ей
+            if (line_begin != 0) {
+                const size_t newline = text.find('\n', line_begin - 1);
+                line_begin = (newline == std::string_view::npos) ? text.size() : newline + 1;
+            }
+
+            Lines& lines = parts[part_index];
+            while (line_begin < part_end) {
+                size_t line_end = text.find('\n', line_begin);
+                if (line_end == std::string_view::npos) {
+                    line_end = text.size();
+                }
+                const size_t next_line_begin = line_end + 1;
+                if (line_end > line_begin && text[line_end - 1] == '\r') {
+                    --line_end;
+                }
+                if (line_end > line_begin) {
+                    lines.begins.push_back(line_begin);
+                    lines.ends.push_back(line_end);
+                    lines.num_bytes += line_end - line_begin;
+                }
+                line_begin = next_line_begin;
+            }
+        };
+
+        // Запуск split_part в потоках пула
+        ThreadPool::GetInstance().Broadcast(num_threads, split_part);
+
+        // Объединение частей по порядку
+        size_t num_lines = 0;
+        for (const Lines& lines : parts) {
+            num_lines += lines.begins.size();
+        }
+        arena.offsets_.clear();
+        arena.offsets_.reserve(num_lines + 1);
+        arena.ends_.reserve(num_lines);
+        for (Lines& lines : parts) {
+            arena.offsets_.insert(arena.offsets_.end(), lines.begins.begin(), lines.begins.end());
+            arena.ends_.insert(arena.ends_.end(), lines.ends.begin(), lines.ends.end());
+            arena.num_mapped_bytes_ += lines.num_bytes;
+            lines = Lines{};
+        }
+        arena.offsets_.push_back(text.size());
+        return arena;
+    }
+
+    // Резервирует память под num_keys ключей суммарным размером num_bytes
+    void KeyArena::Reserve(size_t num_keys, uint64_t num_bytes) {
+        offsets_.reserve(num_keys + 1);
+        if (num_bytes > capacity_) {
+            Grow(num_bytes);
+        }
+    }
+
+    // Добавляет ключ длины length и возвращает указатель на его данные
+    char* KeyArena::Append(uint64_t length) {
+        BOOST_ASSERT_MSG(!mapping_, "Mapped keys are read-only");
+        const uint64_t offset = offsets_.back();
+        if (offset + length > capacity_) {
+            // Геометрический рост, чтобы добавление ключа в среднем выполнялось за O(1)
+            Grow(std::max(offset + length, capacity_ * 2));
+        }
+        offsets_.push_back(offset + length);
+        return buffer_.get() + offset;
+    }
+
+    // Добавляет копию ключа
+    void KeyArena::Append(std::string_view key) {
+        char* data = Append(key.size());
+        if (!key.empty()) {
+            std::memcpy(data, key.data(), key.size());
+        }
+    }
+
+    // Возвращает массив представлений всех ключей
+    std::vector<std::string_view> KeyArena::GetViews() const {
+        return std::vector<std::string_view>(begin(), end());
+    }
+
+    KeyArena::Iterator KeyArena::begin() const {
+        return Iterator{this, 0};
+    }
+
+    KeyArena::Iterator KeyArena::end() const {
+        return Iterator{this, Size()};
+    }
+
+    // Увеличивает буфер так, чтобы в нем поместилось не менее min_capacity байт
+    void KeyArena::Grow(uint64_t min_capacity) {
+        // Размер aligned_alloc должен быть кратен выравниванию
+        const uint64_t capacity = (std::max<uint64_t>(min_capacity, 1) + alignment - 1) / alignment * alignment;
+        auto* buffer = static_cast<char*>(std::aligned_alloc(alignment, capacity));
+        BOOST_ASSERT_MSG(buffer, "Failed to allocate the key arena");
+        if (offsets_.back() != 0) {
+            std::memcpy(buffer, buffer_.get(), offsets_.back());
+        }
+        buffer_.reset(buffer);
+        data_ = buffer;
+        capacity_ = capacity;
+    }
+
+    // Освобождает буфер
+    void KeyArena::BufferDeleter::operator()(char* buffer) const {
+        std::free(buffer);
+    }
+}
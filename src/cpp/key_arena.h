@@ -0,0 +1,168 @@
+#ifndef THESIS_WORK_KEY_ARENA_H
+#define THESIS_WORK_KEY_ARENA_H
+
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+#include "mapped_file.h"
+
+namespace tests {
+    /*
+     *  Хранилище ключей: все ключи лежат подряд в одном непрерывном буфере, выровненном по границе
+     *  кэш-линии, а их границы хранятся в массиве смещений. Ключи выдаются как std::string_view,
+     *  поэтому ни при заполнении хранилища, ни при хешировании ключей память под каждый ключ не выделяется.
+     *  Хранилище, созданное MapLines, не копирует ключи: они указывают на строки файла, отображенного в память
+     */
+    class KeyArena {
+    public:
+        // Итератор по ключам хранилища
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+            Iterator() = default;
+            Iterator(const KeyArena* arena, size_t index);
+
+            std::string_view operator*() const;
+            Iterator& operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator& other) const = default;
+
+        private:
+            const KeyArena* arena_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        KeyArena();
+
+        /*
+         *  Создает пустое хранилище и резервирует память
+         *  Входные параметры:
+         *      1. num_keys - ожидаемое число ключей
+         *      2. num_bytes - ожидаемый суммарный размер ключей
+         */
+        KeyArena(size_t num_keys, uint64_t num_bytes);
+
+        /*
+         *  Отображает текстовый файл в память и разбивает его на строки. Ключи - строки файла без
+         *  завершающих символов '\r', пустые строки пропускаются. Файл делится на num_threads частей
+         *  равного размера, которые разбиваются на строки параллельно
+         *  Входные параметры:
+         *      1. path - путь к файлу
+         *      2. num_threads - число потоков
+         *  Выходное значение: хранилище строк файла (дополнять его ключами нельзя)
+         */
+        static KeyArena MapLines(const std::filesystem::path& path, uint16_t num_threads = 1);
+
+        KeyArena(const KeyArena&) = delete;
+        KeyArena(KeyArena&&) = default;
+
+        KeyArena& operator=(const KeyArena&) = delete;
+        KeyArena& operator=(KeyArena&&) = default;
+
+        // Резервирует память под num_keys ключей суммарным размером num_bytes
+        void Reserve(size_t num_keys, uint64_t num_bytes);
+
+        // Добавляет ключ длины length и возвращает указатель на его данные, которые заполняет вызывающий.
+        // Указатель действителен до следующего добавления ключа
+        char* Append(uint64_t length);
+
+        // Добавляет копию ключа
+        void Append(std::string_view key);
+
+        // Возвращает ключ с индексом index
+        std::string_view operator[](size_t index) const;
+
+        // Возвращает указатель на данные ключа с индексом index (для заполнения на месте)
+        char* Data(size_t index);
+
+        // Возвращает массив представлений всех ключей (например, для пакетного хеширования)
+        [[nodiscard]] std::vector<std::string_view> GetViews() const;
+
+        // Возвращает число ключей
+        [[nodiscard]] size_t Size() const;
+
+        // Возвращает суммарный размер ключей в байтах
+        [[nodiscard]] uint64_t NumBytes() const;
+
+        [[nodiscard]] Iterator begin() const;
+        [[nodiscard]] Iterator end() const;
+
+    private:
+        // Освобождает буфер
+        struct BufferDeleter {
+            void operator()(char* buffer) const;
+        };
+
+        // Увеличивает буфер так, чтобы в нем поместилось не менее min_capacity байт
+        void Grow(uint64_t min_capacity);
+
+        static constexpr size_t alignment = 64;
+
+        std::unique_ptr<char[], BufferDeleter> buffer_;    // Данные всех ключей
+        uint64_t capacity_ = 0;                             // Размер буфера
+        std::vector<uint64_t> offsets_;                     // Смещения начала ключей (и конца последнего ключа)
+
+        // Поля хранилища строк файла (MapLines)
+        std::unique_ptr<hfl::MappedFile> mapping_;          // Отображенный в память файл
+        std::vector<uint64_t> ends_;                        // Смещения конца ключей (ключи разделены переводами строк)
+        uint64_t num_mapped_bytes_ = 0;                     // Суммарный размер строк
+
+        const char* data_ = nullptr;                        // Начало буфера или отображенного файла
+    };
+
+    // Возвращает ключ с индексом index
+    inline std::string_view KeyArena::operator[](size_t index) const {
+        const uint64_t begin = offsets_[index];
+        const uint64_t end = ends_.empty() ? offsets_[index + 1] : ends_[index];
+        return {data_ + begin, end - begin};
+    }
+
+    // Возвращает указатель на данные ключа с индексом index
+    inline char* KeyArena::Data(size_t index) {
+        BOOST_ASSERT_MSG(!mapping_, "Mapped keys are read-only");
+        return buffer_.get() + offsets_[index];
+    }
+
+    // Возвращает число ключей
+    inline size_t KeyArena::Size() const {
+        return offsets_.size() - 1;
+    }
+
+    // Возвращает суммарный размер ключей в байтах
+    inline uint64_t KeyArena::NumBytes() const {
+        return mapping_ ? num_mapped_bytes_ : offsets_.back();
+    }
+
+    inline KeyArena::Iterator::Iterator(const KeyArena* arena, size_t index)
+            : arena_(arena)
+            , index_(index) {
+    }
+
+    inline std::string_view KeyArena::Iterator::operator*() const {
+        return (*arena_)[index_];
+    }
+
+    inline KeyArena::Iterator& KeyArena::Iterator::operator++() {
+        ++index_;
+        return *this;
+    }
+
+    inline KeyArena::Iterator KeyArena::Iterator::operator++(int) {
+        Iterator old = *this;
+        ++index_;
+        return old;
+    }
+}
+
+#endif //THESIS_WORK_KEY_ARENA_H
@@ -3,12 +3,16 @@
 #include "english_tests.h"
 #include "timers.h"
 #include "speed_tests.h"
+#include "scaling_tests.h"
 #include "avalanche_tests.h"
 #include "images_tests.h"
+#include "chunking_tests.h"
 
 #include <pcg_random.hpp>
 #include <algorithm>
+#include <sstream>
 
+#include "allocation_counter.h"
 #include "hash_wrappers.h"
 #include "hashes.h"
 #include "my_assert.h"
@@ -17,26 +21,73 @@
 constexpr uint16_t LENGTH_OF_LITTLE_BLOCK = 16;
 constexpr uint16_t LENGTH_OF_BIG_BLOCK = 4048;
 constexpr uint64_t NUM_SPEED_TEST_WORDS = 2'000'000;
+constexpr uint16_t MAX_LENGTH_OF_CHECKED_MESSAGE = 2048;
 
-// Проверяет корректность хеша. Хеширование двух одинаковых чисел должно дать два одинаковых хеша
+// Проверяет корректность хеша. Хеширование двух одинаковых чисел должно дать два одинаковых хеша.
+// Кроме того, хеширование чисел и строк не должно выделять динамическую память,
+// а пакетное и потоковое хеширование должны давать те же хеш-значения, что и хеширование по одному ключу
 template<hfl::UnsignedIntegral UintT>
-void CheckHash(const hfl::Hash<UintT>& hash, const std::vector<uint64_t>& numbers, tests::out::Logger& logger) {
+void CheckHash(const hfl::Hash<UintT>& hash, const std::vector<uint64_t>& numbers,
+               const std::vector<std::string>& messages, tests::out::Logger& logger) {
     for (uint64_t number : numbers) {
         std::string hint = hash.GetName() + " is not correct";
         ASSERT_EQUAL_HINT(hash(number), hash(number), hint);
 
     }
-    logger << boost::format("\t\t%1% is correct\n") % hash.GetName();
+
+    const tests::AllocationCounter allocation_counter;
+    uint64_t checksum = 0;
+    for (uint64_t number : numbers) {
+        checksum += hash(number);
+    }
+    for (const std::string& message : messages) {
+        checksum += hash(std::string_view(message));
+    }
+    const uint64_t num_allocations = allocation_counter.NumAllocations();
+    ASSERT_EQUAL_HINT(num_allocations, 0ull, hash.GetName() + " allocates memory");
+
+    // Пакетное хеширование (в том числе многоканальными ядрами) должно давать те же хеш-значения
+    std::vector<uint64_t> batch_hashes(numbers.size());
+    hash.HashBatch(numbers, batch_hashes);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        ASSERT_EQUAL_HINT(batch_hashes[i], hash(numbers[i]), hash.GetName() + " batch hashing is not correct");
+    }
+    const std::vector<std::string_view> keys(messages.begin(), messages.end());
+    batch_hashes.resize(keys.size());
+    hash.HashBatch(keys, batch_hashes);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQUAL_HINT(batch_hashes[i], hash(keys[i]), hash.GetName() + " batch hashing is not correct");
+    }
+
+    // Потоковое хеширование (Init/Update/Final и HashStream) должно давать те же хеш-значения
+    // при любом разбиении сообщения на части
+    const auto state = hash.CreateStreamingState();
+    for (const std::string& message : messages) {
+        const uint64_t expected = hash(std::string_view(message));
+        for (size_t chunk_size : {1, 7, 64, 4096}) {
+            state->Init();
+            for (size_t pos = 0; pos < message.size(); pos += chunk_size) {
+                state->Update(std::string_view(message).substr(pos, chunk_size));
+            }
+            ASSERT_EQUAL_HINT(hfl::FoldToUint64(state->Final()), expected,
+                              hash.GetName() + " streaming hashing is not correct");
+        }
+        std::istringstream input(message);
+        ASSERT_EQUAL_HINT(hash.HashStream(input), expected, hash.GetName() + " stream hashing is not correct");
+    }
+
+    logger << boost::format("\t\t%1% is correct (checksum = %2%)\n") % hash.GetName() % checksum;
 }
 
 // Проверяет корректность работы всех хешей одной битности
 template<hfl::UnsignedIntegral UintT>
-void CheckHashes(const std::vector<uint64_t>& numbers, tests::out::Logger& logger) {
+void CheckHashes(const std::vector<uint64_t>& numbers, const std::vector<std::string>& messages,
+                 tests::out::Logger& logger) {
     const auto hashes = hfl::BuildHashes<UintT>();
-    std::cout << boost::format("\t%1% bits hashes (size = %2%):\n") % std::numeric_limits<UintT>::digits
+    std::cout << boost::format("\t%1% bits hashes (size = %2%):\n") % hfl::hash_bits_v<UintT>
         % hashes.size();
     for (const auto& hasher : hashes) {
-        CheckHash(hasher, numbers, logger);
+        CheckHash(hasher, numbers, messages, logger);
     }
     logger << std::endl;
 }
@@ -53,11 +104,21 @@ void RunCheckHashes(tests::out::Logger& logger) {
         numbers.emplace_back(rng());
     }
 
-    CheckHashes<uint16_t>(numbers, logger);
-    CheckHashes<hfl::uint24_t>(numbers, logger);
-    CheckHashes<uint32_t>(numbers, logger);
-    CheckHashes<hfl::uint48_t>(numbers, logger);
-    CheckHashes<uint64_t>(numbers, logger);
+    // Строки всех длин от 0 до 2047 байт, чтобы проверить все ветви хеш функций (короткие и длинные
+    // сообщения, все остатки от деления длины на размер блока)
+    std::vector<std::string> messages;
+    for (uint16_t length = 0; length < MAX_LENGTH_OF_CHECKED_MESSAGE; ++length) {
+        std::string message(length, '\0');
+        std::generate(message.begin(), message.end(), [&rng] { return static_cast<char>(rng()); });
+        messages.push_back(std::move(message));
+    }
+
+    CheckHashes<uint16_t>(numbers, messages, logger);
+    CheckHashes<hfl::uint24_t>(numbers, messages, logger);
+    CheckHashes<uint32_t>(numbers, messages, logger);
+    CheckHashes<hfl::uint48_t>(numbers, messages, logger);
+    CheckHashes<uint64_t>(numbers, messages, logger);
+    CheckHashes<hfl::uint128_t>(numbers, messages, logger);
 }
 
 enum class TestType {
@@ -67,7 +128,9 @@ enum class TestType {
     TESTS_WITH_BIG_GENERATED_BLOCKS = 4,
     TESTS_WITH_ENGLISH_WORDS = 5,
     TESTS_WITH_IMAGES = 6,
-    SPEED_TESTS = 7
+    SPEED_TESTS = 7,
+    SCALING_TESTS = 8,
+    CHUNKING_TESTS = 9
 };
 
 // Запускает выбранные тесты
@@ -101,6 +164,13 @@ void RunTests(const std::vector<int>& test_numbers, tests::out::Logger& logger)
                 break;
             case TestType::SPEED_TESTS:
                 tests::RunSpeedTests(NUM_SPEED_TEST_WORDS, LENGTH_OF_BIG_BLOCK, logger);
+                tests::RunMultiLaneSpeedTests(logger);
+                break;
+            case TestType::SCALING_TESTS:
+                tests::RunScalingTests(LENGTH_OF_BIG_BLOCK, logger);
+                break;
+            case TestType::CHUNKING_TESTS:
+                tests::RunChunkingTests(logger);
                 break;
             default:
                 break;
@@ -0,0 +1,64 @@
+#include "mapped_file.h"
+
+#include <fstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/assert.hpp>
+
+namespace hfl {
+    // Отображает файл path в память
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef __linux__
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        BOOST_ASSERT_MSG(fd != -1, "Could not open the file");
+        struct stat file_stat{};
+        const int stat_result = fstat(fd, &file_stat);
+        BOOST_ASSERT_MSG(stat_result == 0, "Could not get the file size");
+        size_ = static_cast<size_t>(file_stat.st_size);
+
+        // Пустой файл отобразить нельзя: data_ остается нулевым указателем
+        if (size_ != 0) {
+            void* memory = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            BOOST_ASSERT_MSG(memory != MAP_FAILED, "Could not map the file");
+            // Ошибка не критична: без подсказки ядро читает файл с упреждением по умолчанию
+            madvise(memory, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(memory);
+        }
+        // Отображение остается действительным и после закрытия дескриптора
+        close(fd);
+#else
+        std::ifstream file(path, std::ios_base::binary | std::ios_base::ate);
+        BOOST_ASSERT_MSG(file, "Could not open the file");
+        buffer_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    // Снимает отображение файла
+    MappedFile::~MappedFile() {
+#ifdef __linux__
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    // Возвращает содержимое файла
+    std::string_view MappedFile::GetData() const {
+        return {data_, size_};
+    }
+
+    // Возвращает размер файла в байтах
+    size_t MappedFile::Size() const {
+        return size_;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef THESIS_WORK_MAPPED_FILE_H
+#define THESIS_WORK_MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace hfl {
+    /*
+     *  Файл, отображенный в память только для чтения. В Linux файл отображается через mmap
+     *  с подсказкой MADV_SEQUENTIAL (ядро читает страницы с упреждением и освобождает прочитанные),
+     *  поэтому его содержимое не копируется в пользовательский буфер.
+     *  В остальных системах файл целиком читается в строку одним вызовом read
+     */
+    class MappedFile {
+    public:
+        // Отображает файл path в память
+        explicit MappedFile(const std::filesystem::path& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Снимает отображение файла
+        ~MappedFile();
+
+        // Возвращает содержимое файла
+        [[nodiscard]] std::string_view GetData() const;
+
+        // Возвращает размер файла в байтах
+        [[nodiscard]] size_t Size() const;
+
+    private:
+        const char* data_ = nullptr;    // Начало содержимого файла
+        size_t size_ = 0;               // Размер файла
+#ifndef __linux__
+        std::string buffer_;            // Содержимое файла (если mmap недоступен)
+#endif
+    };
+}
+
+#endif //THESIS_WORK_MAPPED_FILE_H
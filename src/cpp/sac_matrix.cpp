@@ -0,0 +1,192 @@
+#include "sac_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/assert.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "isa.h"
+
+namespace {
+    using tests::SacMatrix;
+
+    // Число бит в маске хеша
+    constexpr uint8_t mask_bits = 64;
+
+    // Прибавляет биты маски к 64 8-битным счетчикам строки
+    void AddMaskBitsPortable(uint8_t* row, uint64_t mask) {
+        for (uint8_t bit = 0; bit < mask_bits; ++bit) {
+            row[bit] += static_cast<uint8_t>((mask >> bit) & 1);
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // Прибавляет к 32 8-битным счетчикам биты маски, выбранные перетасовкой shuffle:
+    // байт маски сравнивается со своим битом, и результат сравнения (0 или -1) вычитается из счетчика
+    __attribute__((target("avx2")))
+    inline void AddMaskBitsHalfAVX2(uint8_t* counters, __m256i broadcast_mask, __m256i shuffle) {
+        const __m256i bit_selector = _mm256_set1_epi64x(0x8040201008040201ll);
+        const __m256i mask_bytes = _mm256_shuffle_epi8(broadcast_mask, shuffle);
+        const __m256i is_set = _mm256_cmpeq_epi8(_mm256_and_si256(mask_bytes, bit_selector), bit_selector);
+        const __m256i old_counters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(counters), _mm256_sub_epi8(old_counters, is_set));
+    }
+
+    // Прибавляет биты маски к 64 8-битным счетчикам строки: каждый байт маски размножается на 8 байт
+    // (по 32 счетчика за инструкцию). Компилируется с AVX2 независимо от флагов сборки
+    __attribute__((target("avx2")))
+    void AddMaskBitsAVX2(uint8_t* row, uint64_t mask) {
+        const __m256i low_shuffle = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                     2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i high_shuffle = _mm256_setr_epi8(4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5,
+                                                      6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7);
+        const __m256i broadcast_mask = _mm256_set1_epi64x(static_cast<int64_t>(mask));
+        AddMaskBitsHalfAVX2(row, broadcast_mask, low_shuffle);
+        AddMaskBitsHalfAVX2(row + 32, broadcast_mask, high_shuffle);
+    }
+#endif
+
+    using AddMaskBitsFunction = void (*)(uint8_t*, uint64_t);
+
+    // Выбирает реализацию AddMaskBits, которую поддерживает процессор
+    AddMaskBitsFunction SelectAddMaskBits() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (hfl::IsIsaSupported(hfl::Isa::AVX2)) {
+            return AddMaskBitsAVX2;
+        }
+#endif
+        return AddMaskBitsPortable;
+    }
+}
+
+namespace tests {
+    // Создает нулевую матрицу для хеш-значений из hash_bits бит
+    SacMatrix::SacMatrix(uint16_t hash_bits)
+        : hash_bits_(hash_bits)
+        , row_size_(hash_bits <= mask_bits ? mask_bits : max_output_bits)
+        , pending_counts_(static_cast<size_t>(num_input_bits) * row_size_, 0)
+        , flip_counts_(static_cast<size_t>(num_input_bits) * row_size_, 0) {
+        BOOST_ASSERT_MSG(hash_bits > 0 && hash_bits <= max_output_bits, "Unsupported number of hash bits");
+    }
+
+    // Добавляет в матрицу один ключ
+    void SacMatrix::AddKey(uint64_t original_hash, std::span<const uint64_t> modified_hashes) {
+        BOOST_ASSERT_MSG(modified_hashes.size() == num_input_bits, "modified_hashes.size() != num_input_bits");
+        BOOST_ASSERT_MSG(row_size_ == mask_bits, "Hash is wider than 64 bits");
+        static const AddMaskBitsFunction add_mask_bits = SelectAddMaskBits();
+        uint8_t* row = pending_counts_.data();
+        for (const uint64_t modified_hash : modified_hashes) {
+            add_mask_bits(row, original_hash ^ modified_hash);
+            row += row_size_;
+        }
+        AddPendingKey();
+    }
+
+    // Добавляет в матрицу один ключ 128-битной хеш функции: младшая половина маски прибавляется
+    // к первым 64 счетчикам строки, старшая - к остальным
+    void SacMatrix::AddKey(hfl::uint128_t original_hash, std::span<const hfl::uint128_t> modified_hashes) {
+        BOOST_ASSERT_MSG(modified_hashes.size() == num_input_bits, "modified_hashes.size() != num_input_bits");
+        BOOST_ASSERT_MSG(row_size_ == max_output_bits, "Hash is not 128 bits wide");
+        static const AddMaskBitsFunction add_mask_bits = SelectAddMaskBits();
+        uint8_t* row = pending_counts_.data();
+        for (const hfl::uint128_t modified_hash : modified_hashes) {
+            const hfl::uint128_t mask = original_hash ^ modified_hash;
+            add_mask_bits(row, static_cast<uint64_t>(mask));
+            add_mask_bits(row + mask_bits, static_cast<uint64_t>(mask >> mask_bits));
+            row += row_size_;
+        }
+        AddPendingKey();
+    }
+
+    // Добавляет к матрице матрицу, вычисленную в другом потоке
+    void SacMatrix::Merge(const SacMatrix& other) {
+        BOOST_ASSERT_MSG(hash_bits_ == other.hash_bits_, "Different number of hash bits");
+        for (size_t cell = 0; cell < flip_counts_.size(); ++cell) {
+            flip_counts_[cell] += other.flip_counts_[cell] + other.pending_counts_[cell];
+        }
+        num_keys_ += other.num_keys_;
+    }
+
+    // Возвращает число добавленных ключей
+    uint64_t SacMatrix::NumKeys() const {
+        return num_keys_;
+    }
+
+    // Возвращает число бит хеш-значения
+    uint16_t SacMatrix::HashBits() const {
+        return hash_bits_;
+    }
+
+    // Возвращает, сколько раз изменение бита input_bit числа изменило бит output_bit хеша
+    uint64_t SacMatrix::FlipCount(uint8_t input_bit, uint8_t output_bit) const {
+        BOOST_ASSERT_MSG(input_bit < num_input_bits && output_bit < hash_bits_, "Bit index out of range");
+        const size_t cell = static_cast<size_t>(input_bit) * row_size_ + output_bit;
+        return flip_counts_[cell] + pending_counts_[cell];
+    }
+
+    // Возвращает вероятность того, что изменение бита input_bit числа изменит бит output_bit хеша
+    double SacMatrix::FlipProbability(uint8_t input_bit, uint8_t output_bit) const {
+        if (num_keys_ == 0) {
+            return 0;
+        }
+        return static_cast<double>(FlipCount(input_bit, output_bit)) / static_cast<double>(num_keys_);
+    }
+
+    // Возвращает ячейку матрицы с наибольшим смещением
+    SacBias SacMatrix::MaxBias() const {
+        SacBias max_bias;
+        for (uint8_t input_bit = 0; input_bit < num_input_bits; ++input_bit) {
+            for (uint8_t output_bit = 0; output_bit < hash_bits_; ++output_bit) {
+                const double bias = std::abs(2 * FlipProbability(input_bit, output_bit) - 1);
+                if (bias > max_bias.value) {
+                    max_bias = SacBias{bias, input_bit, output_bit};
+                }
+            }
+        }
+        return max_bias;
+    }
+
+    // Учитывает добавленный ключ и переносит 8-битные счетчики, пока они не переполнились
+    void SacMatrix::AddPendingKey() {
+        ++num_keys_;
+        if (++num_pending_keys_ == max_pending_keys) {
+            Flush();
+        }
+    }
+
+    // Переносит 8-битные счетчики в 64-битные
+    void SacMatrix::Flush() {
+        for (size_t cell = 0; cell < flip_counts_.size(); ++cell) {
+            flip_counts_[cell] += pending_counts_[cell];
+        }
+        std::fill(pending_counts_.begin(), pending_counts_.end(), 0);
+        num_pending_keys_ = 0;
+    }
+
+    // Сохраняет матрицу SAC в json
+    boost::json::object SacMatrixToJson(const SacMatrix& sac_matrix) {
+        const SacBias max_bias = sac_matrix.MaxBias();
+
+        boost::json::array heatmap;
+        heatmap.reserve(SacMatrix::num_input_bits);
+        for (uint8_t input_bit = 0; input_bit < SacMatrix::num_input_bits; ++input_bit) {
+            boost::json::array row;
+            row.reserve(sac_matrix.HashBits());
+            for (uint8_t output_bit = 0; output_bit < sac_matrix.HashBits(); ++output_bit) {
+                row.emplace_back(sac_matrix.FlipProbability(input_bit, output_bit));
+            }
+            heatmap.emplace_back(std::move(row));
+        }
+
+        boost::json::object obj;
+        obj["Max bias"] = max_bias.value;
+        obj["Max bias input bit"] = max_bias.input_bit;
+        obj["Max bias output bit"] = max_bias.output_bit;
+        obj["Heatmap"] = std::move(heatmap);
+        return obj;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef THESIS_WORK_SAC_MATRIX_H
+#define THESIS_WORK_SAC_MATRIX_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <boost/json.hpp>
+
+#include "bit_width_uint.h"
+
+namespace tests {
+    // Смещение (bias) ячейки матрицы SAC: |2 * P(выходной бит изменился) - 1|
+    struct SacBias {
+        double value = 0;           // Значение смещения (0 - идеальный случай, 1 - бит не зависит от входа)
+        uint8_t input_bit = 0;      // Номер измененного бита числа
+        uint8_t output_bit = 0;     // Номер бита хеш-значения
+    };
+
+    /*
+     *  Матрица строгого лавинного критерия (SAC, как в SMHasher): для каждого из 64 бит числа и каждого бита
+     *  хеш-значения хранит, сколько раз изменение бита числа изменило бит хеша.
+     *  Биты XOR-масок хешей прибавляются к 8-битным счетчикам (если процессор поддерживает AVX2 -
+     *  по 32 счетчика за инструкцию), которые переносятся в 64-битные счетчики раз в max_pending_keys ключей.
+     *  Строка матрицы для хешей до 64 бит занимает 64 счетчика, для 128-битных хешей - 128 счетчиков
+     */
+    class SacMatrix {
+    public:
+        static constexpr uint8_t num_input_bits = 64;   // Число бит хешируемого числа
+        static constexpr uint8_t max_output_bits = 128; // Максимальное число бит хеш-значения
+
+        // Создает нулевую матрицу для хеш-значений из hash_bits бит
+        explicit SacMatrix(uint16_t hash_bits = max_output_bits);
+
+        /*
+         *  Добавляет в матрицу один ключ
+         *  Входные параметры:
+         *      1. original_hash - хеш исходного числа
+         *      2. modified_hashes - хеши чисел с измененным i-ым битом (num_input_bits значений)
+         */
+        void AddKey(uint64_t original_hash, std::span<const uint64_t> modified_hashes);
+
+        // Добавляет в матрицу один ключ 128-битной хеш функции
+        void AddKey(hfl::uint128_t original_hash, std::span<const hfl::uint128_t> modified_hashes);
+
+        // Добавляет к матрице матрицу, вычисленную в другом потоке
+        void Merge(const SacMatrix& other);
+
+        // Возвращает число добавленных ключей
+        [[nodiscard]] uint64_t NumKeys() const;
+
+        // Возвращает число бит хеш-значения
+        [[nodiscard]] uint16_t HashBits() const;
+
+        // Возвращает, сколько раз изменение бита input_bit числа изменило бит output_bit хеша
+        [[nodiscard]] uint64_t FlipCount(uint8_t input_bit, uint8_t output_bit) const;
+
+        // Возвращает вероятность того, что изменение бита input_bit числа изменит бит output_bit хеша
+        [[nodiscard]] double FlipProbability(uint8_t input_bit, uint8_t output_bit) const;
+
+        // Возвращает ячейку матрицы с наибольшим смещением
+        [[nodiscard]] SacBias MaxBias() const;
+
+    private:
+        // Учитывает добавленный ключ и переносит 8-битные счетчики, пока они не переполнились
+        void AddPendingKey();
+
+        // Переносит 8-битные счетчики в 64-битные
+        void Flush();
+
+        // Число ключей, после которого 8-битные счетчики переносятся (счетчик не переполняется)
+        static constexpr uint16_t max_pending_keys = 255;
+
+        uint16_t hash_bits_;                    // Число бит хеш-значения
+        uint16_t row_size_;                     // Число счетчиков в строке матрицы (64 или 128)
+        uint16_t num_pending_keys_ = 0;         // Число ключей в 8-битных счетчиках
+        uint64_t num_keys_ = 0;                 // Число добавленных ключей
+        std::vector<uint8_t> pending_counts_;   // 8-битные счетчики (строка - бит числа, столбец - бит хеша)
+        std::vector<uint64_t> flip_counts_;     // 64-битные счетчики
+    };
+
+    /*
+     *  Сохраняет матрицу SAC в json: наибольшее смещение и тепловую карту вероятностей
+     *  (строка - бит числа, столбец - бит хеша)
+     */
+    boost::json::object SacMatrixToJson(const SacMatrix& sac_matrix);
+}
+
+#endif //THESIS_WORK_SAC_MATRIX_H
@@ -0,0 +1,165 @@
+#include "scaling_tests.h"
+
+#include <algorithm>
+
+#include <pcg_random.hpp>
+
+#include "generators.h"
+#include "hashes.h"
+#include "test_parameters.h"
+
+namespace tests {
+    namespace out {
+        // Формирует json-файл, в который будет сохранена информация с теста
+        // масштабирования скорости хеширования по числу потоков
+        OutputJson GetScalingTestJson(uint16_t hash_bits, uint32_t block_length, uint64_t bytes_per_thread,
+                                      out::Logger& logger) {
+            const std::filesystem::path report_test_dir = "Scaling tests";
+            const auto report_test_path = logger.GetLogDirPath() / report_test_dir;
+            std::filesystem::create_directories(report_test_path);
+
+            const std::filesystem::path report_name = std::to_string(hash_bits) + " bits.json";
+            const std::filesystem::path out_path = report_test_path / report_name;
+            std::ofstream out(out_path);
+            BOOST_ASSERT_MSG(out, "Failed to create file");
+
+            boost::json::object obj;
+            obj["Test name"] = "Scaling Tests";
+            obj["Bits"] = hash_bits;
+            obj["Block length"] = block_length;
+            obj["Bytes per thread"] = bytes_per_thread;
+            return OutputJson{std::move(obj), std::move(out)};
+        }
+
+        // Переводит результаты теста масштабирования одной хеш функции в json
+        boost::json::object HashScalingToJson(const HashScaling& hash_scaling) {
+            boost::json::array gb_per_second, parallel_efficiency;
+            for (size_t i = 0; i < hash_scaling.gb_per_second.size(); ++i) {
+                gb_per_second.emplace_back(hash_scaling.gb_per_second[i]);
+                parallel_efficiency.emplace_back(hash_scaling.parallel_efficiency[i]);
+            }
+
+            boost::json::object obj;
+            obj["GB per second"] = std::move(gb_per_second);
+            obj["Parallel efficiency"] = std::move(parallel_efficiency);
+            return obj;
+        }
+    }
+
+    // Запускает потоки и генерирует их буферы
+    HashingThreads::HashingThreads(uint16_t num_threads, uint64_t num_blocks, uint32_t block_length)
+            : barrier_(num_threads + 1)
+            , checksums_(num_threads) {
+        BOOST_ASSERT_MSG(num_threads != 0, "num_threads must be greater than 0");
+        threads_.reserve(num_threads);
+        for (uint16_t i = 0; i < num_threads; ++i) {
+            threads_.emplace_back(&HashingThreads::Work, this, i, num_blocks, block_length);
+        }
+    }
+
+    // Останавливает потоки
+    HashingThreads::~HashingThreads() {
+        stop_ = true;
+        barrier_.arrive_and_wait();
+    }
+
+    // Выполняет задание во всех потоках одновременно и ждет его завершения
+    uint64_t HashingThreads::Run(const Task& task) {
+        task_ = &task;
+        barrier_.arrive_and_wait();     // Начало задания
+        barrier_.arrive_and_wait();     // Конец задания
+        uint64_t checksum = 0;
+        for (uint64_t thread_checksum : checksums_) {
+            checksum += thread_checksum;
+        }
+        return checksum;
+    }
+
+    // Функция, которая выполняется в отдельном потоке. Барьер упорядочивает запись task_ и stop_
+    // управляющим потоком и их чтение рабочими потоками
+    void HashingThreads::Work(uint16_t thread_index, uint64_t num_blocks, uint32_t block_length) {
+        pcg64 rng(thread_index);
+        const KeyArena blocks = GenerateRandomDataBlocks(rng, num_blocks, block_length);
+
+        while (true) {
+            barrier_.arrive_and_wait();
+            if (stop_) {
+                break;
+            }
+            checksums_[thread_index] = (*task_)(blocks);
+            barrier_.arrive_and_wait();
+        }
+    }
+
+    // Параметры теста масштабирования
+    namespace scaling {
+        constexpr uint64_t bytes_per_thread = 1ull << 24;   // Объем данных одного потока (16 МБ, больше кэша L2)
+        constexpr bench::BenchmarkParameters benchmark_parameters{1, 7};
+    }
+
+    // Тестирование масштабирования скорости хеширования классов-оберток из реестра одной битности.
+    // Для каждого числа потоков создается одна группа потоков, на которой по очереди запускаются все хеш функции
+    template<hfl::UnsignedIntegral UintT>
+    static void RunScalingTestImpl(uint16_t bits, uint32_t block_length, out::Logger& logger) {
+        out::StartAndEndLogBitsTest printer(logger, bits);
+        auto out_json = out::GetScalingTestJson(bits, block_length, scaling::bytes_per_thread, logger);
+
+        const uint64_t num_blocks = std::max<uint64_t>(scaling::bytes_per_thread / block_length, 1);
+        const uint64_t bytes_per_thread = num_blocks * block_length;
+        const uint16_t max_threads = GetNumThreads();
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
+        std::vector<HashScaling> results;
+
+        boost::json::array thread_counts;
+        for (uint16_t num_threads = 1; num_threads <= max_threads; ++num_threads) {
+            out::LogDuration log_duration("\t\tlog duration", logger);
+            logger << boost::format("\n\t%1% threads:\n") % num_threads;
+            thread_counts.emplace_back(num_threads);
+
+            HashingThreads threads(num_threads, num_blocks, block_length);
+            size_t hash_index = 0;
+            hfl::ForEachHash(hashes, [&](const auto& hash) {
+                const HashingThreads::Task task = [&hash](const KeyArena& blocks) {
+                    uint64_t sum_hashes = 0;
+                    for (const auto& block : blocks) {
+                        sum_hashes += static_cast<uint64_t>(hash(block));
+                    }
+                    return sum_hashes;
+                };
+                const bench::TrialsResult result = bench::RunTrials([&threads, &task]() {
+                    return threads.Run(task);
+                }, scaling::benchmark_parameters);
+
+                const double total_bytes = static_cast<double>(bytes_per_thread) * num_threads;
+                const double gb_per_second = total_bytes / bench::MedianSeconds(result) / 1e9;
+
+                if (results.size() <= hash_index) {
+                    results.push_back(HashScaling{std::string{hash.GetName()}});
+                }
+                HashScaling& hash_scaling = results[hash_index++];
+                hash_scaling.gb_per_second.push_back(gb_per_second);
+                const double single_thread = hash_scaling.gb_per_second.front();
+                hash_scaling.parallel_efficiency.push_back(gb_per_second / (single_thread * num_threads));
+
+                logger << boost::format("\t\t%1%: %2% GB/s, efficiency: %3%\n")
+                          % hash_scaling.name % gb_per_second % hash_scaling.parallel_efficiency.back();
+            });
+        }
+
+        out_json.obj["Thread counts"] = std::move(thread_counts);
+        boost::json::object hashes_obj;
+        for (const HashScaling& hash_scaling : results) {
+            hashes_obj[hash_scaling.name] = out::HashScalingToJson(hash_scaling);
+        }
+        out_json.obj["Hashes"] = std::move(hashes_obj);
+        out_json.out << out_json.obj;
+    }
+
+    // Запускает тестирование масштабирования скорости хеширования 32- и 64-битных хеш функций
+    void RunScalingTests(uint32_t block_length, out::Logger& logger) {
+        out::StartAndEndLogTest start_and_end_log(logger, "SCALING");
+
+        RunScalingTestImpl<uint32_t>(bits32, block_length, logger);
+        RunScalingTestImpl<uint64_t>(bits64, block_length, logger);
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef THESIS_WORK_SCALING_TESTS_H
+#define THESIS_WORK_SCALING_TESTS_H
+
+#include <barrier>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "benchmark.h"
+#include "concurrency.h"
+#include "key_arena.h"
+#include "output.h"
+
+namespace tests {
+    namespace out {
+        /*
+         *  Формирует json-файл, в который будет сохранена информация с теста
+         *  масштабирования скорости хеширования по числу потоков
+         *  Входные параметры:
+         *      1. hash_bits - число битов хеш-значения
+         *      2. block_length - размер блока данных
+         *      3. bytes_per_thread - объем данных, который хеширует один поток за один запуск
+         *      4. logger - записывает лог в файл и выводит его на консоль
+         */
+        OutputJson GetScalingTestJson(uint16_t hash_bits, uint32_t block_length, uint64_t bytes_per_thread,
+                                      out::Logger& logger);
+    }
+
+    /*
+     *  Группа потоков, каждый из которых хеширует собственный буфер блоков данных.
+     *  Буфер генерируется в том же потоке, который его хеширует, поэтому при политике
+     *  first touch память размещается на узле NUMA этого потока.
+     *  Потоки создаются один раз и ждут задания на барьере
+     */
+    class HashingThreads {
+    public:
+        // Задание: хеширует блоки данных и возвращает сумму хеш-значений
+        using Task = std::function<uint64_t(const KeyArena&)>;
+
+        /*
+         *  Запускает потоки и генерирует их буферы
+         *  Входные параметры:
+         *      1. num_threads - число потоков
+         *      2. num_blocks - число блоков данных в буфере одного потока
+         *      3. block_length - размер блока данных
+         */
+        HashingThreads(uint16_t num_threads, uint64_t num_blocks, uint32_t block_length);
+
+        HashingThreads(const HashingThreads&) = delete;
+        HashingThreads& operator=(const HashingThreads&) = delete;
+
+        // Останавливает потоки
+        ~HashingThreads();
+
+        // Выполняет задание во всех потоках одновременно и ждет его завершения.
+        // Возвращает сумму хеш-значений всех потоков
+        uint64_t Run(const Task& task);
+
+    private:
+        // Функция, которая выполняется в отдельном потоке
+        void Work(uint16_t thread_index, uint64_t num_blocks, uint32_t block_length);
+
+        std::barrier<> barrier_;            // Барьер начала и конца задания (потоки + управляющий поток)
+        const Task* task_ = nullptr;        // Текущее задание
+        bool stop_ = false;                 // Флаг остановки потоков
+        std::vector<uint64_t> checksums_;   // Суммы хеш-значений каждого потока
+        std::vector<std::jthread> threads_; // Потоки выполнения
+    };
+
+    // Результаты теста масштабирования одной хеш функции (по одному значению на каждое число потоков)
+    struct HashScaling {
+        std::string name{};
+        std::vector<double> gb_per_second{};        // Суммарная скорость хеширования (ГБ/с)
+        std::vector<double> parallel_efficiency{};  // Скорость, деленная на (число потоков * скорость одного потока)
+    };
+
+    namespace out {
+        // Переводит результаты теста масштабирования одной хеш функции в json
+        boost::json::object HashScalingToJson(const HashScaling& hash_scaling);
+    }
+
+    /*
+     *  Запускает тестирование масштабирования скорости хеширования 32- и 64-битных хеш функций
+     *  на 1..GetNumThreads() потоках
+     *  Входные параметры:
+     *      1. block_length - размер блока данных
+     *      2. logger - записывает лог в файл и выводит его на консоль
+     */
+    void RunScalingTests(uint32_t block_length, out::Logger& logger);
+}
+
+#endif //THESIS_WORK_SCALING_TESTS_H
@@ -1,7 +1,11 @@
 #include "speed_tests.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <random>
 
+#include <cityhash/city.h>
 #include <cityhash/inline/city.h>
 #include <farmhash/inline/farmhash.h>
 #include <fasthash/inline/fasthash.h>
@@ -10,6 +14,7 @@
 #include <metro_hash/metrohash64.h>
 #include <mum-mir/mir-hash.h>
 #include <mum-mir/mum.h>
+#include <murmur_hash/MurmurHash3.h>
 #include <murmur_hash/inline/MurmurHash.h>
 #include <nmhash/nmhash.h>
 #include <mx3/mx3.h>
@@ -25,9 +30,48 @@
 
 #include "generators.h"
 #include "hashes.h"
+#include "isa.h"
 
 namespace tests {
 
+    // Конвертор режима замера в строку
+    std::string SpeedModeToString(SpeedMode mode) {
+        switch (mode) {
+            case SpeedMode::THROUGHPUT:
+                return "Throughput";
+            case SpeedMode::LATENCY:
+                return "Latency";
+            default: {
+                BOOST_ASSERT_MSG(false, "Unknown mode");
+                return std::string{};
+            }
+        }
+    }
+
+    // Вычисляет время хеширования и число тактов на хеш и на байт по результатам запусков
+    SpeedMeasurement GetSpeedMeasurement(const bench::TrialsResult& result, uint64_t num_words, uint64_t num_bytes) {
+        SpeedMeasurement measurement;
+        measurement.sec_time = bench::MedianSeconds(result);
+        measurement.cycles_per_hash = bench::TicksPerUnit(result, static_cast<double>(num_words));
+        measurement.cycles_per_byte = bench::TicksPerUnit(result, static_cast<double>(num_bytes));
+        return measurement;
+    }
+
+    // Формирует длины ключей для теста зависимости скорости хеширования от длины ключа
+    std::vector<uint32_t> GetSweepKeyLengths(uint32_t max_dense_length, uint32_t max_length) {
+        BOOST_ASSERT_MSG(max_dense_length <= max_length, "Dense lengths exceed the maximum length");
+        std::vector<uint32_t> lengths;
+        for (uint32_t length = 1; length <= max_dense_length; ++length) {
+            lengths.push_back(length);
+        }
+        // Первая степень двойки, которая больше max_dense_length
+        uint64_t length = std::bit_ceil(uint64_t{max_dense_length} + 1);
+        for (; length <= max_length; length *= 2) {
+            lengths.push_back(static_cast<uint32_t>(length));
+        }
+        return lengths;
+    }
+
     namespace out {
         // Формирует json-файл, в который будет сохранена информация с теста
         // скорости хеширования хеш функций
@@ -45,8 +89,57 @@ namespace tests {
             obj["Test name"] = "Speed Tests";
             obj["Bits"] = hash_bits;
             obj["Number of words"] = num_words;
+            obj["Modes"] = boost::json::array{SpeedModeToString(SpeedMode::THROUGHPUT),
+                                              SpeedModeToString(SpeedMode::LATENCY)};
             return OutputJson{std::move(obj), std::move(out)};
         }
+
+        // Формирует json-файл, в который будет сохранена информация с теста
+        // скорости многоканальных ядер
+        OutputJson GetMultiLaneSpeedTestJson(size_t num_words, out::Logger& logger) {
+            const std::filesystem::path report_test_dir = "Speed tests";
+            const auto report_test_path = logger.GetLogDirPath() / report_test_dir;
+            std::filesystem::create_directories(report_test_path);
+
+            const std::filesystem::path out_path = report_test_path / "Multi-lane.json";
+            std::ofstream out(out_path);
+            BOOST_ASSERT_MSG(out, "Failed to create file");
+
+            boost::json::object obj;
+            obj["Test name"] = "Multi-lane Speed Tests";
+            obj["Bits"] = bits32;
+            obj["Number of words"] = num_words;
+            obj["Modes"] = boost::json::array{SpeedModeToString(SpeedMode::THROUGHPUT)};
+            return OutputJson{std::move(obj), std::move(out)};
+        }
+
+        // Переводит результаты замера в одном режиме в json
+        boost::json::object SpeedMeasurementToJson(const SpeedMeasurement& measurement) {
+            boost::json::object obj;
+            obj["Seconds"] = measurement.sec_time;
+            obj["Cycles per hash"] = bench::RobustValueToJson(measurement.cycles_per_hash);
+            obj["Cycles per byte"] = bench::RobustValueToJson(measurement.cycles_per_byte);
+            return obj;
+        }
+
+        // Переводит результаты теста скорости одной хеш функции в json.
+        // "Seconds" - время в режиме THROUGHPUT (используется в "Speed")
+        boost::json::object HashSpeedToJson(const HashSpeed& hash_speed) {
+            boost::json::object obj;
+            obj["Seconds"] = hash_speed.throughput.sec_time;
+            obj[SpeedModeToString(SpeedMode::THROUGHPUT)] = SpeedMeasurementToJson(hash_speed.throughput);
+            obj[SpeedModeToString(SpeedMode::LATENCY)] = SpeedMeasurementToJson(hash_speed.latency);
+            return obj;
+        }
+
+        // Выделяет из результатов тестов скорости время хеширования (название хеш функции - секунды)
+        boost::json::object SecondsFromSpeedJson(const boost::json::object& speeds) {
+            boost::json::object obj;
+            for (const auto& [hash_name, hash_speed] : speeds) {
+                obj[hash_name] = hash_speed.as_object().at("Seconds");
+            }
+            return obj;
+        }
     }
 
     // Структуры, которые служат для перегрузки
@@ -78,16 +171,16 @@ namespace tests {
         // - return_type hash(const string& message);
         // - return_type hash(string_view message);
         template <typename Function>
-        void HashTest(Function func, StrView, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, StrView, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             HashSpeed hs = HashSpeedTest(func, hash_name, words, logger);
-            obj[hash_name] = hs.sec_time;
+            obj[hash_name] = out::HashSpeedToJson(hs);
         }
 
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const char* message, int length);
         template <typename Function>
-        void HashTest(Function func, CharKeyIntLen, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, CharKeyIntLen, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 const auto len = static_cast<int>(str.size());
@@ -99,7 +192,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const uint8_t* message, int length);
         template <typename Function>
-        void HashTest(Function func, CharKeyUintLen, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, CharKeyUintLen, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 return func(str.data(), str.size());
@@ -110,7 +203,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const uint8_t* message, size_t length);
         template <typename Function>
-        void HashTest(Function func, UcharKeyUintLen, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, UcharKeyUintLen, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 const auto* key = reinterpret_cast<const uint8_t*>(str.data());
@@ -122,7 +215,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const char* message, int length, return_type seed);
         template <typename Function>
-        void HashTest(Function func, CharKeyIntLenSeed, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, CharKeyIntLenSeed, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 const auto len = static_cast<int>(str.size());
@@ -134,7 +227,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const char* message, size_t length, return_type seed);
         template <typename Function>
-        void HashTest(Function func, CharKeyUintLenSeed, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, CharKeyUintLenSeed, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 return func(str.data(), str.size(), SEED_64_1);
@@ -145,7 +238,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const char* message, size_t length, return_type seed1, return_type seed2);
         template <typename Function>
-        void HashTest(Function func, CharKeyUintLenSeeds, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, CharKeyUintLenSeeds, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 return func(str.data(), str.size(), SEED_64_1, SEED_64_2);
@@ -156,7 +249,7 @@ namespace tests {
         // Тестирование хеш-функций с прототипом вида:
         // - return_type hash(const uint8_t* message, size_t length, return_type seed);
         template <typename Function>
-        void HashTest(Function func, UcharKeyUintLenSeed, const std::string& hash_name, const std::vector<std::string>& words,
+        void HashTest(Function func, UcharKeyUintLenSeed, const std::string& hash_name, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             auto lambda = [func] (std::string_view str) {
                 const auto* key = reinterpret_cast<const uint8_t*>(str.data());
@@ -167,16 +260,15 @@ namespace tests {
 
         // Тестирование хеш-функций PearsonHash
         template <typename PearsonClass>
-        void PearsonClassTest(PearsonClass pearson_hash, const std::vector<std::string>& words,
+        void PearsonClassTest(PearsonClass pearson_hash, const KeyArena& words,
                       out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "PearsonHash";
-            pearson_hash.Init();
-            HashTest(pearson_hash, args::str_view, hash_name, words, logger, obj);
+            HashTest(pearson_hash, args::char_key_uint_len, hash_name, words, logger, obj);
         }
 
         // Тестирование хеш-функций PearsonHash
         template <typename PearsonFunc>
-        void PearsonFuncTest(PearsonFunc pearson_hash, const std::vector<std::string>& words,
+        void PearsonFuncTest(PearsonFunc pearson_hash, const KeyArena& words,
                              out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "PearsonHash";
             pearson_inline::pearson_hash_init();
@@ -185,7 +277,7 @@ namespace tests {
 
         // Тестирование хеш-функций FNV1a
         template <typename BaseFunc>
-        void FNV1aHashTest(BaseFunc func, uint16_t bits, const std::vector<std::string>& words, out::Logger& logger,
+        void FNV1aHashTest(BaseFunc func, uint16_t bits, const KeyArena& words, out::Logger& logger,
                                 boost::json::object& obj) {
             std::string hash_name = "FNV-1a Hash";
 
@@ -201,7 +293,7 @@ namespace tests {
 
         // Тестирование хеш-функций BuzHash
         template<hfl::UnsignedIntegral UintT>
-        void BuzHashTest(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void BuzHashTest(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "BuzHash";
             constexpr int myn = 4096;
             constexpr int bits_in_byte = 8;
@@ -215,7 +307,7 @@ namespace tests {
 
         // Тестирование хеш-функций SpookyHash
         template<hfl::UnsignedIntegral UintT>
-        void SpookyHashTest(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void SpookyHashTest(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "SpookyHash";
 
             auto lambda = [](std::string_view str) {
@@ -228,7 +320,7 @@ namespace tests {
 
         // Тестирование хеш-функций FastHash, меньше 32-бит
         template<hfl::UnsignedIntegral UintT>
-        void FastHash1To31Test(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void FastHash1To31Test(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "Fast-Hash";
 
             auto lambda = [](std::string_view str) {
@@ -241,7 +333,7 @@ namespace tests {
 
         // Тестирование хеш-функций FastHash, от 32-бит до 61-бит включительно
         template<hfl::UnsignedIntegral UintT>
-        void FastHash32To63Test(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void FastHash32To63Test(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "FastHash";
 
             auto lambda = [](std::string_view str) {
@@ -254,7 +346,7 @@ namespace tests {
         }
 
         // Тестирование 32-битной версии хеш-функций FastHash
-        void FastHash64Test(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void FastHash64Test(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "FastHash";
 
             auto lambda = [](std::string_view str) {
@@ -264,7 +356,7 @@ namespace tests {
         }
 
         // Тестирование хеш-функций MetroHash
-        void MetroHashTest(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void MetroHashTest(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "MetroHash64";
 
             auto lambda = [](std::string_view str) {
@@ -278,7 +370,7 @@ namespace tests {
         }
 
         // Тестирование хеш-функций wyhash
-        void WyHash64Test(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void WyHash64Test(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "wyhash64";
 
             auto lambda = [](std::string_view str) {
@@ -289,7 +381,7 @@ namespace tests {
 
         // Тестирование хеш-функций SipHash
         template <typename BaseFunc>
-        void SipHashTest(BaseFunc func, const std::string& hash_name, const std::vector<std::string>& words,
+        void SipHashTest(BaseFunc func, const std::string& hash_name, const KeyArena& words,
                          out::Logger& logger, boost::json::object& obj) {
             constexpr size_t num_keys = 16;
             const uint8_t key[num_keys] = {SEED_8_1, SEED_8_2, SEED_8_3, SEED_8_4,
@@ -305,7 +397,7 @@ namespace tests {
 
         // Тестирование хеш-функций SipHash (версия от Google)
         template <typename BaseFunc>
-        void GoogleSipHashTest(BaseFunc func, const std::string& hash_name, const std::vector<std::string>& words,
+        void GoogleSipHashTest(BaseFunc func, const std::string& hash_name, const KeyArena& words,
                          out::Logger& logger, boost::json::object& obj) {
             const highwayhash::HH_U64 key[2] = {SEED_64_1, SEED_64_2};
 
@@ -316,7 +408,7 @@ namespace tests {
         }
 
         // Тестирование хеш-функций HighwayHash
-        void HighwayHashTest(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void HighwayHashTest(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             std::string hash_name = "HighwayHash";
 
             auto lambda = [](std::string_view str) {
@@ -332,9 +424,39 @@ namespace tests {
             HashTest(lambda, args::str_view, hash_name, words, logger, obj);
         }
 
+        // Тестирование 128-битной версии хеш-функции HighwayHash
+        void HighwayHash128Test(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
+            std::string hash_name = "HighwayHash 128 bits";
+
+            auto lambda = [](std::string_view str) {
+                using namespace highwayhash;
+
+                static const HHKey key HH_ALIGNAS(32) = {SEED_64_1, SEED_64_2, SEED_64_3, SEED_64_4};
+                HHStateT<HH_TARGET> state(key);
+                HHResult128 result{};
+                HighwayHashT(&state, str.data(), str.size(), &result);
+
+                return hfl::MakeUint128(result[1], result[0]);
+            };
+            HashTest(lambda, args::str_view, hash_name, words, logger, obj);
+        }
+
+        // Тестирование 128-битных хеш-функций MurmurHash3 с прототипом вида:
+        // - void hash(const void* key, int len, uint32_t seed, void* out);
+        template <typename BaseFunc>
+        void MurmurHash3_128Test(BaseFunc func, const std::string& hash_name, const KeyArena& words,
+                                 out::Logger& logger, boost::json::object& obj) {
+            auto lambda = [func](std::string_view str) {
+                std::array<uint64_t, 2> hash{};
+                func(str.data(), static_cast<int>(str.size()), SEED_32, hash.data());
+                return hfl::MakeUint128(hash[1], hash[0]);
+            };
+            HashTest(lambda, args::str_view, hash_name, words, logger, obj);
+        }
+
         // Тестирование универсальных хеш-функций
         template<hfl::UnsignedIntegral UintT>
-        void SpeedTestT(const std::vector<std::string>& words, out::Logger& logger, boost::json::object& obj) {
+        void SpeedTestT(const KeyArena& words, out::Logger& logger, boost::json::object& obj) {
             using namespace std::literals;
 
             HashTest(DJB2Hash<UintT>, args::char_key_uint_len, "DJB2 Hash"s, words, logger, obj);
@@ -346,7 +468,7 @@ namespace tests {
     }
 
     // Тестирование 16-битных хеш-функций
-    [[maybe_unused]] boost::json::object SpeedTests16(const std::vector<std::string>& words, out::Logger& logger) {
+    [[maybe_unused]] boost::json::object SpeedTests16(const KeyArena& words, out::Logger& logger) {
         boost::json::object obj;
 
         SpeedTestT<uint16_t>(words, logger, obj);
@@ -359,7 +481,7 @@ namespace tests {
     }
 
     // Тестирование 24-битных хеш-функций
-    [[maybe_unused]] boost::json::object SpeedTests24(const std::vector<std::string>& words, out::Logger& logger) {
+    [[maybe_unused]] boost::json::object SpeedTests24(const KeyArena& words, out::Logger& logger) {
         boost::json::object obj;
 
         SpeedTestT<hfl::uint24_t>(words, logger, obj);
@@ -371,7 +493,7 @@ namespace tests {
     }
 
     // Тестирование 32-битных хеш-функций
-    [[maybe_unused]] boost::json::object SpeedTests32(const std::vector<std::string>& words, out::Logger& logger) {
+    [[maybe_unused]] boost::json::object SpeedTests32(const KeyArena& words, out::Logger& logger) {
         boost::json::object obj;
 
         using namespace std::literals;
@@ -401,7 +523,7 @@ namespace tests {
     }
 
     // Тестирование 48-битных хеш-функций
-    [[maybe_unused]] boost::json::object SpeedTests48(const std::vector<std::string>& words, out::Logger& logger) {
+    [[maybe_unused]] boost::json::object SpeedTests48(const KeyArena& words, out::Logger& logger) {
         boost::json::object obj;
 
         SpeedTestT<hfl::uint48_t>(words, logger, obj);
@@ -412,7 +534,7 @@ namespace tests {
     }
 
     // Тестирование 64-битных хеш-функций
-    [[maybe_unused]] boost::json::object SpeedTests64(const std::vector<std::string>& words, out::Logger& logger) {
+    [[maybe_unused]] boost::json::object SpeedTests64(const KeyArena& words, out::Logger& logger) {
         using namespace std::literals;
         boost::json::object obj;
 
@@ -450,8 +572,37 @@ namespace tests {
         return obj;
     }
 
+    // Тестирование 128-битных хеш-функций
+    [[maybe_unused]] boost::json::object SpeedTests128(const KeyArena& words, out::Logger& logger) {
+        using namespace std::literals;
+        boost::json::object obj;
+
+        HashTest([](std::string_view str) {
+            uint64_t hash1 = SEED_64_1, hash2 = SEED_64_2;
+            spooky_inline::spooky_hash128(str.data(), str.size(), &hash1, &hash2);
+            return hfl::MakeUint128(hash2, hash1);
+        }, args::str_view, "SpookyHash"s, words, logger, obj);
+        MurmurHash3_128Test(MurmurHash3_x86_128, "MurmurHash3 x86 128 bits"s, words, logger, obj);
+        MurmurHash3_128Test(MurmurHash3_x64_128, "MurmurHash3 x64 128 bits"s, words, logger, obj);
+        HashTest([](std::string_view str) {
+            const city::uint128 hash = city::CityHash128(str.data(), str.size());
+            return hfl::MakeUint128(city::Uint128High64(hash), city::Uint128Low64(hash));
+        }, args::str_view, "CityHash128"s, words, logger, obj);
+        HashTest([](std::string_view str) {
+            const city::uint128 hash = city::CityHash128WithSeed(str.data(), str.size(), {SEED_64_1, SEED_64_2});
+            return hfl::MakeUint128(city::Uint128High64(hash), city::Uint128Low64(hash));
+        }, args::str_view, "CityHash128 with seed"s, words, logger, obj);
+        HashTest([](std::string_view str) {
+            const XXH128_hash_t hash = XXH3_128bits(str.data(), str.size());
+            return hfl::MakeUint128(hash.high64, hash.low64);
+        }, args::str_view, "XXH3 128 bits"s, words, logger, obj);
+        HighwayHash128Test(words, logger, obj);
+
+        return obj;
+    }
+
     template<hfl::UnsignedIntegral UintT>
-    static inline boost::json::object SpeedTestsVisitor(const std::vector<std::string>& words, out::Logger& logger) {
+    static inline boost::json::object SpeedTestsVisitor(const KeyArena& words, out::Logger& logger) {
         if constexpr (std::is_same_v<UintT, uint16_t>)
             return SpeedTests16(words, logger);
         else if constexpr (std::is_same_v<UintT, hfl::uint24_t>)
@@ -462,16 +613,299 @@ namespace tests {
             return SpeedTests48(words, logger);
         else if constexpr (std::is_same_v<UintT, uint64_t>)
             return SpeedTests64(words, logger);
+        else if constexpr (std::is_same_v<UintT, hfl::uint128_t>)
+            return SpeedTests128(words, logger);
         else
             static_assert(hfl::always_false_v<UintT>, "non-exhaustive visitor!");
     }
 
+    // Тестирование скорости хеширования классов-оберток из реестра хеш функций.
+    // Хеш функции вызываются через hfl::StaticHash, то есть без виртуальных вызовов
     template<hfl::UnsignedIntegral UintT>
-    void RunSpeedTestImpl(uint16_t bits, const std::vector<std::string>& words, out::Logger& logger) {
+    static boost::json::object WrappersSpeedTests(const KeyArena& words, out::Logger& logger) {
+        boost::json::object obj;
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
+        hfl::ForEachHash(hashes, [&words, &logger, &obj](const auto& hash) {
+            auto lambda = [&hash](std::string_view str) {
+                return hash(str);
+            };
+            HashSpeed hs = HashSpeedTest(lambda, hash.GetName(), words, logger);
+            obj[hs.name] = out::HashSpeedToJson(hs);
+        });
+        return obj;
+    }
+
+    // Тестирование скорости ядер обертки Wrapper для всех наборов инструкций, которые поддерживает процессор.
+    // Результаты сохраняются под именами "<hash_name> (<набор инструкций>)"
+    template<typename Wrapper>
+    static void IsaVariantsSpeedTest(std::string_view hash_name, const KeyArena& words, out::Logger& logger,
+                                     boost::json::object& obj) {
+        for (const hfl::Isa isa : Wrapper::isas) {
+            if (!Wrapper::IsKernelSupported(isa)) {
+                continue;
+            }
+            const Wrapper wrapper(isa);
+            auto lambda = [&wrapper](std::string_view str) {
+                return wrapper.HashDirect(str.data(), str.size());
+            };
+            const std::string name = (boost::format("%1% (%2%)") % hash_name % hfl::IsaToString(isa)).str();
+            HashSpeed hs = HashSpeedTest(lambda, name, words, logger);
+            obj[hs.name] = out::HashSpeedToJson(hs);
+        }
+    }
+
+    // Тестирование скорости 64-битных хеш функций, у которых есть ядра для разных наборов инструкций.
+    // Позволяет из одной сборки сравнить ядра и выбрать ядро для процессоров каждого поколения
+    static boost::json::object IsaVariantsSpeedTests(const KeyArena& words, out::Logger& logger) {
+        boost::json::object obj;
+        IsaVariantsSpeedTest<hfl::wrappers::HighwayHashWrapper>("HighwayHash", words, logger, obj);
+        IsaVariantsSpeedTest<hfl::wrappers::XXH3_64BitsWrapper>("XXH3 64 bits", words, logger, obj);
+        IsaVariantsSpeedTest<hfl::wrappers::T1HA0Wrapper>("T1HA0 hash", words, logger, obj);
+        return obj;
+    }
+
+    // Параметры теста многоканальных ядер
+    namespace multi_lane_speed {
+        constexpr uint64_t num_words = 1ull << 20;      // Число ключей
+        constexpr uint32_t equal_key_length = 16;       // Длина ключей одной длины
+        constexpr uint32_t max_key_length = 32;         // Длины ключей случайной длины - от 1 до max_key_length
+    }
+
+    // Тестирование скорости пакетного хеширования (HashBatch по hash_batch_size ключей) обертки Wrapper
+    // со всеми многоканальными ядрами, которые поддерживает процессор. С Isa::PORTABLE ключи хешируются
+    // по одному. Результаты сохраняются под именами "<hash_name> (xN)", где N - число ключей,
+    // которые ядро хеширует одновременно
+    template<typename Wrapper>
+    static void MultiLaneSpeedTest(std::string_view hash_name, const KeyArena& words, out::Logger& logger,
+                                   boost::json::object& obj) {
+        const std::vector<std::string_view> keys = words.GetViews();
+        std::vector<uint64_t> hashes(keys.size());
+        for (const hfl::Isa isa : Wrapper::isas) {
+            if (!Wrapper::IsKernelSupported(isa)) {
+                continue;
+            }
+            const Wrapper wrapper(isa);
+            auto trial = [&wrapper, &keys, &hashes]() {
+                uint64_t sum_hashes = 0;
+                for (size_t first = 0; first < keys.size(); first += hash_batch_size) {
+                    const size_t batch_size = std::min(hash_batch_size, keys.size() - first);
+                    const std::span<uint64_t> hashes_batch(hashes.data() + first, batch_size);
+                    wrapper.HashBatch(std::span(keys.data() + first, batch_size), hashes_batch);
+                    for (const uint64_t hash : hashes_batch) {
+                        sum_hashes += hash;
+                    }
+                }
+                return sum_hashes;
+            };
+            const bench::TrialsResult result = bench::RunTrials(trial);
+            const SpeedMeasurement measurement = GetSpeedMeasurement(result, words.Size(), words.NumBytes());
+
+            const std::string name = (boost::format("%1% (x%2%)") % hash_name % Wrapper::NumLanes(isa)).str();
+            logger << boost::format("\t\t%1% (%2%): cycles/hash: %3% (MAD %4%), sum hashes: %5%\n")
+                      % name % hfl::IsaToString(isa) % measurement.cycles_per_hash.median
+                      % measurement.cycles_per_hash.mad % result.checksum;
+            obj[name] = out::SpeedMeasurementToJson(measurement);
+        }
+    }
+
+    // Тестирование скорости многоканальных ядер всех 32-битных оберток, у которых они есть
+    static boost::json::object MultiLaneSpeedTests(const KeyArena& words, out::Logger& logger) {
+        using namespace hfl::wrappers;
+        boost::json::object obj;
+        MultiLaneSpeedTest<DJB2HashWrapper<uint32_t>>("DJB2 Hash", words, logger, obj);
+        MultiLaneSpeedTest<SDBMHashWrapper<uint32_t>>("SDBM Hash", words, logger, obj);
+        MultiLaneSpeedTest<OneTimeHashWrapper<uint32_t>>("One at a time hash", words, logger, obj);
+        MultiLaneSpeedTest<FNV1aHash32Wrapper>("FNV-1a Hash", words, logger, obj);
+        MultiLaneSpeedTest<MurmurHash3Wrapper>("MurmurHash3", words, logger, obj);
+        MultiLaneSpeedTest<xxHash32Wrapper>("xxHash32", words, logger, obj);
+        return obj;
+    }
+
+    // Параметры теста зависимости скорости хеширования от длины ключа
+    namespace sweep {
+        constexpr uint32_t max_dense_key_length = 128;          // До этой длины перебираются все длины подряд
+        constexpr uint32_t max_key_length = 1u << 20;           // Наибольшая длина ключа (1 МБ)
+        constexpr uint64_t bytes_per_trial = 1ull << 22;        // Объем данных, хешируемых за один запуск (4 МБ)
+        constexpr uint64_t min_words = 16;                      // Наименьшее число ключей одной длины
+        constexpr bench::BenchmarkParameters benchmark_parameters{1, 7};
+    }
+
+    // Результаты замеров одной хеш функции на ключах разной длины (в порядке возрастания длины)
+    struct KeyLengthCurve {
+        std::string name;
+        std::vector<bench::RobustValue> cycles_per_hash;
+        std::vector<bench::RobustValue> cycles_per_byte;
+    };
+
+    namespace out {
+        // Переводит кривую скорости хеширования одной хеш функции в json.
+        // Медианы и MAD хранятся в отдельных массивах, чтобы их можно было сразу строить на графике
+        boost::json::object KeyLengthCurveToJson(const KeyLengthCurve& curve) {
+            boost::json::array cycles_per_hash, cycles_per_hash_mad, cycles_per_byte, cycles_per_byte_mad,
+                    bytes_per_cycle;
+            for (size_t i = 0; i < curve.cycles_per_hash.size(); ++i) {
+                cycles_per_hash.emplace_back(curve.cycles_per_hash[i].median);
+                cycles_per_hash_mad.emplace_back(curve.cycles_per_hash[i].mad);
+                cycles_per_byte.emplace_back(curve.cycles_per_byte[i].median);
+                cycles_per_byte_mad.emplace_back(curve.cycles_per_byte[i].mad);
+                bytes_per_cycle.emplace_back(1.0 / curve.cycles_per_byte[i].median);
+            }
+
+            boost::json::object obj;
+            obj["Cycles per hash"] = std::move(cycles_per_hash);
+            obj["Cycles per hash MAD"] = std::move(cycles_per_hash_mad);
+            obj["Cycles per byte"] = std::move(cycles_per_byte);
+            obj["Cycles per byte MAD"] = std::move(cycles_per_byte_mad);
+            obj["Bytes per cycle"] = std::move(bytes_per_cycle);
+            return obj;
+        }
+    }
+
+    // Тестирование зависимости скорости хеширования (режим THROUGHPUT) классов-оберток из реестра
+    // от длины ключа. Для каждой длины генерируется один набор ключей, который хешируют все хеш функции
+    template<hfl::UnsignedIntegral UintT>
+    static boost::json::object KeyLengthSweepTests(out::Logger& logger) {
+        out::LogDuration log_duration("\tlog duration key length sweep", logger);
+        const std::vector<uint32_t> lengths = GetSweepKeyLengths(sweep::max_dense_key_length, sweep::max_key_length);
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
+        std::vector<KeyLengthCurve> curves;
+
+        pcg64 rng;
+        for (const uint32_t length : lengths) {
+            const uint64_t num_words = std::max(sweep::bytes_per_trial / length, sweep::min_words);
+            const auto words = GenerateRandomDataBlocks(rng, num_words, length);
+            logger << boost::format("\n\tkey length %1% (%2% words):\n") % length % num_words;
+
+            size_t hash_index = 0;
+            hfl::ForEachHash(hashes, [&](const auto& hash) {
+                auto trial = [&hash, &words]() {
+                    uint64_t sum_hashes = 0;
+                    for (const auto& word : words) {
+                        sum_hashes += hfl::FoldToUint64(hash(word));
+                    }
+                    return sum_hashes;
+                };
+                const bench::TrialsResult result = bench::RunTrials(trial, sweep::benchmark_parameters);
+                const SpeedMeasurement measurement = GetSpeedMeasurement(result, num_words, num_words * length);
+
+                if (curves.size() <= hash_index) {
+                    curves.push_back(KeyLengthCurve{std::string{hash.GetName()}});
+                }
+                KeyLengthCurve& curve = curves[hash_index++];
+                curve.cycles_per_hash.push_back(measurement.cycles_per_hash);
+                curve.cycles_per_byte.push_back(measurement.cycles_per_byte);
+
+                logger << boost::format("\t\t%1%: cycles/hash: %2%, bytes/cycle: %3%\n")
+                          % curve.name % measurement.cycles_per_hash.median
+                          % (1.0 / measurement.cycles_per_byte.median);
+            });
+        }
+
+        boost::json::object obj;
+        boost::json::array lengths_array;
+        for (const uint32_t length : lengths) {
+            lengths_array.emplace_back(length);
+        }
+        obj["Key lengths"] = std::move(lengths_array);
+        boost::json::object hashes_obj;
+        for (const KeyLengthCurve& curve : curves) {
+            hashes_obj[curve.name] = out::KeyLengthCurveToJson(curve);
+        }
+        obj["Hashes"] = std::move(hashes_obj);
+        return obj;
+    }
+
+    // Параметры теста потокового хеширования
+    namespace streaming {
+        constexpr uint32_t message_length = 1u << 22;                           // Длина сообщения (4 МБ)
+        constexpr std::array<uint32_t, 6> chunk_sizes{16, 64, 256, 1024, 4096, 65536};  // Размеры частей
+        constexpr bench::BenchmarkParameters benchmark_parameters{1, 7};
+    }
+
+    // Тестирование скорости потокового хеширования (Init/Update/Final) классов-оберток из реестра.
+    // Сообщение подается частями разного размера, результат сравнивается с хешированием сообщения целиком:
+    // разность тактов, деленная на число частей, - накладные расходы на одну часть
+    template<hfl::UnsignedIntegral UintT>
+    static boost::json::object StreamingSpeedTests(out::Logger& logger) {
+        out::LogDuration log_duration("\tlog duration streaming", logger);
+        pcg64 rng;
+        const std::string message = GenerateRandomDataBlock(rng, streaming::message_length);
+        const auto hashes = hfl::BuildStaticHashes<UintT>();
+
+        boost::json::object hashes_obj;
+        hfl::ForEachHash(hashes, [&message, &logger, &hashes_obj](const auto& hash) {
+            logger << boost::format("\n\t%1%:\n") % hash.GetName();
+            const auto state = hash.CreateStreamingState();
+
+            const bench::TrialsResult one_shot_result = bench::RunTrials([&hash, &message]() {
+                return hfl::FoldToUint64(hash(std::string_view(message)));
+            }, streaming::benchmark_parameters);
+            const double one_shot_cycles = bench::TicksPerUnit(one_shot_result, 1).median;
+            logger << boost::format("\t\tone-shot: %1% cycles/byte\n") % (one_shot_cycles / message.size());
+
+            boost::json::array cycles_per_byte, chunk_overhead;
+            for (const uint32_t chunk_size : streaming::chunk_sizes) {
+                const bench::TrialsResult result = bench::RunTrials([&state, &message, chunk_size]() {
+                    state->Init();
+                    for (size_t pos = 0; pos < message.size(); pos += chunk_size) {
+                        state->Update(message.data() + pos, std::min<size_t>(chunk_size, message.size() - pos));
+                    }
+                    return hfl::FoldToUint64(state->Final());
+                }, streaming::benchmark_parameters);
+                const double cycles = bench::TicksPerUnit(result, 1).median;
+                const double num_chunks = static_cast<double>((message.size() + chunk_size - 1) / chunk_size);
+                cycles_per_byte.emplace_back(cycles / message.size());
+                chunk_overhead.emplace_back((cycles - one_shot_cycles) / num_chunks);
+                logger << boost::format("\t\tchunk %1%: %2% cycles/byte, %3% cycles/chunk overhead\n")
+                          % chunk_size % (cycles / message.size()) % ((cycles - one_shot_cycles) / num_chunks);
+            }
+
+            boost::json::object obj;
+            obj["Buffered"] = state->IsBuffered();
+            obj["One-shot cycles per byte"] = one_shot_cycles / message.size();
+            obj["Cycles per byte"] = std::move(cycles_per_byte);
+            obj["Cycles per chunk overhead"] = std::move(chunk_overhead);
+            hashes_obj[hash.GetName()] = std::move(obj);
+        });
+
+        boost::json::object obj;
+        obj["Message length"] = streaming::message_length;
+        boost::json::array chunk_sizes;
+        for (const uint32_t chunk_size : streaming::chunk_sizes) {
+            chunk_sizes.emplace_back(chunk_size);
+        }
+        obj["Chunk sizes"] = std::move(chunk_sizes);
+        obj["Hashes"] = std::move(hashes_obj);
+        return obj;
+    }
+
+    template<hfl::UnsignedIntegral UintT>
+    void RunSpeedTestImpl(uint16_t bits, const KeyArena& words, out::Logger& logger) {
         out::StartAndEndLogBitsTest printer(logger, bits);
-        auto out_json = out::GetSpeedTestJson(bits, words.size(), logger);
+        auto out_json = out::GetSpeedTestJson(bits, words.Size(), logger);
+        // В "Speed" и "Wrappers speed" сохраняется только время хеширования (в секундах),
+        // в "Cycles" и "Wrappers cycles" - полные результаты (время, такты на хеш и на байт)
         boost::json::object obj = SpeedTestsVisitor<UintT>(words, logger);
-        out_json.obj["Speed"] = std::move(obj);
+        out_json.obj["Speed"] = out::SecondsFromSpeedJson(obj);
+        out_json.obj["Cycles"] = std::move(obj);
+        boost::json::object wrappers_obj = WrappersSpeedTests<UintT>(words, logger);
+        out_json.obj["Wrappers speed"] = out::SecondsFromSpeedJson(wrappers_obj);
+        out_json.obj["Wrappers cycles"] = std::move(wrappers_obj);
+        // Ядра для разных наборов инструкций (есть только у 64-битных хеш функций)
+        if constexpr (std::is_same_v<UintT, uint64_t>) {
+            boost::json::array supported_isas;
+            for (const hfl::Isa isa : hfl::GetSupportedIsas()) {
+                supported_isas.emplace_back(hfl::IsaToString(isa));
+            }
+            out_json.obj["Supported ISAs"] = std::move(supported_isas);
+            boost::json::object isa_obj = IsaVariantsSpeedTests(words, logger);
+            out_json.obj["ISA variants speed"] = out::SecondsFromSpeedJson(isa_obj);
+            out_json.obj["ISA variants cycles"] = std::move(isa_obj);
+        }
+        // Зависимость скорости хеширования от длины ключа (от 1 байта до 1 МБ)
+        out_json.obj["Key length sweep"] = KeyLengthSweepTests<UintT>(logger);
+        // Скорость потокового хеширования (Init/Update/Final) в зависимости от размера части сообщения
+        out_json.obj["Streaming"] = StreamingSpeedTests<UintT>(logger);
         out_json.out << out_json.obj;
     }
 
@@ -487,6 +921,39 @@ namespace tests {
         //RunSpeedTestImpl<uint32_t>(bits32, random_blocks, logger);
         //RunSpeedTestImpl<hfl::uint48_t>(bits48, random_blocks, logger);
         RunSpeedTestImpl<uint64_t>(bits64, random_blocks, logger);
+        RunSpeedTestImpl<hfl::uint128_t>(bits128, random_blocks, logger);
+    }
+
+    void RunMultiLaneSpeedTests(out::Logger& logger) {
+        out::StartAndEndLogTest start_and_end_log(logger, "MULTI-LANE SPEED");
+        auto out_json = out::GetMultiLaneSpeedTestJson(multi_lane_speed::num_words, logger);
+
+        boost::json::array supported_isas;
+        for (const hfl::Isa isa : hfl::GetSupportedIsas()) {
+            supported_isas.emplace_back(hfl::IsaToString(isa));
+        }
+        out_json.obj["Supported ISAs"] = std::move(supported_isas);
+
+        // Ключи одной длины: дорожки ядра не маскируются
+        pcg64 rng;
+        const auto equal_words = GenerateRandomDataBlocks(rng, multi_lane_speed::num_words,
+                                                          multi_lane_speed::equal_key_length);
+        logger << boost::format("\n\tkeys of %1% bytes:\n") % multi_lane_speed::equal_key_length;
+        out_json.obj["Equal key length"] = multi_lane_speed::equal_key_length;
+        out_json.obj["Equal lengths"] = MultiLaneSpeedTests(equal_words, logger);
+
+        // Ключи случайной длины: дорожки коротких ключей группы маскируются
+        std::uniform_int_distribution<uint32_t> length_distribution(1, multi_lane_speed::max_key_length);
+        KeyArena random_words;
+        for (uint64_t i = 0; i < multi_lane_speed::num_words; ++i) {
+            const uint32_t length = length_distribution(rng);
+            GenerateRandomDataBlock(rng, random_words.Append(length), length);
+        }
+        logger << boost::format("\n\tkeys of 1-%1% bytes:\n") % multi_lane_speed::max_key_length;
+        out_json.obj["Max key length"] = multi_lane_speed::max_key_length;
+        out_json.obj["Random lengths"] = MultiLaneSpeedTests(random_words, logger);
+
+        out_json.out << out_json.obj;
     }
 }
 
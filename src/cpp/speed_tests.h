@@ -3,7 +3,9 @@
 
 #include "boost/format.hpp"
 
+#include "benchmark.h"
 #include "generators.h"
+#include "key_arena.h"
 #include "timers.h"
 #include "output.h"
 #include "test_parameters.h"
@@ -19,28 +21,81 @@ namespace tests {
          *      3. logger - записывает лог в файл и выводит его на консоль
          */
         OutputJson GetSpeedTestJson(uint16_t hash_bits, size_t num_words, out::Logger& logger);
+
+        /*
+         *  Формирует json-файл, в который будет сохранена информация с теста
+         *  скорости многоканальных ядер
+         *  Входные параметры:
+         *      1. num_words - число хешируемых ключей
+         *      2. logger - записывает лог в файл и выводит его на консоль
+         */
+        OutputJson GetMultiLaneSpeedTestJson(size_t num_words, out::Logger& logger);
     }
 
-    // Структура, которая хранит имя хеш-функции
-    // и время хеширования
+    // Режимы замера скорости хеширования
+    enum class SpeedMode {
+        THROUGHPUT, // Пропускная способность: хеши слов независимы, процессор выполняет их параллельно
+        LATENCY     // Задержка: следующее слово выбирается по предыдущему хеш-значению (цепочка зависимостей)
+    };
+
+    // Конвертор режима замера в строку
+    std::string SpeedModeToString(SpeedMode mode);
+
+    // Структура, которая хранит время хеширования и число тактов на хеш и на байт в одном режиме
+    struct SpeedMeasurement {
+        double sec_time{};                  // медиана времени хеширования всех слов
+        bench::RobustValue cycles_per_hash; // медиана и MAD числа тактов на один хеш
+        bench::RobustValue cycles_per_byte; // медиана и MAD числа тактов на один байт
+    };
+
+    // Структура, которая хранит имя хеш-функции и результаты замеров в обоих режимах
     struct HashSpeed {
         std::string name{};
-        double sec_time{};
+        SpeedMeasurement throughput;    // режим THROUGHPUT
+        SpeedMeasurement latency;       // режим LATENCY
     };
 
+    namespace out {
+        // Переводит результаты теста скорости одной хеш функции в json
+        boost::json::object HashSpeedToJson(const HashSpeed& hash_speed);
+    }
+
+    /*
+     *  Вычисляет время хеширования и число тактов на хеш и на байт по результатам запусков
+     *  Входные параметры:
+     *      1. result - результаты запусков
+     *      2. num_words - число слов, хешируемых за один запуск
+     *      3. num_bytes - число байт, хешируемых за один запуск
+     */
+    SpeedMeasurement GetSpeedMeasurement(const bench::TrialsResult& result, uint64_t num_words, uint64_t num_bytes);
+
+    /*
+     *  Замеряет скорость хеширования в одном режиме
+     *  Параметр шаблона: хеш функция
+     *  Входные параметры:
+     *      1. hash - хеш-функция
+     *      2. words - массив хешируемых слов
+     *      3. mode - режим замера (THROUGHPUT или LATENCY)
+     *      4. logger - записывает лог в файл и выводит его на консоль
+     */
+    template<typename Hash>
+    SpeedMeasurement MeasureHashingSpeed(const Hash& hash, const KeyArena& words, SpeedMode mode,
+                                         out::Logger& logger);
+
     /*
-     *  Подсчитывает время хеширования
+     *  Замеряет скорость хеширования в режимах THROUGHPUT и LATENCY: несколько прогревочных
+     *  и учитываемых запусков, каждый из которых хеширует все слова
      *  Параметр шаблона: хеш функция
      *  Входные параметры:
      *      1. hash - хеш-функция
      *      2. hash_name - название хеш функции
      *      3. words - массив хешируемых слов
      *      4. logger - записывает лог в файл и выводит его на консоль
-     *  Возвращаемое значение: время хеширования
+     *  Возвращаемое значение: время хеширования и число тактов на хеш и на байт
     */
     template<typename Hash>
-    double CalculateHashingTime(Hash hash, std::string_view hash_name, const std::vector<std::string>& words,
-                                out::Logger& logger);
+    HashSpeed CalculateHashingSpeed(Hash hash, std::string_view hash_name, const KeyArena& words,
+                                    out::Logger& logger);
 
     /*
      *  Тестирования скорости хеширования хеш-функций одной битности
@@ -50,10 +105,10 @@ namespace tests {
      *      2. hash_name - название хеш функции
      *      3. words - массив хешируемых слов
      *      4. logger - записывает лог в файл и выводит его на консоль
-     *  Возвращаемое значение: название хеш функции и время хеширования
+     *  Возвращаемое значение: название хеш функции, время хеширования и число тактов на хеш и на байт
      */
     template<typename Hash>
-    HashSpeed HashSpeedTest(Hash hash, std::string_view hash_name, const std::vector<std::string>& words,
+    HashSpeed HashSpeedTest(Hash hash, std::string_view hash_name, const KeyArena& words,
                             out::Logger& logger);
 
     /*
@@ -63,11 +118,12 @@ namespace tests {
      *      2. logger - записывает лог в файл и выводит его на консоль
      *  Возвращаемое значение: json-структура, в которую записываются результаты теста
      */
-    [[maybe_unused]] boost::json::object SpeedTests16(const std::vector<std::string>& words, out::Logger& logger);
-    [[maybe_unused]] boost::json::object SpeedTests24(const std::vector<std::string>& words, out::Logger& logger);
-    [[maybe_unused]] boost::json::object SpeedTests32(const std::vector<std::string>& words, out::Logger& logger);
-    [[maybe_unused]] boost::json::object SpeedTests48(const std::vector<std::string>& words, out::Logger& logger);
-    [[maybe_unused]] boost::json::object SpeedTests64(const std::vector<std::string>& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests16(const KeyArena& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests24(const KeyArena& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests32(const KeyArena& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests48(const KeyArena& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests64(const KeyArena& words, out::Logger& logger);
+    [[maybe_unused]] boost::json::object SpeedTests128(const KeyArena& words, out::Logger& logger);
 
     /*
      *  Запускает тестирование скорости хеширования хеш-функций
@@ -78,54 +134,95 @@ namespace tests {
      */
     void RunSpeedTests(uint64_t num_blocks, uint32_t block_length, out::Logger& logger);
 
-// ====================================================================================
-
-    // Подсчитывает время хеширования
-    template<typename Hash>
-    double CalculateHashingTime(Hash hash, std::string_view hash_name, const std::vector<std::string>& words,
-                                out::Logger& logger) {
-        auto sum_hashes = static_cast<uint64_t>(hash("initial hash"));
-
-        Timer timer1;
-        timer1.Start();
-        for (const auto & word : words) {
-            sum_hashes += static_cast<uint64_t>(hash(word));
-        }
-        timer1.End();
-
-        std::cout << boost::format("\t\tsum hashes: %1%\n") % sum_hashes;
-        uint64_t sum_k = 0;
+    /*
+     *  Запускает тестирование скорости пакетного хеширования коротких ключей 32-битными хеш функциями
+     *  с многоканальными ядрами (DJB2, SDBM, one-at-a-time, FNV-1a, MurmurHash3, xxHash32) для всех наборов
+     *  инструкций, которые поддерживает процессор. Ключи одной длины и ключи случайной длины
+     *  Входные параметры:
+     *      1. logger - записывает лог в файл и выводит его на консоль
+     */
+    void RunMultiLaneSpeedTests(out::Logger& logger);
 
-        Timer timer2;
-        timer2.Start();
-        for (const auto & word : words) {
-            sum_k += (++sum_k);
-        }
-        timer2.End();
+    /*
+     *  Формирует длины ключей для теста зависимости скорости хеширования от длины ключа:
+     *  каждая длина от 1 до max_dense_length байт, затем степени двойки до max_length байт
+     *  Входные параметры:
+     *      1. max_dense_length - наибольшая длина, до которой перебираются все длины подряд
+     *      2. max_length - наибольшая длина ключа
+     */
+    std::vector<uint32_t> GetSweepKeyLengths(uint32_t max_dense_length, uint32_t max_length);
 
+// ====================================================================================
 
-        const double total_time = timer1.GetTotalTime() - timer2.GetTotalTime();
-        std::cout << boost::format("\t\tsum k: %1%\n") % sum_k;
-        logger << boost::format("\t\tsecond timer: %1% sec\n") % total_time;
+    // Замеряет скорость хеширования в одном режиме
+    template<typename Hash>
+    SpeedMeasurement MeasureHashingSpeed(const Hash& hash, const KeyArena& words, SpeedMode mode,
+                                         out::Logger& logger) {
+        // Независимые хеши: сумма хеш-значений не мешает процессору выполнять хеширование слов параллельно
+        auto throughput_trial = [&hash, &words]() {
+            uint64_t sum_hashes = 0;
+            for (const auto& word : words) {
+                sum_hashes += hfl::FoldToUint64(hash(word));
+            }
+            return sum_hashes;
+        };
+
+        // Цепочка зависимых хешей: адрес следующего слова (i или i + 1) зависит от предыдущего хеш-значения,
+        // поэтому хеширование следующего слова не начинается раньше, чем закончится текущее
+        auto latency_trial = [&hash, &words]() {
+            uint64_t hash_value = 0;
+            for (size_t i = 0; i + 1 < words.Size(); ++i) {
+                const std::string_view word = words[i + (hash_value & 1)];
+                hash_value = hfl::FoldToUint64(hash(word));
+            }
+            return hash_value;
+        };
+
+        const bench::TrialsResult result = (mode == SpeedMode::THROUGHPUT)
+                ? bench::RunTrials(throughput_trial)
+                : bench::RunTrials(latency_trial);
+
+        // В режиме LATENCY хешируется words.Size() - 1 слов. Для блоков одной длины
+        // число байт пропорционально числу слов
+        const bool all_words = (mode == SpeedMode::THROUGHPUT || words.Size() == 0);
+        const uint64_t num_words = all_words ? words.Size() : words.Size() - 1;
+        const uint64_t total_bytes = all_words ? words.NumBytes() : words.NumBytes() - words[num_words].size();
+        const SpeedMeasurement measurement = GetSpeedMeasurement(result, num_words, total_bytes);
+
+        std::cout << boost::format("\t\tsum hashes: %1%\n") % result.checksum;
+        logger << boost::format("\t\t%1%: cycles/hash: %2% (MAD %3%), cycles/byte: %4% (MAD %5%)\n")
+                  % SpeedModeToString(mode)
+                  % measurement.cycles_per_hash.median % measurement.cycles_per_hash.mad
+                  % measurement.cycles_per_byte.median % measurement.cycles_per_byte.mad;
+        return measurement;
+    }
 
-        return total_time;
+    // Замеряет скорость хеширования
+    template<typename Hash>
+    HashSpeed CalculateHashingSpeed(Hash hash, std::string_view hash_name, const KeyArena& words,
+                                    out::Logger& logger) {
+        HashSpeed hash_speed{std::string{hash_name}};
+        hash_speed.throughput = MeasureHashingSpeed(hash, words, SpeedMode::THROUGHPUT, logger);
+        hash_speed.latency = MeasureHashingSpeed(hash, words, SpeedMode::LATENCY, logger);
+        return hash_speed;
     }
 
 
     // Тестирования скорости хеширования хеш-функций одной битности
     template<typename Hash>
-    HashSpeed HashSpeedTest(Hash hash, std::string_view hash_name, const std::vector<std::string>& words,
+    HashSpeed HashSpeedTest(Hash hash, std::string_view hash_name, const KeyArena& words,
                             out::Logger& logger) {
         out::LogDuration log_duration("\t\tlog duration all time", logger);
         logger << boost::format("\n\t%1%:\n") % hash_name;
 
-        // Подсчитывает время хеширования
-        const double hashing_time = CalculateHashingTime(hash, hash_name, words, logger);
+        // Замеряет скорость хеширования
+        HashSpeed hash_speed = CalculateHashingSpeed(hash, hash_name, words, logger);
 
         // Выводит лог
-        logger << boost::format("\t\tbest timer: %1% sec\n") % hashing_time;
+        logger << boost::format("\t\tmedian timer: %1% sec (throughput), %2% sec (latency)\n")
+                  % hash_speed.throughput.sec_time % hash_speed.latency.sec_time;
         // Возвращает результаты теста
-        return HashSpeed{std::string{hash_name}, hashing_time};
+        return hash_speed;
     }
 }
 
@@ -0,0 +1,133 @@
+#include "streaming_wrappers.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <highwayhash/highwayhash.h>
+#include <spooky_hash/spooky.h>
+#include <xx_hash/xxhash.h>
+
+#include "bit_width_uint.h"
+
+namespace hfl::wrappers {
+    namespace {
+
+        //---------- HighwayHash -----------
+
+        class HighwayHashStreamingWrapper final : public StreamingHashWrapper<uint64_t> {
+        public:
+            explicit HighwayHashStreamingWrapper(const highwayhash::HHKey& key)
+                    : state_(key) {
+                std::copy(std::begin(key), std::end(key), std::begin(key_));
+            }
+
+            void Init() override {
+                state_.Reset(key_);
+            }
+
+            void Update(const char* message, size_t length) override {
+                state_.Append(message, length);
+            }
+
+            uint64_t Final() override {
+                highwayhash::HHResult64 result = 0;
+                state_.Finalize(&result);
+                return result;
+            }
+
+        private:
+            HH_ALIGNAS(32) highwayhash::HHKey key_{};
+            highwayhash::HighwayHashCatT<HH_TARGET> state_;
+        };
+
+        //--------- Jenkins hash -----------
+
+        template<typename UintT>
+        class SpookyHashStreamingWrapper final : public StreamingHashWrapper<UintT> {
+        public:
+            explicit SpookyHashStreamingWrapper(uint64_t seed)
+                    : seed_(seed) {
+                Init();
+            }
+
+            // spooky_hash32 и spooky_hash64 используют сид seed как обе половины 128-битного сида
+            void Init() override {
+                spooky_init(&state_, seed_, seed_);
+            }
+
+            void Update(const char* message, size_t length) override {
+                spooky_update(&state_, message, length);
+            }
+
+            UintT Final() override {
+                uint64_t hash1 = 0, hash2 = 0;
+                spooky_final(&state_, &hash1, &hash2);
+                if constexpr (std::numeric_limits<UintT>::digits <= 32) {
+                    return static_cast<UintT>(static_cast<uint32_t>(hash1));
+                } else {
+                    return static_cast<UintT>(hash1);
+                }
+            }
+
+        private:
+            uint64_t seed_;
+            spooky_state state_{};
+        };
+
+        //------------ xxHashes ------------
+
+        class XXH3_64BitsStreamingWrapper final : public StreamingHashWrapper<uint64_t> {
+        public:
+            XXH3_64BitsStreamingWrapper(bool with_seed, uint64_t seed)
+                    : with_seed_(with_seed)
+                    , seed_(seed) {
+                XXH3_INITSTATE(&state_);
+                Init();
+            }
+
+            void Init() override {
+                if (with_seed_) {
+                    XXH3_64bits_reset_withSeed(&state_, seed_);
+                } else {
+                    XXH3_64bits_reset(&state_);
+                }
+            }
+
+            void Update(const char* message, size_t length) override {
+                XXH3_64bits_update(&state_, message, length);
+            }
+
+            uint64_t Final() override {
+                return XXH3_64bits_digest(&state_);
+            }
+
+        private:
+            bool with_seed_;
+            uint64_t seed_;
+            XXH3_state_t state_{};
+        };
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateHighwayHashStreamingState(const highwayhash::HHKey& key) {
+        return std::make_unique<HighwayHashStreamingWrapper>(key);
+    }
+
+    template<typename UintT>
+    std::unique_ptr<StreamingHashWrapper<UintT>> CreateSpookyHashStreamingState(uint64_t seed) {
+        return std::make_unique<SpookyHashStreamingWrapper<UintT>>(seed);
+    }
+
+    template std::unique_ptr<StreamingHashWrapper<uint16_t>> CreateSpookyHashStreamingState(uint64_t);
+    template std::unique_ptr<StreamingHashWrapper<BitWidthUint<24>>> CreateSpookyHashStreamingState(uint64_t);
+    template std::unique_ptr<StreamingHashWrapper<uint32_t>> CreateSpookyHashStreamingState(uint64_t);
+    template std::unique_ptr<StreamingHashWrapper<BitWidthUint<48>>> CreateSpookyHashStreamingState(uint64_t);
+    template std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateSpookyHashStreamingState(uint64_t);
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateXXH3_64BitsStreamingState() {
+        return std::make_unique<XXH3_64BitsStreamingWrapper>(false, 0);
+    }
+
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateXXH3_64BitsStreamingState(uint64_t seed) {
+        return std::make_unique<XXH3_64BitsStreamingWrapper>(true, seed);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef THESIS_WORK_STREAMING_WRAPPERS_H
+#define THESIS_WORK_STREAMING_WRAPPERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include <highwayhash/hh_types.h>
+
+// HFL = Hash function library
+namespace hfl::wrappers {
+    /*
+     *  Шаблонный абстрактный интерфейс потокового хеширования: сообщение подается частями (Update),
+     *  а хеш-значение вычисляется в конце (Final). Хеш-значение совпадает с хеш-значением,
+     *  которое вычисляет обертка над хеш функцией для всего сообщения целиком.
+     *  Состояние создается методом CreateStreamingState оберток над хеш функциями.
+     *  Потоковый интерфейс t1ha2 (t1ha2_init/update/final) вычисляет другую функцию, чем t1ha2_atonce
+     *  (длина сообщения не участвует в инициализации), поэтому для t1ha2 используется буферизованное состояние
+     */
+    template<typename UintT>
+    class StreamingHashWrapper {
+    public:
+        using UintType = UintT;
+
+        virtual ~StreamingHashWrapper() = default;
+
+        // Начинает хеширование нового сообщения
+        virtual void Init() = 0;
+
+        // Добавляет к сообщению очередную часть
+        virtual void Update(const char* message, size_t length) = 0;
+
+        // Добавляет к сообщению очередную часть
+        void Update(std::string_view message) {
+            Update(message.data(), message.size());
+        }
+
+        // Завершает хеширование и возвращает хеш-значение. Следующее сообщение начинается с Init
+        virtual UintT Final() = 0;
+
+        // Возвращает true, если состояние накапливает сообщение в буфере (хеш функция
+        // не поддерживает потоковое хеширование), и false, если сообщение хешируется по мере поступления
+        [[nodiscard]] virtual bool IsBuffered() const {
+            return false;
+        }
+    };
+
+    /*
+     *  Функции, которые создают состояния для хеш функций с собственным потоковым интерфейсом.
+     *  Классы состояний определены в streaming_wrappers.cpp, чтобы заголовочные файлы библиотек
+     *  (типы состояний, макросы) не попадали в остальные единицы трансляции
+     */
+
+    // HighwayHash (highwayhash::HighwayHashCatT)
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateHighwayHashStreamingState(const highwayhash::HHKey& key);
+
+    // SpookyHash (spooky_init/update/final). Хеш-значения до 32 бит вычисляются как у spooky_hash32,
+    // хеш-значения 48 и 64 бит - как у spooky_hash64
+    template<typename UintT>
+    std::unique_ptr<StreamingHashWrapper<UintT>> CreateSpookyHashStreamingState(uint64_t seed);
+
+    // XXH3_64bits (XXH3_64bits_reset/update/digest)
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateXXH3_64BitsStreamingState();
+
+    // XXH3_64bits_withSeed (XXH3_64bits_reset_withSeed/update/digest)
+    std::unique_ptr<StreamingHashWrapper<uint64_t>> CreateXXH3_64BitsStreamingState(uint64_t seed);
+}
+
+#endif //THESIS_WORK_STREAMING_WRAPPERS_H
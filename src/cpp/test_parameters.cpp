@@ -1,5 +1,11 @@
 #include "test_parameters.h"
 
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 #include <boost/assert.hpp>
 
 namespace tests {
@@ -20,6 +26,43 @@ namespace tests {
         }
     }
 
+    // Конвертор способа подсчета в строку
+    std::string CountingStrategyToString(CountingStrategy strategy) {
+        switch (strategy) {
+            case CountingStrategy::ATOMIC:
+                return "Atomic";
+            case CountingStrategy::PARTITIONED:
+                return "Partitioned";
+            default: {
+                BOOST_ASSERT_MSG(false, "Unknown strategy");
+                return std::string{};
+            }
+        }
+    }
+
+    // Возвращает объем памяти, который можно занять счетчиками хеш функций одного совмещенного прохода
+    uint64_t GetFusedMemoryBudget() {
+#ifdef __linux__
+        const long num_pages = sysconf(_SC_PHYS_PAGES);
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if (num_pages > 0 && page_size > 0) {
+            return static_cast<uint64_t>(num_pages) * static_cast<uint64_t>(page_size) / 2;
+        }
+#endif
+        return 1ull << 32;
+    }
+
+    // Делит набор хеш функций на группы для совмещенных проходов
+    std::vector<HashGroup> SplitIntoHashGroups(size_t num_hashes, uint64_t bytes_per_hash) {
+        const uint64_t budget = GetFusedMemoryBudget();
+        const size_t group_size = std::max<uint64_t>(1, (bytes_per_hash != 0) ? budget / bytes_per_hash : num_hashes);
+        std::vector<HashGroup> groups;
+        for (size_t first = 0; first < num_hashes; first += group_size) {
+            groups.push_back(HashGroup{first, std::min(num_hashes, first + group_size)});
+        }
+        return groups;
+    }
+
     // Функция свертки 64-битного хеша в хеш меньшей длины
     uint64_t XorFoldMask(uint64_t src, uint16_t mask_bits) {
         const uint64_t mask = (1ull << mask_bits) - 1;
@@ -47,9 +90,10 @@ namespace tests {
 
     // Конструктор DistTestParameters
     DistTestParameters::DistTestParameters(uint16_t hash_bits, uint16_t num_threads, uint64_t num_keys,
-                                           uint64_t num_buckets, TestFlag mode)
+                                           uint64_t num_buckets, TestFlag mode, CountingStrategy strategy)
         : AdvancedTestParameters(hash_bits, num_threads, num_keys, mode)
-        , num_buckets(num_buckets) {
+        , num_buckets(num_buckets)
+        , strategy(strategy) {
         SetParameters();
     }
 
@@ -93,6 +137,9 @@ namespace tests {
             case bits64:
                 divisor = 1ull << divider_for_64;
                 break;
+            case bits128:
+                divisor = 1ull << divider_for_128;
+                break;
             default:
                 BOOST_ASSERT_MSG(false, "Incorrect hash_bits");
                 break;
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cstdint>
 #include <thread>
+#include <vector>
 
 #include "hash_wrappers.h"
 #include "timers.h"
@@ -15,17 +16,63 @@ namespace tests {
     static inline constexpr uint16_t bits32 = 32;
     static inline constexpr uint16_t bits48 = 48;
     static inline constexpr uint16_t bits64 = 64;
+    static inline constexpr uint16_t bits128 = 128;
+
+    // Число ключей, которые хешируются за один вызов HashBatch
+    static inline constexpr size_t hash_batch_size = 4096;
 
     // Флаги тестирования
     enum class TestFlag {
         NORMAL, // Честный подсчет 16 и 24-битных хешей
-        BINS,   // Подсчет по бинам 32 и 64-битных хешей
-        MASK    // Подсчет с 24-битной маской 32 и 64-битных хешей
+        BINS,   // Подсчет по бинам 32, 64 и 128-битных хешей (128-битные хеши сворачиваются в 64 бита)
+        MASK    // Подсчет с 24-битной маской 32, 64 и 128-битных хешей (128-битные хеши сворачиваются в 64 бита)
     };
 
     // Конвертор флага в строку
     std::string TestFlagToString(TestFlag mode);
 
+    // Способы подсчета хеш-значений в тесте распределения
+    enum class CountingStrategy {
+        ATOMIC,     // Общий массив атомарных счетчиков (CAS на каждое хеш-значение)
+        PARTITIONED // Разбиение хеш-значений по диапазонам счетчиков в буферах потоков (без атомарных операций)
+    };
+
+    // Конвертор способа подсчета в строку
+    std::string CountingStrategyToString(CountingStrategy strategy);
+
+    /*
+     *  Группа хеш функций [first, last) из набора, которые тестируются за один совмещенный проход:
+     *  каждая порция ключей генерируется один раз и хешируется всеми хеш функциями группы
+     */
+    struct HashGroup {
+        size_t first;   // Номер первой хеш функции группы
+        size_t last;    // Номер хеш функции, следующей за последней
+
+        // Проверяет, входит ли хеш функция с номером index в группу
+        [[nodiscard]] bool Contains(size_t index) const {
+            return first <= index && index < last;
+        }
+
+        // Возвращает число хеш функций в группе
+        [[nodiscard]] size_t Size() const {
+            return last - first;
+        }
+    };
+
+    // Возвращает объем памяти, который можно занять счетчиками хеш функций одного совмещенного прохода
+    // (в Linux - половина физической памяти, иначе - 4 ГБ)
+    uint64_t GetFusedMemoryBudget();
+
+    /*
+     *  Делит набор хеш функций на группы для совмещенных проходов так, чтобы счетчики хеш функций
+     *  одной группы помещались в GetFusedMemoryBudget(). В группе не меньше одной хеш функции
+     *  Входные параметры:
+     *      1. num_hashes - число хеш функций в наборе
+     *      2. bytes_per_hash - объем памяти под счетчики одной хеш функции
+     *  Выходное значение: группы в порядке номеров хеш функций
+     */
+    std::vector<HashGroup> SplitIntoHashGroups(size_t num_hashes, uint64_t bytes_per_hash);
+
     // Функция свертки 64-битного хеша в хеш меньшей длины
     uint64_t XorFoldMask(uint64_t src, uint16_t mask_bits);
 
@@ -69,14 +116,17 @@ namespace tests {
     struct DistTestParameters : AdvancedTestParameters {
         uint64_t num_buckets;       // Количество счетчиков
         uint64_t divisor = 1;       // Делитель. Нужен, когда в одном счетчике много хешей
+        const CountingStrategy strategy{}; // Способ подсчета хеш-значений
 
         DistTestParameters(uint16_t hash_bits, uint16_t num_threads, uint64_t num_keys, uint64_t num_buckets,
-                           TestFlag mode);
+                           TestFlag mode, CountingStrategy strategy = CountingStrategy::PARTITIONED);
 
     private:
         static constexpr uint16_t divider_for_32 = 0;
         static constexpr uint16_t divider_for_48 = divider_for_32 + 16;
         static constexpr uint16_t divider_for_64 = divider_for_32 + 32;
+        // Хеш функции возвращают 128-битные хеш-значения свернутыми в 64 бита (hfl::FoldToUint64)
+        static constexpr uint16_t divider_for_128 = divider_for_64;
         static constexpr uint64_t num_max_bins = 1ull << 32;
 
     private:
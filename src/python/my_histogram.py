@@ -125,3 +125,28 @@ def histogram(bars, labels, file_path, auto_label, is_log_scale=False):
     plt.grid(ls=':')
 
     fig.savefig(file_path, bbox_inches='tight')
+
+
+def curves(x, lines, labels, file_path, is_log_x_scale=True):
+    """
+    Строит несколько кривых на одном графике
+    :param x: значения по оси абсцисс (общие для всех кривых)
+    :param lines: словарь, в котором ключ - подпись кривой, значение - значения по оси ординат
+    :param labels: надписи на графиках
+    :param file_path: путь к файлу, куда будет сохранен график
+    :param is_log_x_scale: флаг для логарифмического масштаба по оси абсцисс
+    :return: None
+    """
+    fig, ax = get_subplots(labels)
+
+    for name, y in lines.items():
+        ax.plot(x, y, label=name, linewidth=1)
+
+    if is_log_x_scale:
+        ax.set_xscale('log', base=2)
+    plt.ylim(bottom=0)
+    plt.grid(ls=':')
+    ax.legend(fontsize=9, ncol=2, loc='upper left')
+
+    fig.savefig(file_path, bbox_inches='tight')
+    plt.close(fig)
@@ -20,6 +20,7 @@ class SpeedStatistics:
         self.speeds = tests_data["Speed"]
         self.tests_dir_path = get_python_report_path(tests_dir_name)
         self.test_name = tests_data["Test name"]
+        self.key_length_sweep = tests_data.get("Key length sweep")
         self.hist_path = os.path.join(self.tests_dir_path, self.test_name)
         make_dir(self.tests_dir_path)
         make_dir(self.hist_path)
@@ -47,6 +48,20 @@ class SpeedStatistics:
         file_path = os.path.join(self.hist_path, f'{self.bits} bits.png')
         my_histogram.histogram(self.speeds, labels, file_path, self.__auto_label)
 
+    def create_key_length_plot(self):
+        """
+        Построение графика зависимости скорости хеширования (байт за такт) от длины ключа.
+        :return: None
+        """
+        if self.key_length_sweep is None:
+            return
+        title = f'Скорость хеширования от длины ключа ({self.bits}-битные хеш функции)'
+        labels = my_histogram.Labels(title, 'Длина ключа (в байтах)', 'Байт за такт')
+        file_path = os.path.join(self.hist_path, f'{self.bits} bits key length sweep.png')
+        lengths = self.key_length_sweep["Key lengths"]
+        lines = {name: curve["Bytes per cycle"] for name, curve in self.key_length_sweep["Hashes"].items()}
+        my_histogram.curves(lengths, lines, labels, file_path)
+
     def get_speeds(self):
         return self.speeds
 
@@ -65,6 +80,7 @@ def create_histogram(tests_dir_name: str, dir_path: str, file_name: str | bytes,
         js = json.load(file)
         ews = SpeedStatistics(js, tests_dir_name)
         ews.create_histogram()
+        ews.create_key_length_plot()
         if ews.bits == 32 or ews.bits == 64:
             speeds[ews.bits] = ews.get_speeds()
 